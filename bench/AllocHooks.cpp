@@ -0,0 +1,79 @@
+// 基准测试中代替插件的 MemoryOperators.cpp：全局 operator new/delete 经过 AllocStats 计数后交给 malloc/free，
+// 使 --alloc 统计到的分配与插件中一致（插件中交给 LeviLamina 的分配器）
+
+#include "mod/AllocStats.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+void* allocate(size_t size) {
+    bdsmysql::AllocStats::onAllocate(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* alignedAllocate(size_t size, std::align_val_t alignment) {
+    bdsmysql::AllocStats::onAllocate(size);
+    auto align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    // aligned_alloc 要求长度是对齐的整数倍
+    return std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+}
+
+void release(void* p) noexcept {
+    if (p) {
+        bdsmysql::AllocStats::onRelease();
+    }
+    std::free(p);
+}
+
+void alignedRelease(void* p) noexcept {
+    if (p) {
+        bdsmysql::AllocStats::onRelease();
+    }
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* checked(void* p) {
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+} // namespace
+
+void* operator new(size_t size) { return checked(allocate(size)); }
+void* operator new[](size_t size) { return checked(allocate(size)); }
+void* operator new(size_t size, std::nothrow_t const&) noexcept { return allocate(size); }
+void* operator new[](size_t size, std::nothrow_t const&) noexcept { return allocate(size); }
+
+void* operator new(size_t size, std::align_val_t al) { return checked(alignedAllocate(size, al)); }
+void* operator new[](size_t size, std::align_val_t al) { return checked(alignedAllocate(size, al)); }
+void* operator new(size_t size, std::align_val_t al, std::nothrow_t const&) noexcept {
+    return alignedAllocate(size, al);
+}
+void* operator new[](size_t size, std::align_val_t al, std::nothrow_t const&) noexcept {
+    return alignedAllocate(size, al);
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, std::nothrow_t const&) noexcept { release(p); }
+void operator delete[](void* p, std::nothrow_t const&) noexcept { release(p); }
+void operator delete(void* p, size_t) noexcept { release(p); }
+void operator delete[](void* p, size_t) noexcept { release(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { alignedRelease(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedRelease(p); }
+void operator delete(void* p, std::align_val_t, std::nothrow_t const&) noexcept { alignedRelease(p); }
+void operator delete[](void* p, std::align_val_t, std::nothrow_t const&) noexcept { alignedRelease(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { alignedRelease(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { alignedRelease(p); }
@@ -0,0 +1,1040 @@
+// 物品数据编解码微基准：比较候选格式在本项目物品负载上的编码/解码吞吐量、每槽位字节数和内存分配次数。
+//
+// 用法: bdsmysql-codecbench [--corpus 文件] [--players N] [--fill 0-1] [--seconds 秒]
+//
+// 候选格式（编码单位都是一个玩家的全部槽位）：
+//   snbt  - 每个槽位一行，NBT 为 SNBT 文本（当前的存储方式）
+//   nbt   - 每个槽位一行，NBT 为二进制（Bedrock 小端格式）
+//   blob  - 整个玩家一行，槽位头 + 二进制 NBT 连续存放
+//   zlib  - blob 整体用 zlib 压缩
+//
+// 输出的 MB/s 按编码后的字节数计算；解码的分配次数包含构建 NBT 树本身的分配（各格式相同的部分）。
+// 语料默认由内置生成器产生（附魔装备、命名物品、潜影盒、成书等）；--corpus 可读取从数据库导出的真实数据，
+// 每行为 "物品类型<TAB>SNBT"，即 mysql -N -B -e "SELECT item_type, nbt FROM player_backpack" 的输出
+
+#include <zlib.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> gAllocations{0};
+
+} // namespace
+
+// 统计分配次数（只替换普通形式，数组形式默认转发到这里）
+void* operator new(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// ===== NBT 树 =====
+
+enum class TagType : uint8_t {
+    End       = 0,
+    Byte      = 1,
+    Short     = 2,
+    Int       = 3,
+    Long      = 4,
+    Float     = 5,
+    Double    = 6,
+    ByteArray = 7,
+    String    = 8,
+    List      = 9,
+    Compound  = 10,
+    IntArray  = 11,
+    LongArray = 12,
+};
+
+// 编解码两端共用的树。数组和列表的元素放在 items 中；复合标签的键放在 names 中，与 items 一一对应
+struct Tag {
+    TagType                  type     = TagType::End;
+    TagType                  listType = TagType::End;  // List 的元素类型
+    int64_t                  integer  = 0;
+    double                   real     = 0;
+    std::string              text;
+    std::vector<std::string> names;
+    std::vector<Tag>         items;
+
+    bool operator==(const Tag& other) const = default;
+};
+
+// 一个槽位：表中的 slot/item_type/count/damage 列加上 NBT
+struct Slot {
+    uint8_t     slot   = 0;
+    uint8_t     count  = 0;
+    int16_t     damage = 0;
+    std::string itemType;
+    bool        hasNbt = false;
+    Tag         nbt;
+
+    bool operator==(const Slot& other) const = default;
+};
+
+using Player = std::vector<Slot>;
+
+// ===== SNBT =====
+
+bool isBareChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-'
+        || c == '.' || c == '+';
+}
+
+class SnbtParser {
+public:
+    explicit SnbtParser(std::string_view text) : mText(text) {}
+
+    bool parse(Tag& out) {
+        if (!value(out)) {
+            return false;
+        }
+        skipSpace();
+        return mPos == mText.size();
+    }
+
+private:
+    void skipSpace() {
+        while (mPos < mText.size() && (mText[mPos] == ' ' || mText[mPos] == '\n' || mText[mPos] == '\r' || mText[mPos] == '\t')) {
+            mPos++;
+        }
+    }
+
+    bool consume(char c) {
+        skipSpace();
+        if (mPos < mText.size() && mText[mPos] == c) {
+            mPos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool value(Tag& out) {
+        skipSpace();
+        if (mPos >= mText.size()) {
+            return false;
+        }
+        char c = mText[mPos];
+        if (c == '{') {
+            return compound(out);
+        }
+        if (c == '[') {
+            return list(out);
+        }
+        if (c == '"' || c == '\'') {
+            out.type = TagType::String;
+            return quoted(out.text);
+        }
+        return scalar(out);
+    }
+
+    bool compound(Tag& out) {
+        out.type = TagType::Compound;
+        mPos++;
+        if (consume('}')) {
+            return true;
+        }
+        do {
+            std::string name;
+            skipSpace();
+            if (mPos < mText.size() && (mText[mPos] == '"' || mText[mPos] == '\'')) {
+                if (!quoted(name)) {
+                    return false;
+                }
+            } else {
+                name = std::string(bare());
+                if (name.empty()) {
+                    return false;
+                }
+            }
+            if (!consume(':')) {
+                return false;
+            }
+            out.names.push_back(std::move(name));
+            if (!value(out.items.emplace_back())) {
+                return false;
+            }
+        } while (consume(','));
+        return consume('}');
+    }
+
+    bool list(Tag& out) {
+        mPos++;
+        // 数组：[B;...] [I;...] [L;...]
+        if (mPos + 1 < mText.size() && mText[mPos + 1] == ';') {
+            switch (mText[mPos]) {
+            case 'B':
+                out.type = TagType::ByteArray;
+                break;
+            case 'I':
+                out.type = TagType::IntArray;
+                break;
+            case 'L':
+                out.type = TagType::LongArray;
+                break;
+            default:
+                return false;
+            }
+            mPos += 2;
+        } else {
+            out.type = TagType::List;
+        }
+
+        if (consume(']')) {
+            return true;
+        }
+        do {
+            Tag& item = out.items.emplace_back();
+            if (!value(item)) {
+                return false;
+            }
+            if (out.type == TagType::List) {
+                if (out.listType != TagType::End && out.listType != item.type) {
+                    return false;
+                }
+                out.listType = item.type;
+            }
+        } while (consume(','));
+        return consume(']');
+    }
+
+    bool quoted(std::string& out) {
+        char quote = mText[mPos++];
+        while (mPos < mText.size()) {
+            char c = mText[mPos++];
+            if (c == quote) {
+                return true;
+            }
+            if (c == '\\' && mPos < mText.size()) {
+                c = mText[mPos++];
+            }
+            out.push_back(c);
+        }
+        return false;
+    }
+
+    std::string_view bare() {
+        size_t start = mPos;
+        while (mPos < mText.size() && isBareChar(mText[mPos])) {
+            mPos++;
+        }
+        return mText.substr(start, mPos - start);
+    }
+
+    bool scalar(Tag& out) {
+        std::string_view token = bare();
+        if (token.empty()) {
+            return false;
+        }
+        if (token == "true" || token == "false") {
+            out.type    = TagType::Byte;
+            out.integer = token == "true";
+            return true;
+        }
+
+        char             suffix = token.back();
+        std::string_view digits = token;
+        TagType          type   = TagType::End;
+        switch (suffix) {
+        case 'b':
+        case 'B':
+            type = TagType::Byte;
+            break;
+        case 's':
+        case 'S':
+            type = TagType::Short;
+            break;
+        case 'l':
+        case 'L':
+            type = TagType::Long;
+            break;
+        case 'f':
+        case 'F':
+            type = TagType::Float;
+            break;
+        case 'd':
+        case 'D':
+            type = TagType::Double;
+            break;
+        default:
+            break;
+        }
+        if (type != TagType::End) {
+            digits.remove_suffix(1);
+        } else {
+            type = digits.find_first_of(".eE") != std::string_view::npos ? TagType::Double : TagType::Int;
+        }
+
+        const char* end = digits.data() + digits.size();
+        bool        ok  = false;
+        if (type == TagType::Float || type == TagType::Double) {
+            ok = !digits.empty() && std::from_chars(digits.data(), end, out.real).ptr == end;
+        } else {
+            ok = !digits.empty() && std::from_chars(digits.data(), end, out.integer).ptr == end;
+        }
+        if (ok) {
+            out.type = type;
+            return true;
+        }
+
+        // 不是数字：无引号字符串
+        out.type = TagType::String;
+        out.text = std::string(token);
+        return true;
+    }
+
+    std::string_view mText;
+    size_t           mPos = 0;
+};
+
+void writeQuoted(std::string& out, std::string_view text) {
+    out.push_back('"');
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+        }
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
+
+void writeReal(std::string& out, double value, bool single) {
+    char buffer[32];
+    auto result = single ? std::to_chars(buffer, buffer + sizeof(buffer), static_cast<float>(value))
+                         : std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+    out.push_back(single ? 'f' : 'd');
+}
+
+void writeSnbt(std::string& out, const Tag& tag) {
+    switch (tag.type) {
+    case TagType::End:
+        break;
+    case TagType::Byte:
+        std::format_to(std::back_inserter(out), "{}b", tag.integer);
+        break;
+    case TagType::Short:
+        std::format_to(std::back_inserter(out), "{}s", tag.integer);
+        break;
+    case TagType::Int:
+        std::format_to(std::back_inserter(out), "{}", tag.integer);
+        break;
+    case TagType::Long:
+        std::format_to(std::back_inserter(out), "{}L", tag.integer);
+        break;
+    case TagType::Float:
+        writeReal(out, tag.real, true);
+        break;
+    case TagType::Double:
+        writeReal(out, tag.real, false);
+        break;
+    case TagType::String:
+        writeQuoted(out, tag.text);
+        break;
+    case TagType::ByteArray:
+    case TagType::IntArray:
+    case TagType::LongArray:
+    case TagType::List:
+        out.push_back('[');
+        if (tag.type == TagType::ByteArray) {
+            out += "B;";
+        } else if (tag.type == TagType::IntArray) {
+            out += "I;";
+        } else if (tag.type == TagType::LongArray) {
+            out += "L;";
+        }
+        for (size_t i = 0; i < tag.items.size(); i++) {
+            if (i > 0) {
+                out.push_back(',');
+            }
+            writeSnbt(out, tag.items[i]);
+        }
+        out.push_back(']');
+        break;
+    case TagType::Compound:
+        out.push_back('{');
+        for (size_t i = 0; i < tag.items.size(); i++) {
+            if (i > 0) {
+                out.push_back(',');
+            }
+            const auto& name = tag.names[i];
+            if (!name.empty() && std::all_of(name.begin(), name.end(), isBareChar)) {
+                out += name;
+            } else {
+                writeQuoted(out, name);
+            }
+            out.push_back(':');
+            writeSnbt(out, tag.items[i]);
+        }
+        out.push_back('}');
+        break;
+    }
+}
+
+// ===== 二进制 NBT（Bedrock 小端格式：根标签为无名复合标签） =====
+
+// 按本机字节序直接复制，只支持小端平台（x86、ARM）
+static_assert(std::endian::native == std::endian::little);
+
+template <class T>
+void put(std::string& out, T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
+
+void putString(std::string& out, std::string_view text) {
+    put<uint16_t>(out, static_cast<uint16_t>(text.size()));
+    out.append(text);
+}
+
+void writePayload(std::string& out, const Tag& tag) {
+    switch (tag.type) {
+    case TagType::End:
+        break;
+    case TagType::Byte:
+        put<int8_t>(out, static_cast<int8_t>(tag.integer));
+        break;
+    case TagType::Short:
+        put<int16_t>(out, static_cast<int16_t>(tag.integer));
+        break;
+    case TagType::Int:
+        put<int32_t>(out, static_cast<int32_t>(tag.integer));
+        break;
+    case TagType::Long:
+        put<int64_t>(out, tag.integer);
+        break;
+    case TagType::Float:
+        put<uint32_t>(out, std::bit_cast<uint32_t>(static_cast<float>(tag.real)));
+        break;
+    case TagType::Double:
+        put<uint64_t>(out, std::bit_cast<uint64_t>(tag.real));
+        break;
+    case TagType::String:
+        putString(out, tag.text);
+        break;
+    case TagType::ByteArray:
+    case TagType::IntArray:
+    case TagType::LongArray:
+        put<int32_t>(out, static_cast<int32_t>(tag.items.size()));
+        for (const auto& item : tag.items) {
+            writePayload(out, item);
+        }
+        break;
+    case TagType::List:
+        put<uint8_t>(out, static_cast<uint8_t>(tag.listType));
+        put<int32_t>(out, static_cast<int32_t>(tag.items.size()));
+        for (const auto& item : tag.items) {
+            writePayload(out, item);
+        }
+        break;
+    case TagType::Compound:
+        for (size_t i = 0; i < tag.items.size(); i++) {
+            put<uint8_t>(out, static_cast<uint8_t>(tag.items[i].type));
+            putString(out, tag.names[i]);
+            writePayload(out, tag.items[i]);
+        }
+        put<uint8_t>(out, 0);
+        break;
+    }
+}
+
+void writeNbt(std::string& out, const Tag& tag) {
+    put<uint8_t>(out, static_cast<uint8_t>(tag.type));
+    putString(out, {});
+    writePayload(out, tag);
+}
+
+class NbtReader {
+public:
+    explicit NbtReader(std::string_view data) : mData(data) {}
+
+    bool read(Tag& out) {
+        uint8_t     type = 0;
+        std::string name;
+        return get(type) && getString(name) && payload(static_cast<TagType>(type), out);
+    }
+
+    size_t position() const { return mPos; }
+
+    template <class T>
+    bool get(T& value) {
+        if (mData.size() - mPos < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, mData.data() + mPos, sizeof(T));
+        mPos += sizeof(T);
+        return true;
+    }
+
+    bool getString(std::string& out) {
+        uint16_t size = 0;
+        if (!get(size) || mData.size() - mPos < size) {
+            return false;
+        }
+        out.assign(mData.data() + mPos, size);
+        mPos += size;
+        return true;
+    }
+
+private:
+    bool elements(TagType elementType, Tag& out) {
+        int32_t count = 0;
+        if (!get(count) || count < 0 || static_cast<size_t>(count) > mData.size() - mPos) {
+            return false;
+        }
+        out.items.resize(static_cast<size_t>(count));
+        for (auto& item : out.items) {
+            if (!payload(elementType, item)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool payload(TagType type, Tag& out) {
+        out.type = type;
+        switch (type) {
+        case TagType::Byte: {
+            int8_t value = 0;
+            return get(value) && (out.integer = value, true);
+        }
+        case TagType::Short: {
+            int16_t value = 0;
+            return get(value) && (out.integer = value, true);
+        }
+        case TagType::Int: {
+            int32_t value = 0;
+            return get(value) && (out.integer = value, true);
+        }
+        case TagType::Long:
+            return get(out.integer);
+        case TagType::Float: {
+            uint32_t bits = 0;
+            return get(bits) && (out.real = std::bit_cast<float>(bits), true);
+        }
+        case TagType::Double: {
+            uint64_t bits = 0;
+            return get(bits) && (out.real = std::bit_cast<double>(bits), true);
+        }
+        case TagType::String:
+            return getString(out.text);
+        case TagType::ByteArray:
+            return elements(TagType::Byte, out);
+        case TagType::IntArray:
+            return elements(TagType::Int, out);
+        case TagType::LongArray:
+            return elements(TagType::Long, out);
+        case TagType::List: {
+            uint8_t listType = 0;
+            if (!get(listType)) {
+                return false;
+            }
+            out.listType = static_cast<TagType>(listType);
+            return elements(out.listType, out);
+        }
+        case TagType::Compound:
+            while (true) {
+                uint8_t childType = 0;
+                if (!get(childType)) {
+                    return false;
+                }
+                if (childType == 0) {
+                    return true;
+                }
+                out.names.emplace_back();
+                if (!getString(out.names.back()) || !payload(static_cast<TagType>(childType), out.items.emplace_back())) {
+                    return false;
+                }
+            }
+        case TagType::End:
+            break;
+        }
+        return false;
+    }
+
+    std::string_view mData;
+    size_t           mPos = 0;
+};
+
+// ===== 候选格式 =====
+
+// 槽位头：slot, count, damage, 物品类型
+void writeSlotHeader(std::string& out, const Slot& slot) {
+    put<uint8_t>(out, slot.slot);
+    put<uint8_t>(out, slot.count);
+    put<int16_t>(out, slot.damage);
+    putString(out, slot.itemType);
+}
+
+bool readSlotHeader(NbtReader& reader, Slot& slot) {
+    return reader.get(slot.slot) && reader.get(slot.count) && reader.get(slot.damage) && reader.getString(slot.itemType);
+}
+
+using Rows = std::vector<std::string>;
+
+struct Codec {
+    const char* name;
+    void (*encode)(const Player& player, Rows& rows);
+    bool (*decode)(const Rows& rows, Player& player);
+};
+
+void encodeSnbtRows(const Player& player, Rows& rows) {
+    for (const auto& slot : player) {
+        auto& row = rows.emplace_back();
+        writeSlotHeader(row, slot);
+        if (slot.hasNbt) {
+            writeSnbt(row, slot.nbt);
+        }
+    }
+}
+
+bool decodeSnbtRows(const Rows& rows, Player& player) {
+    for (const auto& row : rows) {
+        NbtReader reader(row);
+        Slot&     slot = player.emplace_back();
+        if (!readSlotHeader(reader, slot)) {
+            return false;
+        }
+        std::string_view text = std::string_view(row).substr(reader.position());
+        slot.hasNbt           = !text.empty();
+        if (slot.hasNbt && !SnbtParser(text).parse(slot.nbt)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void encodeNbtRows(const Player& player, Rows& rows) {
+    for (const auto& slot : player) {
+        auto& row = rows.emplace_back();
+        writeSlotHeader(row, slot);
+        if (slot.hasNbt) {
+            writeNbt(row, slot.nbt);
+        }
+    }
+}
+
+bool decodeNbtRows(const Rows& rows, Player& player) {
+    for (const auto& row : rows) {
+        NbtReader reader(row);
+        Slot&     slot = player.emplace_back();
+        if (!readSlotHeader(reader, slot)) {
+            return false;
+        }
+        slot.hasNbt = reader.position() < row.size();
+        if (slot.hasNbt && !reader.read(slot.nbt)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 槽位数 + 每个槽位 [槽位头][NBT 长度][二进制 NBT]
+void writeBlob(std::string& out, const Player& player) {
+    put<uint16_t>(out, static_cast<uint16_t>(player.size()));
+    std::string nbt;
+    for (const auto& slot : player) {
+        writeSlotHeader(out, slot);
+        nbt.clear();
+        if (slot.hasNbt) {
+            writeNbt(nbt, slot.nbt);
+        }
+        put<uint32_t>(out, static_cast<uint32_t>(nbt.size()));
+        out += nbt;
+    }
+}
+
+bool readBlob(std::string_view data, Player& player) {
+    NbtReader reader(data);
+    uint16_t  count = 0;
+    if (!reader.get(count)) {
+        return false;
+    }
+    player.reserve(count);
+    for (uint16_t i = 0; i < count; i++) {
+        Slot&    slot = player.emplace_back();
+        uint32_t size = 0;
+        if (!readSlotHeader(reader, slot) || !reader.get(size)) {
+            return false;
+        }
+        slot.hasNbt = size > 0;
+        if (slot.hasNbt) {
+            size_t start = reader.position();
+            if (!reader.read(slot.nbt) || reader.position() - start != size) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void encodeBlob(const Player& player, Rows& rows) { writeBlob(rows.emplace_back(), player); }
+
+bool decodeBlob(const Rows& rows, Player& player) { return rows.size() == 1 && readBlob(rows.front(), player); }
+
+// 原始长度 + zlib 压缩后的 blob
+void encodeZlib(const Player& player, Rows& rows) {
+    std::string raw;
+    writeBlob(raw, player);
+
+    auto& row    = rows.emplace_back();
+    uLong bound  = compressBound(static_cast<uLong>(raw.size()));
+    row.resize(sizeof(uint32_t) + bound);
+    uint32_t rawSize = static_cast<uint32_t>(raw.size());
+    std::memcpy(row.data(), &rawSize, sizeof(rawSize));
+    uLongf size = bound;
+    compress2(
+        reinterpret_cast<Bytef*>(row.data() + sizeof(rawSize)),
+        &size,
+        reinterpret_cast<const Bytef*>(raw.data()),
+        static_cast<uLong>(raw.size()),
+        Z_DEFAULT_COMPRESSION
+    );
+    row.resize(sizeof(rawSize) + size);
+}
+
+bool decodeZlib(const Rows& rows, Player& player) {
+    if (rows.size() != 1 || rows.front().size() < sizeof(uint32_t)) {
+        return false;
+    }
+    const auto& row     = rows.front();
+    uint32_t    rawSize = 0;
+    std::memcpy(&rawSize, row.data(), sizeof(rawSize));
+
+    std::string raw(rawSize, '\0');
+    uLongf      size = rawSize;
+    if (uncompress(
+            reinterpret_cast<Bytef*>(raw.data()),
+            &size,
+            reinterpret_cast<const Bytef*>(row.data() + sizeof(rawSize)),
+            static_cast<uLong>(row.size() - sizeof(rawSize))
+        )
+        != Z_OK) {
+        return false;
+    }
+    return size == rawSize && readBlob(raw, player);
+}
+
+const Codec kCodecs[] = {
+    {"snbt", encodeSnbtRows, decodeSnbtRows},
+    {"nbt",  encodeNbtRows,  decodeNbtRows },
+    {"blob", encodeBlob,     decodeBlob    },
+    {"zlib", encodeZlib,     decodeZlib    },
+};
+
+// ===== 语料 =====
+
+struct CorpusItem {
+    std::string itemType;
+    std::string snbt;  // 空表示没有 NBT
+    int         weight = 1;
+};
+
+// 内置语料：按 Bedrock 物品 NBT 的常见形态构造，权重大致对应生存服背包中的比例
+std::vector<CorpusItem> builtinCorpus() {
+    std::vector<CorpusItem> corpus;
+    corpus.push_back({"minecraft:cobblestone", "", 30});
+    corpus.push_back({"minecraft:bread", "", 10});
+    corpus.push_back({"minecraft:torch", "", 10});
+    corpus.push_back({"minecraft:iron_pickaxe", "{Damage:87}", 8});
+    corpus.push_back({"minecraft:bow", "{Damage:12,RepairCost:1}", 5});
+    corpus.push_back(
+        {"minecraft:diamond_chestplate",
+         "{Damage:31,RepairCost:3,ench:[{id:0s,lvl:4s},{id:5s,lvl:3s},{id:17s,lvl:3s}]}",
+         8}
+    );
+    corpus.push_back(
+        {"minecraft:netherite_helmet",
+         "{Damage:4,RepairCost:7,ench:[{id:0s,lvl:4s},{id:6s,lvl:3s},{id:8s,lvl:1s},{id:17s,lvl:3s},{id:26s,lvl:1s}]}",
+         4}
+    );
+    corpus.push_back(
+        {"minecraft:diamond_sword",
+         "{RepairCost:7,display:{Lore:[\"§7传说中的武器\",\"§8击杀数: 128\"],Name:\"§6§l王者之剑\"},"
+         "ench:[{id:9s,lvl:5s},{id:12s,lvl:2s},{id:14s,lvl:3s},{id:17s,lvl:3s}]}",
+         4}
+    );
+    corpus.push_back({"minecraft:name_tag", "{display:{Name:\"小白\"}}", 2});
+
+    // 潜影盒：27 格，部分物品自带 tag
+    std::string shulker = "{Items:[";
+    for (int i = 0; i < 27; i++) {
+        if (i > 0) {
+            shulker += ',';
+        }
+        if (i % 9 == 4) {
+            shulker += std::format(
+                "{{Count:1b,Damage:0s,Name:\"minecraft:enchanted_book\",Slot:{}b,WasPickedUp:0b,"
+                "tag:{{ench:[{{id:{}s,lvl:{}s}}]}}}}",
+                i,
+                i % 30,
+                1 + i % 4
+            );
+        } else {
+            shulker += std::format(
+                "{{Count:64b,Damage:0s,Name:\"minecraft:{}\",Slot:{}b,WasPickedUp:0b}}",
+                i % 2 ? "oak_planks" : "stone_bricks",
+                i
+            );
+        }
+    }
+    shulker += "]}";
+    corpus.push_back({"minecraft:shulker_box", shulker, 3});
+
+    // 成书：多页文本
+    std::string book = "{author:\"Steve\",generation:0,pages:[";
+    for (int i = 0; i < 12; i++) {
+        if (i > 0) {
+            book += ',';
+        }
+        book += std::format(
+            "{{photoname:\"\",text:\"第 {} 页：今天在主城东边的山洞里发现了一条钻石矿脉，沿着岩浆湖往下挖了大约二十格，"
+            "记得带上防火药水和足够的火把。\"}}",
+            i + 1
+        );
+    }
+    book += "],title:\"旅行日志\",xuid:2535412345678901L}";
+    corpus.push_back({"minecraft:written_book", book, 2});
+    return corpus;
+}
+
+// mysql -B 的输出中制表符、换行和反斜杠被转义
+std::string unescapeTsv(std::string_view text) {
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '\\' && i + 1 < text.size()) {
+            char c = text[++i];
+            out.push_back(c == 'n' ? '\n' : c == 't' ? '\t' : c == '0' ? '\0' : c);
+        } else {
+            out.push_back(text[i]);
+        }
+    }
+    return out;
+}
+
+bool loadCorpus(const std::string& path, std::vector<CorpusItem>& corpus) {
+    std::ifstream file(path);
+    if (!file) {
+        std::fprintf(stderr, "无法打开语料文件: %s\n", path.c_str());
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t tab = line.find('\t');
+        if (line.empty() || tab == std::string::npos) {
+            continue;
+        }
+        std::string snbt = unescapeTsv(std::string_view(line).substr(tab + 1));
+        if (snbt == "NULL") {
+            snbt.clear();
+        }
+        corpus.push_back({unescapeTsv(std::string_view(line).substr(0, tab)), std::move(snbt), 1});
+    }
+    return !corpus.empty();
+}
+
+// ===== 测量 =====
+
+struct Options {
+    std::string corpus;
+    int         players = 200;
+    double      fill    = 0.6;
+    double      seconds = 1.0;  // 每项测量的最短时间
+};
+
+struct Measurement {
+    double seconds     = 0;
+    size_t passes      = 0;
+    size_t allocations = 0;
+};
+
+// 重复执行 pass 直到累计时间达到 minSeconds，分配次数按单次平均
+template <class Pass>
+Measurement measure(double minSeconds, Pass pass) {
+    Measurement result;
+    auto        start = Clock::now();
+    do {
+        uint64_t before = gAllocations.load(std::memory_order_relaxed);
+        pass();
+        result.allocations += gAllocations.load(std::memory_order_relaxed) - before;
+        result.passes++;
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (result.seconds < minSeconds);
+    return result;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string_view arg   = argv[i];
+        std::string      value = argv[i + 1];
+        try {
+            if (arg == "--corpus") {
+                options.corpus = value;
+            } else if (arg == "--players") {
+                options.players = std::max(std::stoi(value), 1);
+            } else if (arg == "--fill") {
+                options.fill = std::clamp(std::stod(value), 0.0, 1.0);
+            } else if (arg == "--seconds") {
+                options.seconds = std::max(std::stod(value), 0.01);
+            } else {
+                return false;
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return argc % 2 == 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::printf("用法: bdsmysql-codecbench [--corpus 文件] [--players N] [--fill 0-1] [--seconds 秒]\n");
+        return 2;
+    }
+
+    std::vector<CorpusItem> corpus;
+    if (options.corpus.empty()) {
+        corpus = builtinCorpus();
+    } else if (!loadCorpus(options.corpus, corpus)) {
+        return 1;
+    }
+
+    // 语料先解析成树，无法解析的条目跳过
+    std::vector<Tag> trees(corpus.size());
+    std::vector<int> weights;
+    size_t           skipped = 0;
+    for (size_t i = 0; i < corpus.size(); i++) {
+        bool ok = corpus[i].snbt.empty() || SnbtParser(corpus[i].snbt).parse(trees[i]);
+        weights.push_back(ok ? corpus[i].weight : 0);
+        skipped += ok ? 0 : 1;
+    }
+    if (skipped > 0) {
+        std::printf("跳过 %zu 条无法解析的 SNBT\n", skipped);
+    }
+    if (std::all_of(weights.begin(), weights.end(), [](int w) { return w == 0; })) {
+        std::fprintf(stderr, "语料中没有可用的条目\n");
+        return 1;
+    }
+
+    // 合成玩家：每个槽位按填充率决定是否有物品，物品按权重从语料中抽取
+    std::mt19937                       rng(20240601);
+    std::bernoulli_distribution        occupied(options.fill);
+    std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+    std::vector<Player>                players(static_cast<size_t>(options.players));
+    size_t                             slots     = 0;
+    size_t                             snbtBytes = 0;
+    for (auto& player : players) {
+        for (int slot = 0; slot <= 40; slot++) {
+            if (!occupied(rng)) {
+                continue;
+            }
+            size_t index = pick(rng);
+            Slot&  item  = player.emplace_back();
+            item.slot     = static_cast<uint8_t>(slot);
+            item.count    = 1;
+            item.itemType = corpus[index].itemType;
+            item.hasNbt   = !corpus[index].snbt.empty();
+            item.nbt      = trees[index];
+            snbtBytes += corpus[index].snbt.size();
+            slots++;
+        }
+    }
+    if (slots == 0) {
+        std::fprintf(stderr, "没有生成任何物品，请提高 --fill\n");
+        return 1;
+    }
+
+    std::printf(
+        "语料 %zu 条，玩家 %d，槽位 %zu（填充率 %.2f），SNBT 平均 %.1f 字节/槽位\n",
+        corpus.size(),
+        options.players,
+        slots,
+        options.fill,
+        static_cast<double>(snbtBytes) / static_cast<double>(slots)
+    );
+
+    for (const auto& codec : kCodecs) {
+        // 预先编码一份，用于解码测量和往返校验
+        std::vector<Rows> encoded(players.size());
+        size_t            bytes = 0;
+        for (size_t i = 0; i < players.size(); i++) {
+            codec.encode(players[i], encoded[i]);
+            for (const auto& row : encoded[i]) {
+                bytes += row.size();
+            }
+        }
+
+        bool roundTrip = true;
+        for (size_t i = 0; i < players.size() && roundTrip; i++) {
+            Player decoded;
+            roundTrip = codec.decode(encoded[i], decoded) && decoded == players[i];
+        }
+
+        auto encode = measure(options.seconds, [&] {
+            for (const auto& player : players) {
+                Rows rows;
+                codec.encode(player, rows);
+            }
+        });
+        auto decode = measure(options.seconds, [&] {
+            for (const auto& rows : encoded) {
+                Player player;
+                codec.decode(rows, player);
+            }
+        });
+
+        auto report = [&](const Measurement& m, double& mbPerSecond, double& slotsPerSecond, double& allocsPerSlot) {
+            double processed = static_cast<double>(m.passes);
+            mbPerSecond      = static_cast<double>(bytes) * processed / m.seconds / (1024.0 * 1024.0);
+            slotsPerSecond   = static_cast<double>(slots) * processed / m.seconds;
+            allocsPerSlot    = static_cast<double>(m.allocations) / processed / static_cast<double>(slots);
+        };
+        double encodeMb, encodeSlots, encodeAllocs, decodeMb, decodeSlots, decodeAllocs;
+        report(encode, encodeMb, encodeSlots, encodeAllocs);
+        report(decode, decodeMb, decodeSlots, decodeAllocs);
+
+        std::printf(
+            "%-5s %7.1f 字节/槽位  编码 %8.1f MB/s %10.0f 槽位/s %5.2f 次分配/槽位  "
+            "解码 %8.1f MB/s %10.0f 槽位/s %5.2f 次分配/槽位%s\n",
+            codec.name,
+            static_cast<double>(bytes) / static_cast<double>(slots),
+            encodeMb,
+            encodeSlots,
+            encodeAllocs,
+            decodeMb,
+            decodeSlots,
+            decodeAllocs,
+            roundTrip ? "" : "  [往返结果不一致]"
+        );
+    }
+    return 0;
+}
@@ -0,0 +1,370 @@
+// 数据库层基准测试：不依赖 LeviLamina，用合成玩家数据对本地 MySQL 测量加入（读取快照）和保存的吞吐量与延迟。
+//
+// 用法: bdsmysql-dbbench [--dir 目录] [--players N] [--concurrency N] [--rounds N]
+//                        [--fill 0-1] [--nbt 字节数] [--modes snapshot,split,async]
+//
+// 连接参数读取 <目录>/config/config.json（不存在时写入默认配置后退出），请使用单独的测试数据库
+
+#include "ll/api/mod/NativeMod.h"
+#include "mod/Config.h"
+#include "mod/Database.h"
+#include "mod/Log.h"
+#include "mod/Metrics.h"
+#include "mod/SlowQueryLog.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <future>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace bdsmysql;
+using Clock = std::chrono::steady_clock;
+
+// 存储方式：
+//   snapshot - 事务提交完整快照，按玩家读取快照（插件默认路径）
+//   split    - 属性、背包、装备分别提交和读取（旧接口）
+//   async    - 事务提交，读取走 loadPlayerSnapshotAsync（eventLoop.enabled 时由事件循环在一个连接上执行，不占用线程）
+enum class StorageMode { Snapshot, Split, Async };
+
+struct BenchOptions {
+    std::string              dir         = "bench-data";
+    int                      players     = 200;
+    int                      concurrency = 8;
+    int                      rounds      = 3;    // 每个玩家保存和加入的次数
+    double                   fill        = 0.5;  // 每个槽位有物品的概率
+    int                      nbtBytes    = 64;   // 每个物品的 NBT 文本长度，0 表示不带 NBT
+    std::vector<std::string> modes       = {"snapshot", "split", "async"};
+};
+
+struct PhaseResult {
+    uint64_t ops      = 0;
+    uint64_t failures = 0;
+    double   seconds  = 0;
+};
+
+const char* const kBackpackItems[] = {
+    "minecraft:stone",
+    "minecraft:oak_log",
+    "minecraft:iron_ingot",
+    "minecraft:diamond",
+    "minecraft:bread",
+    "minecraft:torch",
+    "minecraft:diamond_pickaxe",
+    "minecraft:bow",
+};
+const char* const kEquipmentItems[] = {
+    "minecraft:diamond_helmet",
+    "minecraft:diamond_chestplate",
+    "minecraft:diamond_leggings",
+    "minecraft:diamond_boots",
+    "minecraft:shield",
+};
+
+void printUsage() {
+    std::printf(
+        "用法: bdsmysql-dbbench [--dir 目录] [--players N] [--concurrency N] [--rounds N]\n"
+        "                       [--fill 0-1] [--nbt 字节数] [--modes snapshot,split,async]\n"
+    );
+}
+
+std::vector<std::string> splitList(std::string_view text) {
+    std::vector<std::string> items;
+    while (!text.empty()) {
+        size_t comma = text.find(',');
+        if (comma != 0) {
+            items.emplace_back(text.substr(0, comma));
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(comma + 1);
+    }
+    return items;
+}
+
+bool parseOptions(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "参数 %s 缺少取值\n", argv[i]);
+            return false;
+        }
+
+        std::string value = argv[++i];
+        try {
+            if (arg == "--dir") {
+                options.dir = value;
+            } else if (arg == "--players") {
+                options.players = std::max(std::stoi(value), 1);
+            } else if (arg == "--concurrency") {
+                options.concurrency = std::max(std::stoi(value), 1);
+            } else if (arg == "--rounds") {
+                options.rounds = std::max(std::stoi(value), 1);
+            } else if (arg == "--fill") {
+                options.fill = std::clamp(std::stod(value), 0.0, 1.0);
+            } else if (arg == "--nbt") {
+                options.nbtBytes = std::max(std::stoi(value), 0);
+            } else if (arg == "--modes") {
+                options.modes = splitList(value);
+            } else {
+                std::fprintf(stderr, "未知参数: %s\n", argv[i - 1]);
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::fprintf(stderr, "参数 %s 的取值无效: %s\n", argv[i - 1], value.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parseMode(std::string_view name, StorageMode& mode) {
+    if (name == "snapshot") {
+        mode = StorageMode::Snapshot;
+    } else if (name == "split") {
+        mode = StorageMode::Split;
+    } else if (name == "async") {
+        mode = StorageMode::Async;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string playerUuid(int index) { return std::format("bench-{:08d}", index); }
+
+// 合成玩家数据：同一编号每次生成相同的内容
+PlayerSnapshot makePlayer(int index, const BenchOptions& options, const std::string& serverName) {
+    std::mt19937                           rng(static_cast<uint32_t>(index) * 2654435761u);
+    std::bernoulli_distribution            occupied(options.fill);
+    std::uniform_int_distribution<int>     count(1, 64);
+    std::uniform_int_distribution<size_t>  pick(0, std::size(kBackpackItems) - 1);
+    std::uniform_int_distribution<int16_t> damage(0, 300);
+
+    PlayerSnapshot snapshot;
+    auto&          data = snapshot.syncData;
+    data.id             = 0;
+    data.uuid           = playerUuid(index);
+    data.serverName     = serverName;
+    data.health         = 20;
+    data.maxHealth      = 20;
+    data.food           = 18;
+    data.foodSaturation = 5;
+    data.expLevel       = index % 50;
+    data.expPoints      = index % 100;
+    data.gamemode       = 0;
+    data.x              = static_cast<float>(index);
+    data.y              = 64.0f;
+    data.z              = static_cast<float>(-index);
+    data.dimension      = 0;
+
+    // NBT 内容对数据库层不透明，只需要长度合适的文本
+    std::string nbt;
+    if (options.nbtBytes > 0) {
+        nbt = "{bench:\"" + std::string(static_cast<size_t>(options.nbtBytes), 'x') + "\"}";
+    }
+
+    auto& items = snapshot.items;
+    items.reserve(ItemList::kLastEquipmentSlot + 1, (ItemList::kLastEquipmentSlot + 1) * nbt.size());
+    for (int slot = 0; slot <= ItemList::kLastBackpackSlot; slot++) {
+        if (occupied(rng)) {
+            items.add(slot, kBackpackItems[pick(rng)], count(rng), 0, nbt);
+        }
+    }
+    for (int slot = ItemList::kFirstEquipmentSlot; slot <= ItemList::kLastEquipmentSlot; slot++) {
+        if (occupied(rng)) {
+            items.add(slot, kEquipmentItems[slot - ItemList::kFirstEquipmentSlot], 1, damage(rng), nbt);
+        }
+    }
+    return snapshot;
+}
+
+bool savePlayer(StorageMode mode, PlayerSnapshot& snapshot) {
+    auto& db = Database::getInstance();
+    if (mode == StorageMode::Split) {
+        const auto& uuid       = snapshot.syncData.uuid;
+        const auto& serverName = snapshot.syncData.serverName;
+        return db.savePlayerSyncData(snapshot.syncData) && db.savePlayerBackpack(uuid, serverName, snapshot.items)
+            && db.savePlayerEquipment(uuid, serverName, snapshot.items);
+    }
+    return db.savePlayerSnapshot(snapshot);
+}
+
+bool joinPlayer(StorageMode mode, const std::string& uuid, const std::string& serverName) {
+    auto& db = Database::getInstance();
+    switch (mode) {
+    case StorageMode::Snapshot: {
+        PlayerSnapshot snapshot;
+        return db.loadPlayerSnapshot(uuid, snapshot);
+    }
+    case StorageMode::Split: {
+        PlayerSyncData data{};
+        ItemList       items;
+        return db.loadPlayerSyncData(uuid, serverName, data) && db.loadPlayerBackpack(uuid, serverName, items)
+            && db.loadPlayerEquipment(uuid, serverName, items);
+    }
+    case StorageMode::Async: {
+        std::promise<bool> done;
+        auto               result = done.get_future();
+        db.loadPlayerSnapshotAsync(uuid, [&done](SnapshotLoad& load) {
+            done.set_value(load.success && (load.hasSyncData || !load.snapshot.items.empty()));
+        });
+        return result.get();
+    }
+    }
+    return false;
+}
+
+// 用 concurrency 个线程执行 players * rounds 次操作，每次操作的耗时记入 latency 直方图
+template <class Op>
+PhaseResult runPhase(const BenchOptions& options, MetricId latency, Op op) {
+    uint64_t              total = static_cast<uint64_t>(options.players) * options.rounds;
+    std::atomic<uint64_t> next{0};
+    std::atomic<uint64_t> failures{0};
+
+    auto start = Clock::now();
+
+    std::vector<std::thread> workers;
+    workers.reserve(options.concurrency);
+    for (int t = 0; t < options.concurrency; t++) {
+        workers.emplace_back([&] {
+            for (uint64_t i = next.fetch_add(1); i < total; i = next.fetch_add(1)) {
+                auto opStart = Clock::now();
+                bool ok      = op(static_cast<int>(i % options.players));
+                Metrics::getInstance().record(latency, Clock::now() - opStart);
+                if (!ok) {
+                    failures.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    PhaseResult result;
+    result.ops      = total;
+    result.failures = failures.load();
+    result.seconds  = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+void printPhase(std::string_view mode, std::string_view phase, const PhaseResult& result, std::string_view histogram) {
+    HistogramSnapshot latency;
+    for (auto& h : Metrics::getInstance().histograms()) {
+        if (h.name == histogram) {
+            latency = std::move(h);
+            break;
+        }
+    }
+
+    std::printf(
+        "%-9s %-5s %8.1f ops/s  p50 %7.2f ms  p95 %7.2f ms  p99 %7.2f ms  max %7.2f ms  失败 %llu/%llu\n",
+        std::string(mode).c_str(),
+        std::string(phase).c_str(),
+        result.seconds > 0 ? static_cast<double>(result.ops) / result.seconds : 0.0,
+        latency.percentileMs(0.50),
+        latency.percentileMs(0.95),
+        latency.percentileMs(0.99),
+        static_cast<double>(latency.maxUs) / 1000.0,
+        static_cast<unsigned long long>(result.failures),
+        static_cast<unsigned long long>(result.ops)
+    );
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    std::vector<std::pair<std::string, StorageMode>> modes;
+    for (const auto& name : options.modes) {
+        StorageMode mode;
+        if (!parseMode(name, mode)) {
+            std::fprintf(stderr, "未知的存储方式: %s（可选 snapshot、split、async）\n", name.c_str());
+            return 2;
+        }
+        modes.emplace_back(name, mode);
+    }
+
+    ll::mod::NativeMod::current()->setModDir(std::filesystem::absolute(options.dir));
+    bool hadConfig = std::filesystem::exists(std::filesystem::path(options.dir) / "config" / "config.json");
+    if (!Config::getInstance().load()) {
+        return 1;
+    }
+    if (!hadConfig) {
+        std::printf("已在 %s 写入默认配置，请填写测试数据库的连接参数后重新运行\n", options.dir.c_str());
+        return 1;
+    }
+
+    const auto& config = Config::getInstance().getDatabaseConfig();
+    AsyncLog::getInstance().start();
+    SlowQueryLog::getInstance().start();
+
+    auto& db = Database::getInstance();
+    if (!db.connect() || !db.initTables()) {
+        SlowQueryLog::getInstance().stop();
+        AsyncLog::getInstance().stop();
+        return 1;
+    }
+
+    std::printf(
+        "玩家 %d，并发 %d，轮数 %d，槽位填充率 %.2f，NBT %d 字节，连接池 %d，事件循环 %s\n",
+        options.players,
+        options.concurrency,
+        options.rounds,
+        options.fill,
+        options.nbtBytes,
+        config.poolSize,
+        config.eventLoop.enabled ? "开启" : "关闭"
+    );
+    if (options.concurrency > config.poolSize) {
+        std::printf("注意：并发数大于连接池大小，多出的线程会等待空闲连接\n");
+    }
+
+    // 合成数据在计时之前生成，只测量数据库层
+    std::vector<PlayerSnapshot> players;
+    players.reserve(options.players);
+    for (int i = 0; i < options.players; i++) {
+        players.push_back(makePlayer(i, options, config.serverName));
+    }
+
+    for (const auto& [name, mode] : modes) {
+        std::string saveMetric = std::format("bench.{}.save", name);
+        std::string joinMetric = std::format("bench.{}.join", name);
+
+        // 同一快照对象可能被多个线程同时保存（rounds > 1 且玩家数少于并发数时），保存时复制一份
+        auto saves = runPhase(options, Metrics::getInstance().histogram(saveMetric), [&](int index) {
+            PlayerSnapshot snapshot = players[index];
+            return savePlayer(mode, snapshot);
+        });
+        auto joins = runPhase(options, Metrics::getInstance().histogram(joinMetric), [&](int index) {
+            return joinPlayer(mode, players[index].syncData.uuid, config.serverName);
+        });
+
+        printPhase(name, "save", saves, saveMetric);
+        printPhase(name, "join", joins, joinMetric);
+    }
+
+    SlowQueryLog::getInstance().stop();
+    db.disconnect();
+    AsyncLog::getInstance().stop();
+    return 0;
+}
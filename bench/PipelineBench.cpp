@@ -0,0 +1,428 @@
+// 加入/离开流程基准测试：用 MemoryPlayerState 代替游戏中的玩家，对本地 MySQL 运行完整的
+// PlayerPipeline（后台读取 -> 主线程应用 -> 采集 -> 保存队列提交），测量端到端延迟和主线程开销。
+//
+// 用法: bdsmysql-pipelinebench [--dir 目录] [--players N] [--rounds N] [--window N] [--fill 0-1] [--nbt 字节数]
+//                              [--alloc 0|1]
+//
+// 连接参数读取 <目录>/config/config.json（不存在时写入默认配置后退出），请使用单独的测试数据库。
+// 本程序的主线程扮演服务器主线程：apply 和 capture 都在这里执行；加入准入控制和每 tick 的
+// 完成队列依赖 LeviLamina 的调度器，不在测试范围内，读取结果直接交回主线程处理
+
+#include "ll/api/mod/NativeMod.h"
+#include "mod/AllocStats.h"
+#include "mod/Config.h"
+#include "mod/Database.h"
+#include "mod/DatabaseExecutor.h"
+#include "mod/Log.h"
+#include "mod/Metrics.h"
+#include "mod/PlayerPipeline.h"
+#include "mod/PlayerState.h"
+#include "mod/SaveQueue.h"
+#include "mod/SlowQueryLog.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <format>
+#include <iterator>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using namespace bdsmysql;
+using Clock = std::chrono::steady_clock;
+
+struct BenchOptions {
+    std::string dir      = "bench-data";
+    int         players  = 200;
+    int         rounds   = 3;      // 每个玩家加入和离开的次数
+    int         window   = 16;     // 同时进行的加入读取数（相当于准入控制的并发上限）
+    double      fill     = 0.5;    // 每个槽位有物品的概率
+    int         nbtBytes = 64;     // 每个物品的 NBT 文本长度，0 表示不带 NBT
+    bool        alloc    = false;  // 按阶段统计内存分配（配置中 metrics.allocStats 为 true 时同样开启）
+};
+
+struct PhaseResult {
+    uint64_t ops      = 0;
+    uint64_t failures = 0;
+    double   seconds  = 0;
+};
+
+// 后台读取完成、等待主线程应用的加入
+struct LoadedJoin {
+    int               index = 0;
+    Clock::time_point start;
+    PlayerLoadResult  result;
+};
+
+const char* const kBackpackItems[] = {
+    "minecraft:stone",
+    "minecraft:oak_log",
+    "minecraft:iron_ingot",
+    "minecraft:diamond",
+    "minecraft:bread",
+    "minecraft:torch",
+    "minecraft:diamond_pickaxe",
+    "minecraft:bow",
+};
+const char* const kEquipmentItems[] = {
+    "minecraft:diamond_helmet",
+    "minecraft:diamond_chestplate",
+    "minecraft:diamond_leggings",
+    "minecraft:diamond_boots",
+    "minecraft:shield",
+};
+
+void printUsage() {
+    std::printf(
+        "用法: bdsmysql-pipelinebench [--dir 目录] [--players N] [--rounds N] [--window N]\n"
+        "                             [--fill 0-1] [--nbt 字节数] [--alloc 0|1]\n"
+    );
+}
+
+bool parseOptions(int argc, char** argv, BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "参数 %s 缺少取值\n", argv[i]);
+            return false;
+        }
+
+        std::string value = argv[++i];
+        try {
+            if (arg == "--dir") {
+                options.dir = value;
+            } else if (arg == "--players") {
+                options.players = std::max(std::stoi(value), 1);
+            } else if (arg == "--rounds") {
+                options.rounds = std::max(std::stoi(value), 1);
+            } else if (arg == "--window") {
+                options.window = std::max(std::stoi(value), 1);
+            } else if (arg == "--fill") {
+                options.fill = std::clamp(std::stod(value), 0.0, 1.0);
+            } else if (arg == "--nbt") {
+                options.nbtBytes = std::max(std::stoi(value), 0);
+            } else if (arg == "--alloc") {
+                options.alloc = std::stoi(value) != 0;
+            } else {
+                std::fprintf(stderr, "未知参数: %s\n", argv[i - 1]);
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::fprintf(stderr, "参数 %s 的取值无效: %s\n", argv[i - 1], value.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+// 合成玩家：同一编号每次生成相同的初始状态
+MemoryPlayerState makePlayer(int index, const BenchOptions& options) {
+    std::mt19937                           rng(static_cast<uint32_t>(index) * 2654435761u);
+    std::bernoulli_distribution            occupied(options.fill);
+    std::uniform_int_distribution<int>     count(1, 64);
+    std::uniform_int_distribution<size_t>  pick(0, std::size(kBackpackItems) - 1);
+    std::uniform_int_distribution<int16_t> damage(0, 300);
+
+    PlayerSnapshot snapshot;
+    auto&          data = snapshot.syncData;
+    data.health         = 20;
+    data.maxHealth      = 20;
+    data.food           = 18;
+    data.foodSaturation = 5;
+    data.expLevel       = index % 50;
+    data.expPoints      = index % 100;
+    data.gamemode       = 0;
+    data.x              = static_cast<float>(index);
+    data.y              = 64.0f;
+    data.z              = static_cast<float>(-index);
+    data.dimension      = 0;
+
+    std::string nbt;
+    if (options.nbtBytes > 0) {
+        nbt = "{bench:\"" + std::string(static_cast<size_t>(options.nbtBytes), 'x') + "\"}";
+    }
+
+    auto& items = snapshot.items;
+    items.reserve(ItemList::kLastEquipmentSlot + 1, (ItemList::kLastEquipmentSlot + 1) * nbt.size());
+    for (int slot = 0; slot <= ItemList::kLastBackpackSlot; slot++) {
+        if (occupied(rng)) {
+            items.add(slot, kBackpackItems[pick(rng)], count(rng), 0, nbt);
+        }
+    }
+    for (int slot = ItemList::kFirstEquipmentSlot; slot <= ItemList::kLastEquipmentSlot; slot++) {
+        if (occupied(rng)) {
+            items.add(slot, kEquipmentItems[slot - ItemList::kFirstEquipmentSlot], 1, damage(rng), nbt);
+        }
+    }
+
+    return MemoryPlayerState(
+        std::format("pipeline-{:08d}", index),
+        std::format("BenchPlayer{}", index),
+        std::move(snapshot)
+    );
+}
+
+// 所有玩家加入一次：后台读取最多 window 个同时进行，主线程按完成顺序应用
+PhaseResult runJoins(std::vector<MemoryPlayerState>& players, const BenchOptions& options) {
+    auto& metrics    = Metrics::getInstance();
+    auto  endToEnd   = metrics.histogram("bench.pipeline.join");
+    auto  loadMetric = metrics.histogram("bench.pipeline.load");
+
+    std::mutex              mutex;
+    std::condition_variable cv;
+    std::deque<LoadedJoin>  completed;
+
+    int  total    = static_cast<int>(players.size());
+    int  next     = 0;
+    int  inFlight = 0;
+    auto start    = Clock::now();
+
+    auto launch = [&](int index) {
+        auto& player = players[index];
+        auto  uuid   = player.uuid();
+        auto  name   = player.name();
+        auto  posted = Clock::now();
+        DatabaseExecutor::getInstance().post(uuid, [&, index, uuid, name, posted] {
+            LoadedJoin join{index, posted, {}};
+            auto       loadStart = Clock::now();
+            join.result          = PlayerPipeline::getInstance().load(uuid, name, "", std::nullopt);
+            metrics.record(loadMetric, Clock::now() - loadStart);
+
+            std::lock_guard lock(mutex);
+            completed.push_back(std::move(join));
+            cv.notify_one();
+        }, JobPriority::Interactive);
+    };
+
+    PhaseResult result;
+    result.ops = static_cast<uint64_t>(total);
+    for (int done = 0; done < total;) {
+        while (next < total && inFlight < options.window) {
+            launch(next++);
+            inFlight++;
+        }
+
+        std::deque<LoadedJoin> batch;
+        {
+            std::unique_lock lock(mutex);
+            cv.wait(lock, [&] { return !completed.empty(); });
+            batch.swap(completed);
+        }
+
+        for (auto& join : batch) {
+            auto& player = players[join.index];
+            PlayerPipeline::getInstance().apply(player, player, join.result);
+            metrics.record(endToEnd, Clock::now() - join.start);
+            if (!join.result.hasSyncData || !join.result.hasInventoryData) {
+                result.failures++;  // 首轮没有数据库记录属于正常情况，之后的轮次应全部命中
+            }
+            inFlight--;
+            done++;
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+// 所有玩家离开一次：主线程采集并入队，等待保存队列全部提交
+PhaseResult runLeaves(std::vector<MemoryPlayerState>& players) {
+    auto& metrics  = Metrics::getInstance();
+    auto  endToEnd = metrics.histogram("bench.pipeline.leave");
+    auto  capture  = metrics.histogram("bench.pipeline.capture");
+
+    std::mutex              mutex;
+    std::condition_variable cv;
+    size_t                  pending = 0;
+    std::atomic<uint64_t>   failures{0};
+
+    auto start = Clock::now();
+    for (auto& player : players) {
+        // 模拟游戏过程中的变化，避免每轮提交完全相同的快照
+        PlayerSyncData data = player.state().syncData;
+        data.expPoints      = (data.expPoints + 1) % 100;
+        player.applyAttributes(data);
+
+        {
+            std::lock_guard lock(mutex);
+            pending++;
+        }
+        // 队列已满写入本地日志时，回调在 save 返回前以失败调用，同样计入 pending
+        auto enqueued = Clock::now();
+        PlayerPipeline::getInstance().save(player, SaveReason::Leave, [&, enqueued](const SaveResult& save) {
+            metrics.record(endToEnd, save.endTime - enqueued);
+            if (!save.success) {
+                failures.fetch_add(1, std::memory_order_relaxed);
+            }
+            std::lock_guard lock(mutex);
+            if (--pending == 0) {
+                cv.notify_one();
+            }
+        });
+        metrics.record(capture, Clock::now() - enqueued);
+    }
+
+    {
+        std::unique_lock lock(mutex);
+        cv.wait(lock, [&] { return pending == 0; });
+    }
+
+    PhaseResult result;
+    result.ops      = players.size();
+    result.failures = failures.load();
+    result.seconds  = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
+
+HistogramSnapshot findHistogram(std::string_view name) {
+    for (auto& h : Metrics::getInstance().histograms()) {
+        if (h.name == name) {
+            return std::move(h);
+        }
+    }
+    return {};
+}
+
+void printLatency(std::string_view label, std::string_view histogram) {
+    auto latency = findHistogram(histogram);
+    std::printf(
+        "  %-22s p50 %8.3f ms  p95 %8.3f ms  p99 %8.3f ms  max %8.3f ms\n",
+        std::string(label).c_str(),
+        latency.percentileMs(0.50),
+        latency.percentileMs(0.95),
+        latency.percentileMs(0.99),
+        static_cast<double>(latency.maxUs) / 1000.0
+    );
+}
+
+// 每次加入/离开的平均分配次数和字节数（join.* 按加入次数平均，capture/save.commit 按离开次数平均）
+void printAllocations(uint64_t joins, uint64_t leaves) {
+    std::printf("平均每次操作的内存分配\n");
+    for (const auto& stage : AllocStats::snapshots()) {
+        std::string_view name = stage.name;
+        uint64_t         ops  = name.starts_with("join.") ? joins : name == "other" ? 0 : leaves;
+        if (ops == 0) {
+            std::printf(
+                "  %-12s 共 %llu 次，%.1f KB\n",
+                stage.name,
+                static_cast<unsigned long long>(stage.allocations),
+                static_cast<double>(stage.bytes) / 1024.0
+            );
+            continue;
+        }
+        std::printf(
+            "  %-12s %10.1f 次 %12.1f 字节\n",
+            stage.name,
+            static_cast<double>(stage.allocations) / static_cast<double>(ops),
+            static_cast<double>(stage.bytes) / static_cast<double>(ops)
+        );
+    }
+}
+
+void printPhase(std::string_view phase, const PhaseResult& result) {
+    std::printf(
+        "%-5s %8.1f 玩家/s  未命中或失败 %llu/%llu\n",
+        std::string(phase).c_str(),
+        result.seconds > 0 ? static_cast<double>(result.ops) / result.seconds : 0.0,
+        static_cast<unsigned long long>(result.failures),
+        static_cast<unsigned long long>(result.ops)
+    );
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    ll::mod::NativeMod::current()->setModDir(std::filesystem::absolute(options.dir));
+    bool hadConfig = std::filesystem::exists(std::filesystem::path(options.dir) / "config" / "config.json");
+    if (!Config::getInstance().load()) {
+        return 1;
+    }
+    if (!hadConfig) {
+        std::printf("已在 %s 写入默认配置，请填写测试数据库的连接参数后重新运行\n", options.dir.c_str());
+        return 1;
+    }
+
+    const auto& config = Config::getInstance().getDatabaseConfig();
+    AsyncLog::getInstance().start();
+    SlowQueryLog::getInstance().start();
+
+    auto& db = Database::getInstance();
+    if (!db.connect() || !db.initTables()) {
+        SlowQueryLog::getInstance().stop();
+        AsyncLog::getInstance().stop();
+        return 1;
+    }
+
+    // 与插件启动顺序一致：后台线程数 = 连接池大小 - 1
+    DatabaseExecutor::getInstance().start(std::max(config.poolSize - 1, 1));
+    SaveQueue::getInstance().start();
+
+    // 在生成玩家之前开启，只统计加入/离开流程中的分配
+    if (options.alloc || config.metrics.allocStats) {
+        AllocStats::enable();
+    }
+
+    std::printf(
+        "玩家 %d，轮数 %d，加入窗口 %d，槽位填充率 %.2f，NBT %d 字节，连接池 %d\n",
+        options.players,
+        options.rounds,
+        options.window,
+        options.fill,
+        options.nbtBytes,
+        config.poolSize
+    );
+
+    std::vector<MemoryPlayerState> players;
+    players.reserve(options.players);
+    for (int i = 0; i < options.players; i++) {
+        players.push_back(makePlayer(i, options));
+    }
+
+    for (int round = 1; round <= options.rounds; round++) {
+        auto joins = runJoins(players, options);
+        // 补齐缺失数据的写入在玩家的 strand 上排队，等它们完成后再离开，与真实的在线时长相比可以忽略
+        for (const auto& player : players) {
+            DatabaseExecutor::getInstance().waitForStrand(player.uuid());
+        }
+        auto leaves = runLeaves(players);
+
+        std::printf("第 %d 轮\n", round);
+        printPhase("join", joins);
+        printPhase("leave", leaves);
+    }
+
+    std::printf("累计延迟\n");
+    printLatency("加入 (端到端)", "bench.pipeline.join");
+    printLatency("加入 (后台读取)", "bench.pipeline.load");
+    printLatency("加入 (主线程应用)", "join.apply");
+    printLatency("离开 (采集+入队)", "bench.pipeline.capture");
+    printLatency("离开 (到提交完成)", "bench.pipeline.leave");
+    if (AllocStats::enabled()) {
+        auto ops = static_cast<uint64_t>(options.players) * static_cast<uint64_t>(options.rounds);
+        printAllocations(ops, ops);
+    }
+
+    DatabaseExecutor::getInstance().stop();
+    SaveQueue::getInstance().stop();
+    SlowQueryLog::getInstance().stop();
+    db.disconnect();
+    AsyncLog::getInstance().stop();
+    return 0;
+}
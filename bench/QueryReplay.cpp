@@ -0,0 +1,461 @@
+// 查询重放：读取 /bdsmysql record 录制的文件，按录制时的连接和时间间隔在本地 MySQL 上重新执行，
+// 对比录制时和重放时的延迟。用来在真实的负载形态（加入高峰、传送、空/满背包）下离线验证表结构和批处理改动。
+//
+// 用法: bdsmysql-replay --file 录制文件 [--dir 目录] [--speed 倍数] [--top N]
+//
+// 连接参数读取 <目录>/config/config.json（不存在时写入默认配置后退出），请使用单独的测试数据库：
+// 重放会执行录制中的写入语句。启动时先按当前代码建表（initTables），再开始重放
+
+#include "ll/api/mod/NativeMod.h"
+#include "mod/Config.h"
+#include "mod/Database.h"
+#include "mod/Log.h"
+#include "mod/Metrics.h"
+#include "mod/QueryRecorder.h"
+#include <mysql.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using namespace bdsmysql;
+using Clock = std::chrono::steady_clock;
+
+struct ReplayOptions {
+    std::string dir   = "bench-data";
+    std::string file;
+    double      speed = 1.0;  // 0 表示不等待，尽快执行
+    int         top   = 10;   // 输出累计耗时最高的形态数
+};
+
+// 每个形态的累计数据（各连接线程分别累计，结束后合并）
+struct ShapeStats {
+    uint64_t count      = 0;
+    uint64_t errors     = 0;
+    uint64_t recordedUs = 0;
+    uint64_t replayedUs = 0;
+    uint64_t maxUs      = 0;
+};
+
+struct Lane {
+    std::vector<RecordedQuery> queries;
+    std::vector<ShapeStats>    shapes;
+    uint64_t                   errors = 0;
+};
+
+void printUsage() {
+    std::printf("用法: bdsmysql-replay --file 录制文件 [--dir 目录] [--speed 倍数，0 表示不等待] [--top N]\n");
+}
+
+bool parseOptions(int argc, char** argv, ReplayOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "参数 %s 缺少取值\n", argv[i]);
+            return false;
+        }
+
+        std::string value = argv[++i];
+        try {
+            if (arg == "--dir") {
+                options.dir = value;
+            } else if (arg == "--file") {
+                options.file = value;
+            } else if (arg == "--speed") {
+                options.speed = std::max(std::stod(value), 0.0);
+            } else if (arg == "--top") {
+                options.top = std::max(std::stoi(value), 0);
+            } else {
+                std::fprintf(stderr, "未知参数: %s\n", argv[i - 1]);
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::fprintf(stderr, "参数 %s 的取值无效: %s\n", argv[i - 1], value.c_str());
+            return false;
+        }
+    }
+    return !options.file.empty();
+}
+
+// 与连接池相同的连接参数（允许多语句）
+MYSQL* openConnection(const DatabaseConfig& config) {
+    MYSQL* conn = mysql_init(nullptr);
+    if (!conn) {
+        return nullptr;
+    }
+    if (!mysql_real_connect(
+            conn,
+            config.host.c_str(),
+            config.username.c_str(),
+            config.password.c_str(),
+            config.database.c_str(),
+            config.port,
+            nullptr,
+            CLIENT_MULTI_STATEMENTS
+        )) {
+        std::fprintf(stderr, "连接数据库失败: %s\n", mysql_error(conn));
+        mysql_close(conn);
+        return nullptr;
+    }
+    mysql_set_character_set(conn, config.charset.c_str());
+    return conn;
+}
+
+// 文本语句：把参数按顺序填回形态中的 ?（反引号内的内容原样保留）
+std::string buildSql(std::string_view shape, const std::vector<RecordedParam>& params) {
+    std::string sql;
+    sql.reserve(shape.size() + params.size() * 16);
+
+    size_t next       = 0;
+    bool   identifier = false;
+    for (char c : shape) {
+        if (c == '`') {
+            identifier = !identifier;
+        }
+        if (c != '?' || identifier || next >= params.size()) {
+            sql += c;
+            continue;
+        }
+
+        const auto& param = params[next++];
+        switch (param.type) {
+        case recording::ParamType::String:
+            sql += '\'';
+            sql += param.text;
+            sql += '\'';
+            break;
+        case recording::ParamType::Number:
+            sql += param.text;
+            break;
+        case recording::ParamType::Int:
+            sql += std::to_string(param.intValue);
+            break;
+        case recording::ParamType::UInt:
+            sql += std::to_string(static_cast<uint64_t>(param.intValue));
+            break;
+        case recording::ParamType::Double:
+            sql += std::format("{}", param.doubleValue);
+            break;
+        default:
+            sql += "NULL";
+            break;
+        }
+    }
+    return sql;
+}
+
+bool executeText(MYSQL* conn, const std::string& sql) {
+    if (mysql_real_query(conn, sql.c_str(), static_cast<unsigned long>(sql.size()))) {
+        return false;
+    }
+    // 读取并释放所有结果集（多语句时每条语句一个）
+    do {
+        if (MYSQL_RES* result = mysql_store_result(conn)) {
+            mysql_free_result(result);
+        } else if (mysql_errno(conn) != 0) {
+            return false;
+        }
+    } while (mysql_next_result(conn) == 0);
+    return mysql_errno(conn) == 0;
+}
+
+bool executePrepared(MYSQL_STMT* stmt, const std::vector<RecordedParam>& params) {
+    std::vector<MYSQL_BIND>    binds(params.size());
+    std::vector<unsigned long> lengths(params.size());
+    for (size_t i = 0; i < params.size(); i++) {
+        auto& bind  = binds[i];
+        auto& param = params[i];
+        switch (param.type) {
+        case recording::ParamType::Int:
+        case recording::ParamType::UInt:
+            bind.buffer_type = MYSQL_TYPE_LONGLONG;
+            bind.buffer      = const_cast<int64_t*>(&param.intValue);
+            bind.is_unsigned = param.type == recording::ParamType::UInt;
+            break;
+        case recording::ParamType::Double:
+            bind.buffer_type = MYSQL_TYPE_DOUBLE;
+            bind.buffer      = const_cast<double*>(&param.doubleValue);
+            break;
+        case recording::ParamType::String:
+        case recording::ParamType::Number:
+            lengths[i]         = static_cast<unsigned long>(param.text.size());
+            bind.buffer_type   = MYSQL_TYPE_STRING;
+            bind.buffer        = const_cast<char*>(param.text.data());
+            bind.buffer_length = lengths[i];
+            bind.length        = &lengths[i];
+            break;
+        default:
+            bind.buffer_type = MYSQL_TYPE_NULL;
+            break;
+        }
+    }
+
+    if ((!binds.empty() && mysql_stmt_bind_param(stmt, binds.data())) || mysql_stmt_execute(stmt)) {
+        return false;
+    }
+    if (MYSQL_RES* metadata = mysql_stmt_result_metadata(stmt)) {
+        mysql_free_result(metadata);
+        mysql_stmt_store_result(stmt);
+        mysql_stmt_free_result(stmt);
+    }
+    return true;
+}
+
+// 一个录制连接的语句在一个线程上按顺序执行，开始时间按 speed 缩放
+void replayLane(
+    Lane&                             lane,
+    const std::vector<RecordedShape>& shapes,
+    const DatabaseConfig&             config,
+    const ReplayOptions&              options,
+    Clock::time_point                 replayStart,
+    std::atomic<uint64_t>&            lagged
+) {
+    mysql_thread_init();
+
+    auto& metrics  = Metrics::getInstance();
+    auto  recorded = metrics.histogram("replay.recorded");
+    auto  replayed = metrics.histogram("replay.replayed");
+    auto  lag      = metrics.histogram("replay.lag");
+
+    MYSQL* conn = openConnection(config);
+    if (!conn) {
+        lane.errors += lane.queries.size();
+        mysql_thread_end();
+        return;
+    }
+
+    std::unordered_map<uint32_t, MYSQL_STMT*> statements;
+    lane.shapes.resize(shapes.size());
+
+    for (const auto& query : lane.queries) {
+        if (options.speed > 0) {
+            auto scheduled = replayStart
+                           + std::chrono::duration_cast<Clock::duration>(
+                                 std::chrono::duration<double, std::micro>(static_cast<double>(query.startUs) / options.speed)
+                           );
+            auto now = Clock::now();
+            if (now < scheduled) {
+                std::this_thread::sleep_until(scheduled);
+            } else {
+                metrics.record(lag, now - scheduled);
+                if (now - scheduled > std::chrono::milliseconds(100)) {
+                    lagged.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        const auto& shape = shapes[query.shapeId];
+        auto        start = Clock::now();
+        bool        ok    = false;
+        if (shape.kind == recording::ShapeKind::Prepared) {
+            MYSQL_STMT*& stmt = statements[query.shapeId];
+            if (!stmt) {
+                stmt = mysql_stmt_init(conn);
+                if (stmt && mysql_stmt_prepare(stmt, shape.text.data(), static_cast<unsigned long>(shape.text.size()))) {
+                    mysql_stmt_close(stmt);
+                    stmt = nullptr;
+                }
+            }
+            ok = stmt && executePrepared(stmt, query.params);
+        } else {
+            ok = executeText(conn, buildSql(shape.text, query.params));
+        }
+        auto elapsed = Clock::now() - start;
+
+        metrics.record(recorded, std::chrono::microseconds(query.durationUs));
+        metrics.record(replayed, elapsed);
+
+        auto  us    = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        auto& stats = lane.shapes[query.shapeId];
+        stats.count++;
+        stats.recordedUs += query.durationUs;
+        stats.replayedUs += us;
+        stats.maxUs       = std::max(stats.maxUs, us);
+        // 录制时就失败的语句重放失败不计入错误
+        if (!ok && !query.failed) {
+            stats.errors++;
+            lane.errors++;
+        }
+    }
+
+    for (auto& [id, stmt] : statements) {
+        if (stmt) {
+            mysql_stmt_close(stmt);
+        }
+    }
+    mysql_close(conn);
+    mysql_thread_end();
+}
+
+HistogramSnapshot findHistogram(std::string_view name) {
+    for (auto& h : Metrics::getInstance().histograms()) {
+        if (h.name == name) {
+            return std::move(h);
+        }
+    }
+    return {};
+}
+
+void printLatency(std::string_view label, std::string_view histogram) {
+    auto latency = findHistogram(histogram);
+    std::printf(
+        "  %-8s p50 %8.3f ms  p95 %8.3f ms  p99 %8.3f ms  max %8.3f ms\n",
+        std::string(label).c_str(),
+        latency.percentileMs(0.50),
+        latency.percentileMs(0.95),
+        latency.percentileMs(0.99),
+        static_cast<double>(latency.maxUs) / 1000.0
+    );
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    ReplayOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    // 1. 读取录制文件，按连接分组
+    RecordingReader reader;
+    if (!reader.open(options.file)) {
+        std::fprintf(stderr, "无法读取录制文件（不存在或格式不符）: %s\n", options.file.c_str());
+        return 1;
+    }
+
+    std::map<uint32_t, Lane> lanes;
+    RecordedQuery            query;
+    uint64_t                 total  = 0;
+    uint64_t                 spanUs = 0;
+    while (reader.next(query)) {
+        spanUs = std::max(spanUs, query.startUs + query.durationUs);
+        lanes[query.lane].queries.push_back(query);
+        total++;
+    }
+    if (reader.truncated()) {
+        std::printf("注意：录制文件末尾有不完整的记录（录制时进程退出？），已忽略\n");
+    }
+    for (auto& [id, lane] : lanes) {
+        std::stable_sort(lane.queries.begin(), lane.queries.end(), [](const auto& a, const auto& b) {
+            return a.startUs < b.startUs;
+        });
+    }
+
+    // 2. 连接测试数据库并按当前代码建表
+    ll::mod::NativeMod::current()->setModDir(std::filesystem::absolute(options.dir));
+    bool hadConfig = std::filesystem::exists(std::filesystem::path(options.dir) / "config" / "config.json");
+    if (!Config::getInstance().load()) {
+        return 1;
+    }
+    if (!hadConfig) {
+        std::printf("已在 %s 写入默认配置，请填写测试数据库的连接参数后重新运行\n", options.dir.c_str());
+        return 1;
+    }
+
+    const auto& config = Config::getInstance().getDatabaseConfig();
+    AsyncLog::getInstance().start();
+
+    auto& db = Database::getInstance();
+    if (!db.connect() || !db.initTables()) {
+        AsyncLog::getInstance().stop();
+        return 1;
+    }
+    db.disconnect();
+
+    std::string speed = options.speed > 0 ? std::format("{}x", options.speed) : "不等待";
+    std::printf(
+        "录制: %llu 条语句，%zu 种形态，%zu 个连接，时长 %.1f 秒；重放速度 %s\n",
+        static_cast<unsigned long long>(total),
+        reader.shapes().size(),
+        lanes.size(),
+        static_cast<double>(spanUs) / 1e6,
+        speed.c_str()
+    );
+
+    // 3. 每个录制连接一个线程重放
+    std::atomic<uint64_t>    lagged{0};
+    std::vector<std::thread> threads;
+    auto                     replayStart = Clock::now();
+    for (auto& [id, lane] : lanes) {
+        threads.emplace_back([&, lanePtr = &lane] {
+            replayLane(*lanePtr, reader.shapes(), config, options, replayStart, lagged);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - replayStart).count();
+
+    // 4. 汇总
+    std::vector<ShapeStats> shapes(reader.shapes().size());
+    uint64_t                errors = 0;
+    for (const auto& [id, lane] : lanes) {
+        errors += lane.errors;
+        for (size_t i = 0; i < lane.shapes.size(); i++) {
+            shapes[i].count      += lane.shapes[i].count;
+            shapes[i].errors     += lane.shapes[i].errors;
+            shapes[i].recordedUs += lane.shapes[i].recordedUs;
+            shapes[i].replayedUs += lane.shapes[i].replayedUs;
+            shapes[i].maxUs       = std::max(shapes[i].maxUs, lane.shapes[i].maxUs);
+        }
+    }
+
+    std::printf(
+        "重放: %.1f 秒，%.1f 条/秒，错误 %llu，落后计划超过 100ms 的语句 %llu\n",
+        seconds,
+        seconds > 0 ? static_cast<double>(total) / seconds : 0.0,
+        static_cast<unsigned long long>(errors),
+        static_cast<unsigned long long>(lagged.load())
+    );
+    printLatency("录制", "replay.recorded");
+    printLatency("重放", "replay.replayed");
+    if (options.speed > 0) {
+        printLatency("落后", "replay.lag");
+    }
+
+    std::vector<size_t> order(shapes.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return shapes[a].replayedUs > shapes[b].replayedUs;
+    });
+
+    std::printf("累计耗时最高的语句形态（平均耗时：录制 -> 重放）\n");
+    for (size_t i = 0; i < order.size() && i < static_cast<size_t>(options.top); i++) {
+        const auto& stats = shapes[order[i]];
+        if (stats.count == 0) {
+            break;
+        }
+        std::string text = reader.shapes()[order[i]].text;
+        if (text.size() > 100) {
+            text = text.substr(0, 97) + "...";
+        }
+        std::printf(
+            "  %7llu 次  %8.3f -> %8.3f ms  最大 %8.3f ms  错误 %llu  %s\n",
+            static_cast<unsigned long long>(stats.count),
+            static_cast<double>(stats.recordedUs) / stats.count / 1000.0,
+            static_cast<double>(stats.replayedUs) / stats.count / 1000.0,
+            static_cast<double>(stats.maxUs) / 1000.0,
+            static_cast<unsigned long long>(stats.errors),
+            text.c_str()
+        );
+    }
+
+    AsyncLog::getInstance().stop();
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,639 @@
+// 跨服传送模拟：在一个进程内运行 N 个“服务器”（各自一个主线程和一份本地玩家数据），共用一个本地 MySQL，
+// 以指定的速率让合成玩家在服务器之间跳转，测量每次跳转的延迟，并检查物品是否丢失或重复，找出每秒跳转数的实际上限。
+//
+// 用法: bdsmysql-transfersim [--dir 目录] [--servers N] [--players N] [--rates 50,100,200] [--seconds N]
+//                            [--leave 0-1] [--handoff commit|enqueue] [--nbt 字节数]
+//
+// 每个物品的 NBT 带有唯一编号：玩家每次离开服务器前消耗一件物品、获得一件新物品，模拟器记录玩家应持有的编号。
+// 到达目标服务器并应用数据后，缺少应持有的编号记为丢失，出现已消耗的编号或同一编号出现两次记为重复。
+//
+// 跳转方式：
+//   传送（默认）  - 与 /tpserver 相同：源服务器提交快照并推送给目标服务器后，玩家才进入目标服务器
+//   离线重进      - --leave 指定的比例：源服务器保存队列入队后玩家立即进入目标服务器（从服务器列表直接切换）
+// --handoff enqueue 让传送也不等待提交，用来确认检测器能发现竞争。
+//
+// 与真实部署的差别：所有服务器共用一个后台线程池和保存队列，同一玩家在不同服务器上的保存会被合并而不是互相竞争；
+// 目标服务器的读取使用“服务器/UUID”作为 strand，与源服务器的保存之间没有顺序保证，与真实部署一致
+
+#include "ll/api/mod/NativeMod.h"
+#include "mod/Config.h"
+#include "mod/Database.h"
+#include "mod/DatabaseExecutor.h"
+#include "mod/Log.h"
+#include "mod/Metrics.h"
+#include "mod/PlayerPipeline.h"
+#include "mod/PlayerState.h"
+#include "mod/SaveQueue.h"
+#include "mod/SlowQueryLog.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+using namespace bdsmysql;
+using Clock = std::chrono::steady_clock;
+
+enum class Handoff { Commit, Enqueue };
+
+struct SimOptions {
+    std::string      dir      = "bench-data";
+    int              servers  = 3;
+    int              players  = 200;
+    std::vector<int> rates    = {50, 100, 200, 400};  // 每秒跳转数，逐级测试
+    int              seconds  = 10;                   // 每级持续时间
+    double           leave    = 0.0;                  // 以离线重进方式跳转的比例
+    Handoff          handoff  = Handoff::Commit;
+    int              nbtBytes = 32;  // 每个物品 NBT 中附加的填充长度
+};
+
+// 一级速率的计数（由各服务器主线程累加）
+struct StepCounters {
+    std::atomic<uint64_t> started{0};
+    std::atomic<uint64_t> finished{0};
+    std::atomic<uint64_t> failed{0};  // 保存失败，玩家留在源服务器
+    std::atomic<uint64_t> lost{0};
+    std::atomic<uint64_t> duplicated{0};
+    std::atomic<uint64_t> cacheHits{0};
+    std::atomic<uint64_t> starved{0};  // 到了跳转时间但没有空闲玩家
+};
+
+// 模拟器记录的玩家真值，只由玩家当前所在服务器的主线程访问（跳转时随任务交给目标服务器）
+struct SimPlayer {
+    std::string                  uuid;
+    std::string                  name;
+    int                          server     = 0;
+    uint64_t                     nextSerial = 1;
+    std::set<uint64_t>           held;      // 离开时应持有的物品编号
+    std::unordered_set<uint64_t> consumed;  // 已消耗的物品编号
+    Clock::time_point            hopStart;
+    bool                         firstJoin = true;
+};
+
+class Simulation;
+
+// 一个模拟服务器：主线程按顺序执行投递的任务，保存在本服务器上的玩家数据（上次离开时的状态）
+class SimServer {
+public:
+    SimServer(int index, Simulation& sim) : mIndex(index), mSim(sim) {}
+
+    void start() {
+        mRunning = true;
+        mThread  = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard lock(mMutex);
+            mRunning = false;
+        }
+        mCv.notify_all();
+        if (mThread.joinable()) {
+            mThread.join();
+        }
+    }
+
+    void post(std::function<void()> task) {
+        {
+            std::lock_guard lock(mMutex);
+            mTasks.push_back(std::move(task));
+        }
+        mCv.notify_one();
+    }
+
+    int index() const { return mIndex; }
+
+    // 以下只在本服务器主线程调用
+    void beginHop(SimPlayer& player, SimServer& target, bool viaLeave);
+    void join(SimPlayer& player);
+    void receivePush(const std::string& uuid, PlayerSnapshot snapshot) { mPushed[uuid] = std::move(snapshot); }
+    MemoryPlayerState& localState(const SimPlayer& player);
+
+private:
+    void run() {
+        std::deque<std::function<void()>> batch;
+        std::unique_lock                  lock(mMutex);
+        while (true) {
+            mCv.wait(lock, [this] { return !mRunning || !mTasks.empty(); });
+            if (mTasks.empty()) {
+                break;
+            }
+            batch.swap(mTasks);
+            lock.unlock();
+            for (auto& task : batch) {
+                task();
+            }
+            batch.clear();
+            lock.lock();
+        }
+    }
+
+    void finishJoin(SimPlayer& player, PlayerLoadResult& result);
+
+    int         mIndex;
+    Simulation& mSim;
+
+    std::mutex                        mMutex;
+    std::condition_variable           mCv;
+    std::deque<std::function<void()>> mTasks;
+    bool                              mRunning = false;
+    std::thread                       mThread;
+
+    std::unordered_map<std::string, MemoryPlayerState> mLocal;   // 本服务器上的玩家数据
+    std::unordered_map<std::string, PlayerSnapshot>    mPushed;  // 其它服务器推送的快照（SnapshotCache）
+};
+
+class Simulation {
+public:
+    explicit Simulation(const SimOptions& options) : mOptions(options) {}
+
+    const SimOptions& options() const { return mOptions; }
+    StepCounters&     counters() { return *mCounters; }
+    MetricId          hopMetric() const { return mHopMetric; }
+    MetricId          joinMetric() const { return mJoinMetric; }
+
+    // 重置计数，之后的跳转延迟记录到 sim.hop.<label> 和 sim.join.<label>
+    void beginStep(std::string_view label) {
+        mCounters   = std::make_unique<StepCounters>();
+        mHopMetric  = Metrics::getInstance().histogram(std::format("sim.hop.{}", label));
+        mJoinMetric = Metrics::getInstance().histogram(std::format("sim.join.{}", label));
+    }
+
+    void markIdle(SimPlayer& player) {
+        std::lock_guard lock(mIdleMutex);
+        mIdle.push_back(&player);
+        mIdleCv.notify_all();
+    }
+
+    SimPlayer* takeIdle() {
+        std::lock_guard lock(mIdleMutex);
+        if (mIdle.empty()) {
+            return nullptr;
+        }
+        // 随机取一个，避免总是同一批玩家跳转
+        std::uniform_int_distribution<size_t> pick(0, mIdle.size() - 1);
+        size_t                                index = pick(mRng);
+        std::swap(mIdle[index], mIdle.back());
+        SimPlayer* player = mIdle.back();
+        mIdle.pop_back();
+        return player;
+    }
+
+    bool waitIdle(size_t count, std::chrono::seconds timeout) {
+        std::unique_lock lock(mIdleMutex);
+        return mIdleCv.wait_for(lock, timeout, [&] { return mIdle.size() >= count; });
+    }
+
+    // 只打印前几条，避免刷屏
+    bool shouldReport() { return mReports.fetch_add(1, std::memory_order_relaxed) < 10; }
+
+private:
+    SimOptions                    mOptions;
+    std::unique_ptr<StepCounters> mCounters = std::make_unique<StepCounters>();
+    MetricId                      mHopMetric{};
+    MetricId                      mJoinMetric{};
+
+    std::mutex              mIdleMutex;
+    std::condition_variable mIdleCv;
+    std::vector<SimPlayer*> mIdle;
+    std::mt19937            mRng{12345};
+    std::atomic<int>        mReports{0};
+};
+
+std::string itemNbt(uint64_t serial, int padding) {
+    return std::format("{{sim:{}L,pad:\"{}\"}}", serial, std::string(static_cast<size_t>(padding), 'x'));
+}
+
+// 从 NBT 中取回物品编号，没有编号（空槽位）返回 0
+uint64_t itemSerial(std::string_view nbt) {
+    constexpr std::string_view kKey = "{sim:";
+    if (!nbt.starts_with(kKey)) {
+        return 0;
+    }
+    uint64_t serial = 0;
+    for (size_t i = kKey.size(); i < nbt.size() && nbt[i] >= '0' && nbt[i] <= '9'; i++) {
+        serial = serial * 10 + static_cast<uint64_t>(nbt[i] - '0');
+    }
+    return serial;
+}
+
+// 所有 41 个槽位都写入（空槽位物品类型为空），与服务器中采集的快照一致
+PlayerSnapshot emptySnapshot() {
+    PlayerSnapshot snapshot;
+    auto&          data = snapshot.syncData;
+    data.health         = 20;
+    data.maxHealth      = 20;
+    data.food           = 20;
+    data.foodSaturation = 5;
+    data.expLevel       = 0;
+    data.expPoints      = 0;
+    data.gamemode       = 0;
+    data.x              = 0.0f;
+    data.y              = 64.0f;
+    data.z              = 0.0f;
+    data.dimension      = 0;
+    snapshot.items.reserve(ItemList::kLastEquipmentSlot + 1, 0);
+    for (int slot = 0; slot <= ItemList::kLastEquipmentSlot; slot++) {
+        snapshot.items.add(slot, "", 0, 0, "");
+    }
+    return snapshot;
+}
+
+// 在线时的变化：消耗编号最小的一件物品，在空槽位获得一件新物品
+void play(MemoryPlayerState& state, SimPlayer& player, int padding) {
+    ItemList changes;
+    int      freeSlot = -1;
+    for (const auto& record : state.state().items) {
+        uint64_t serial = itemSerial(state.state().items.nbt(record));
+        if (serial != 0 && !player.held.empty() && serial == *player.held.begin()) {
+            changes.add(record.slot, "", 0, 0, "");
+        } else if (serial == 0 && record.slot <= ItemList::kLastBackpackSlot && freeSlot < 0) {
+            freeSlot = record.slot;
+        }
+    }
+    if (!player.held.empty() && !changes.empty()) {
+        player.consumed.insert(*player.held.begin());
+        player.held.erase(player.held.begin());
+    }
+    if (freeSlot >= 0) {
+        uint64_t serial = player.nextSerial++;
+        changes.add(freeSlot, "minecraft:diamond", 1, 0, itemNbt(serial, padding));
+        player.held.insert(serial);
+    }
+    state.applyInventory(changes);
+}
+
+MemoryPlayerState& SimServer::localState(const SimPlayer& player) {
+    auto it = mLocal.find(player.uuid);
+    if (it == mLocal.end()) {
+        it = mLocal.emplace(player.uuid, MemoryPlayerState(player.uuid, player.name, emptySnapshot())).first;
+    }
+    return it->second;
+}
+
+void SimServer::beginHop(SimPlayer& player, SimServer& target, bool viaLeave) {
+    auto& counters = mSim.counters();
+    auto& state    = localState(player);
+    counters.started.fetch_add(1, std::memory_order_relaxed);
+
+    player.hopStart = Clock::now();
+    play(state, player, mSim.options().nbtBytes);
+
+    SimPlayer* p = &player;
+    if (viaLeave || mSim.options().handoff == Handoff::Enqueue) {
+        // 保存入队后立即进入目标服务器，不等待提交
+        PlayerPipeline::getInstance().save(state, viaLeave ? SaveReason::Leave : SaveReason::Transfer);
+        target.post([&target, p] { target.join(*p); });
+        return;
+    }
+
+    // 与 TransferPipeline 相同：提交成功后推送快照给目标服务器，再回到源服务器主线程交出玩家
+    PlayerPipeline::getInstance().save(state, SaveReason::Transfer, [this, &target, p](const SaveResult& result) {
+        if (result.success) {
+            target.post([&target, uuid = p->uuid, snapshot = result.snapshot]() mutable {
+                target.receivePush(uuid, std::move(snapshot));
+            });
+        }
+        bool success = result.success;
+        post([this, &target, p, success] {
+            if (!success) {
+                mSim.counters().failed.fetch_add(1, std::memory_order_relaxed);
+                mSim.markIdle(*p);  // 留在源服务器
+                return;
+            }
+            target.post([&target, p] { target.join(*p); });
+        });
+    });
+}
+
+void SimServer::join(SimPlayer& player) {
+    std::optional<PlayerSnapshot> cached;
+    if (auto it = mPushed.find(player.uuid); it != mPushed.end()) {
+        cached = std::move(it->second);
+        mPushed.erase(it);
+    }
+
+    SimPlayer* p         = &player;
+    auto       loadStart = Clock::now();
+    DatabaseExecutor::getInstance().post(
+        std::format("server{}/{}", mIndex, player.uuid),
+        [this, p, cached = std::move(cached), loadStart] {
+            auto result = std::make_shared<PlayerLoadResult>(
+                PlayerPipeline::getInstance().load(p->uuid, p->name, "", cached)
+            );
+            post([this, p, result, loadStart] {
+                finishJoin(*p, *result);
+                Metrics::getInstance().record(mSim.joinMetric(), Clock::now() - loadStart);
+            });
+        },
+        JobPriority::Interactive
+    );
+}
+
+void SimServer::finishJoin(SimPlayer& player, PlayerLoadResult& result) {
+    auto& counters = mSim.counters();
+    auto& state    = localState(player);
+    if (player.firstJoin) {
+        // 第一次加入：数据库中没有记录，PlayerPipeline 用本地数据补齐，本地数据就是真值
+        player.firstJoin = false;
+        for (int i = 0; i < 3; i++) {
+            play(state, player, mSim.options().nbtBytes);
+        }
+    }
+    PlayerPipeline::getInstance().apply(state, state, result);
+    player.server = mIndex;
+
+    // 检查应用后的物品与真值是否一致
+    std::unordered_set<uint64_t> seen;
+    uint64_t                     duplicated = 0;
+    for (const auto& record : state.state().items) {
+        uint64_t serial = itemSerial(state.state().items.nbt(record));
+        if (serial == 0) {
+            continue;
+        }
+        if (!seen.insert(serial).second || player.consumed.contains(serial)) {
+            duplicated++;
+        }
+    }
+    uint64_t lost = 0;
+    for (uint64_t serial : player.held) {
+        if (!seen.contains(serial)) {
+            lost++;
+        }
+    }
+
+    if ((lost > 0 || duplicated > 0) && mSim.shouldReport()) {
+        std::printf(
+            "  [竞争] 玩家 %s 进入服务器 %d：丢失 %llu 件，重复 %llu 件（%s）\n",
+            player.name.c_str(),
+            mIndex,
+            static_cast<unsigned long long>(lost),
+            static_cast<unsigned long long>(duplicated),
+            result.fromCache ? "来自推送的快照" : "来自数据库"
+        );
+    }
+    counters.lost.fetch_add(lost, std::memory_order_relaxed);
+    counters.duplicated.fetch_add(duplicated, std::memory_order_relaxed);
+    if (result.fromCache) {
+        counters.cacheHits.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 以本服务器上实际得到的物品作为新的真值，一次竞争不会在之后的每次跳转中重复计数
+    player.held.clear();
+    for (uint64_t serial : seen) {
+        if (!player.consumed.contains(serial)) {
+            player.held.insert(serial);
+        }
+    }
+
+    Metrics::getInstance().record(mSim.hopMetric(), Clock::now() - player.hopStart);
+    counters.finished.fetch_add(1, std::memory_order_relaxed);
+    mSim.markIdle(player);
+}
+
+void printUsage() {
+    std::printf(
+        "用法: bdsmysql-transfersim [--dir 目录] [--servers N] [--players N] [--rates 50,100,200] [--seconds N]\n"
+        "                           [--leave 0-1] [--handoff commit|enqueue] [--nbt 字节数]\n"
+    );
+}
+
+std::vector<int> parseRates(std::string_view text) {
+    std::vector<int> rates;
+    while (!text.empty()) {
+        size_t comma = text.find(',');
+        rates.push_back(std::max(std::stoi(std::string(text.substr(0, comma))), 1));
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(comma + 1);
+    }
+    return rates;
+}
+
+bool parseOptions(int argc, char** argv, SimOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "参数 %s 缺少取值\n", argv[i]);
+            return false;
+        }
+
+        std::string value = argv[++i];
+        try {
+            if (arg == "--dir") {
+                options.dir = value;
+            } else if (arg == "--servers") {
+                options.servers = std::max(std::stoi(value), 2);
+            } else if (arg == "--players") {
+                options.players = std::max(std::stoi(value), 1);
+            } else if (arg == "--rates") {
+                options.rates = parseRates(value);
+            } else if (arg == "--seconds") {
+                options.seconds = std::max(std::stoi(value), 1);
+            } else if (arg == "--leave") {
+                options.leave = std::clamp(std::stod(value), 0.0, 1.0);
+            } else if (arg == "--handoff" && (value == "commit" || value == "enqueue")) {
+                options.handoff = value == "commit" ? Handoff::Commit : Handoff::Enqueue;
+            } else if (arg == "--nbt") {
+                options.nbtBytes = std::max(std::stoi(value), 0);
+            } else {
+                std::fprintf(stderr, "未知参数: %s %s\n", argv[i - 1], value.c_str());
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::fprintf(stderr, "参数 %s 的取值无效: %s\n", argv[i - 1], value.c_str());
+            return false;
+        }
+    }
+    return !options.rates.empty();
+}
+
+HistogramSnapshot findHistogram(std::string_view name) {
+    for (auto& h : Metrics::getInstance().histograms()) {
+        if (h.name == name) {
+            return std::move(h);
+        }
+    }
+    return {};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SimOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 2;
+    }
+
+    ll::mod::NativeMod::current()->setModDir(std::filesystem::absolute(options.dir));
+    bool hadConfig = std::filesystem::exists(std::filesystem::path(options.dir) / "config" / "config.json");
+    if (!Config::getInstance().load()) {
+        return 1;
+    }
+    if (!hadConfig) {
+        std::printf("已在 %s 写入默认配置，请填写测试数据库的连接参数后重新运行\n", options.dir.c_str());
+        return 1;
+    }
+
+    const auto& config = Config::getInstance().getDatabaseConfig();
+    AsyncLog::getInstance().start();
+    SlowQueryLog::getInstance().start();
+
+    auto& db = Database::getInstance();
+    if (!db.connect() || !db.initTables()) {
+        SlowQueryLog::getInstance().stop();
+        AsyncLog::getInstance().stop();
+        return 1;
+    }
+    DatabaseExecutor::getInstance().start(std::max(config.poolSize - 1, 1));
+    SaveQueue::getInstance().start();
+
+    std::printf(
+        "服务器 %d，玩家 %d，每级 %d 秒，离线重进比例 %.2f，传送交接: %s，连接池 %d\n",
+        options.servers,
+        options.players,
+        options.seconds,
+        options.leave,
+        options.handoff == Handoff::Commit ? "提交后" : "入队后",
+        config.poolSize
+    );
+
+    Simulation                              sim(options);
+    std::vector<std::unique_ptr<SimServer>> servers;
+    for (int i = 0; i < options.servers; i++) {
+        servers.push_back(std::make_unique<SimServer>(i, sim));
+        servers.back()->start();
+    }
+
+    // 每次运行使用新的 UUID，不受上次运行留在数据库中的数据影响
+    auto runId = static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    sim.beginStep("initial");
+    std::vector<SimPlayer> players(options.players);
+    for (int i = 0; i < options.players; i++) {
+        auto& player  = players[i];
+        player.uuid   = std::format("sim-{:x}-{:06d}", runId % 0xFFFFFFFFull, i);
+        player.name   = std::format("SimPlayer{}", i);
+        player.server = i % options.servers;
+
+        auto& server    = *servers[player.server];
+        player.hopStart = Clock::now();
+        server.post([&server, &player] { server.join(player); });
+    }
+    if (!sim.waitIdle(players.size(), std::chrono::seconds(60))) {
+        std::fprintf(stderr, "玩家初次加入超时\n");
+    }
+
+    std::mt19937                       rng(42);
+    std::bernoulli_distribution        viaLeave(options.leave);
+    std::uniform_int_distribution<int> pickServer(0, options.servers - 2);
+    uint64_t                           totalLost = 0, totalDuplicated = 0;
+
+    std::printf(
+        "%-8s %10s %10s %10s %10s %10s %10s %6s %6s %8s %8s\n",
+        "目标/s",
+        "实际/s",
+        "p50 ms",
+        "p95 ms",
+        "p99 ms",
+        "max ms",
+        "加入p99",
+        "丢失",
+        "重复",
+        "推送命中",
+        "空闲不足"
+    );
+
+    for (int rate : options.rates) {
+        sim.beginStep(std::to_string(rate));
+        auto& counters = sim.counters();
+
+        // 按固定间隔发起跳转，没有空闲玩家时计入“空闲不足”（说明跳转延迟已经限制了速率）
+        auto interval  = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+        auto stepStart = Clock::now();
+        auto stepEnd   = stepStart + std::chrono::seconds(options.seconds);
+        for (auto next = stepStart; next < stepEnd; next += interval) {
+            std::this_thread::sleep_until(next);
+            SimPlayer* player = sim.takeIdle();
+            if (!player) {
+                counters.starved.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            int target = pickServer(rng);
+            if (target >= player->server) {
+                target++;
+            }
+            auto& source = *servers[player->server];
+            auto& dest   = *servers[target];
+            bool  leave  = viaLeave(rng);
+            source.post([&source, &dest, player, leave] { source.beginHop(*player, dest, leave); });
+        }
+
+        // 等待本级发起的跳转全部完成
+        bool   drained = sim.waitIdle(players.size(), std::chrono::seconds(60));
+        double seconds = std::chrono::duration<double>(Clock::now() - stepStart).count();
+
+        auto hop  = findHistogram(std::format("sim.hop.{}", rate));
+        auto join = findHistogram(std::format("sim.join.{}", rate));
+        auto done = counters.finished.load();
+        std::printf(
+            "%-8d %10.1f %10.2f %10.2f %10.2f %10.2f %10.2f %6llu %6llu %7.0f%% %8llu%s\n",
+            rate,
+            static_cast<double>(done) / seconds,
+            hop.percentileMs(0.50),
+            hop.percentileMs(0.95),
+            hop.percentileMs(0.99),
+            static_cast<double>(hop.maxUs) / 1000.0,
+            join.percentileMs(0.99),
+            static_cast<unsigned long long>(counters.lost.load()),
+            static_cast<unsigned long long>(counters.duplicated.load()),
+            done > 0 ? 100.0 * static_cast<double>(counters.cacheHits.load()) / static_cast<double>(done) : 0.0,
+            static_cast<unsigned long long>(counters.starved.load()),
+            drained ? "" : "  (未能在 60 秒内完成)"
+        );
+        if (counters.failed.load() > 0) {
+            std::printf("         保存失败 %llu 次\n", static_cast<unsigned long long>(counters.failed.load()));
+        }
+        totalLost       += counters.lost.load();
+        totalDuplicated += counters.duplicated.load();
+    }
+
+    for (auto& server : servers) {
+        server->stop();
+    }
+    DatabaseExecutor::getInstance().stop();
+    SaveQueue::getInstance().stop();
+    SlowQueryLog::getInstance().stop();
+    db.disconnect();
+    AsyncLog::getInstance().stop();
+
+    if (totalLost > 0 || totalDuplicated > 0) {
+        std::printf(
+            "检测到竞争：共丢失 %llu 件、重复 %llu 件物品\n",
+            static_cast<unsigned long long>(totalLost),
+            static_cast<unsigned long long>(totalDuplicated)
+        );
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+// 基准测试用的 LeviLamina 替身：Config.cpp 包含该头文件，但数据库层不使用其中的接口
@@ -0,0 +1,38 @@
+#pragma once
+
+// 基准测试用的 LeviLamina 替身：只提供数据库层用到的日志接口，输出到 stderr
+
+#include <cstdio>
+#include <format>
+#include <string>
+
+namespace ll::io {
+
+class Logger {
+public:
+    template <class... Args>
+    void trace(std::format_string<Args...> fmt, Args&&... args) {
+        write("TRACE", std::vformat(fmt.get(), std::make_format_args(args...)));
+    }
+    template <class... Args>
+    void debug(std::format_string<Args...> fmt, Args&&... args) {
+        write("DEBUG", std::vformat(fmt.get(), std::make_format_args(args...)));
+    }
+    template <class... Args>
+    void info(std::format_string<Args...> fmt, Args&&... args) {
+        write("INFO", std::vformat(fmt.get(), std::make_format_args(args...)));
+    }
+    template <class... Args>
+    void warn(std::format_string<Args...> fmt, Args&&... args) {
+        write("WARN", std::vformat(fmt.get(), std::make_format_args(args...)));
+    }
+    template <class... Args>
+    void error(std::format_string<Args...> fmt, Args&&... args) {
+        write("ERROR", std::vformat(fmt.get(), std::make_format_args(args...)));
+    }
+
+private:
+    static void write(const char* level, const std::string& text) { std::fprintf(stderr, "%s %s\n", level, text.c_str()); }
+};
+
+} // namespace ll::io
@@ -0,0 +1,30 @@
+#pragma once
+
+// 基准测试用的 LeviLamina 替身：数据库层只通过 NativeMod::current() 取插件目录和日志器。
+// 插件目录由基准测试程序在启动时设置（配置文件、慢查询日志等都写在该目录下）
+
+#include "ll/api/io/Logger.h"
+#include <filesystem>
+#include <memory>
+
+namespace ll::mod {
+
+class NativeMod {
+public:
+    static std::shared_ptr<NativeMod> current() {
+        static auto instance = std::make_shared<NativeMod>();
+        return instance;
+    }
+
+    ll::io::Logger&              getLogger() const { return mLogger; }
+    std::filesystem::path const& getModDir() const { return mModDir; }
+    std::filesystem::path const& getDataDir() const { return mModDir; }
+
+    void setModDir(std::filesystem::path dir) { mModDir = std::move(dir); }
+
+private:
+    mutable ll::io::Logger mLogger;
+    std::filesystem::path  mModDir = ".";
+};
+
+} // namespace ll::mod
@@ -0,0 +1,114 @@
+-- 独立基准测试工程：只编译数据库层和 LeviLamina 替身（shim/），不依赖 LeviLamina，可在 Linux 上构建和运行。
+--   xmake f -P bench -m release
+--   xmake -P bench
+--   xmake run -P bench bdsmysql-dbbench --players 500 --concurrency 16
+--   xmake run -P bench bdsmysql-codecbench --seconds 2
+--   xmake run -P bench bdsmysql-pipelinebench --players 200 --window 16 --alloc 1
+--   xmake run -P bench bdsmysql-transfersim --servers 3 --players 200 --rates 50,100,200,400
+--   xmake run -P bench bdsmysql-replay --file recordings/queries-20260101-120000.bqr --speed 2
+add_rules("mode.debug", "mode.release")
+
+add_requires("mysql")
+add_requires("nlohmann_json")
+add_requires("zlib")
+
+-- 数据库层及其依赖（日志、指标、追踪、慢查询日志、查询录制、事件循环）
+local database_sources = {
+    "../src/mod/Config.cpp",
+    "../src/mod/Database.cpp",
+    "../src/mod/DatabaseEventLoop.cpp",
+    "../src/mod/ItemRecord.cpp",
+    "../src/mod/Log.cpp",
+    "../src/mod/Metrics.cpp",
+    "../src/mod/QueryRecorder.cpp",
+    "../src/mod/SlowQueryLog.cpp",
+    "../src/mod/Tracer.cpp",
+}
+
+target("bdsmysql-dbbench")
+    set_kind("binary")
+    set_languages("c++20")
+    add_packages("mysql", "nlohmann_json")
+    add_includedirs("shim", "../src")
+    add_files("DatabaseBench.cpp")
+    add_files(table.unpack(database_sources))
+    if is_plat("windows") then
+        add_cxflags("/utf-8")
+        add_defines("NOMINMAX")
+        add_syslinks("ws2_32")
+    else
+        add_syslinks("pthread")
+    end
+
+-- 加入/离开流程：数据库层 + 后台线程池、保存队列和 PlayerPipeline，玩家由 MemoryPlayerState 代替；
+-- AllocHooks.cpp 代替插件的 MemoryOperators.cpp，--alloc 1 时按阶段统计分配
+target("bdsmysql-pipelinebench")
+    set_kind("binary")
+    set_languages("c++20")
+    add_packages("mysql", "nlohmann_json")
+    add_includedirs("shim", "../src")
+    add_files("PipelineBench.cpp", "AllocHooks.cpp")
+    add_files(table.unpack(database_sources))
+    add_files(
+        "../src/mod/AllocStats.cpp",
+        "../src/mod/DatabaseExecutor.cpp",
+        "../src/mod/PlayerPipeline.cpp",
+        "../src/mod/PlayerState.cpp",
+        "../src/mod/SaveQueue.cpp"
+    )
+    if is_plat("windows") then
+        add_cxflags("/utf-8")
+        add_defines("NOMINMAX")
+        add_syslinks("ws2_32")
+    else
+        add_syslinks("pthread")
+    end
+
+-- 跨服传送模拟：多个模拟服务器共用一个 MySQL，检查跳转后物品是否丢失或重复
+target("bdsmysql-transfersim")
+    set_kind("binary")
+    set_languages("c++20")
+    add_packages("mysql", "nlohmann_json")
+    add_includedirs("shim", "../src")
+    add_files("TransferSim.cpp")
+    add_files(table.unpack(database_sources))
+    add_files(
+        "../src/mod/AllocStats.cpp",
+        "../src/mod/DatabaseExecutor.cpp",
+        "../src/mod/PlayerPipeline.cpp",
+        "../src/mod/PlayerState.cpp",
+        "../src/mod/SaveQueue.cpp"
+    )
+    if is_plat("windows") then
+        add_cxflags("/utf-8")
+        add_defines("NOMINMAX")
+        add_syslinks("ws2_32")
+    else
+        add_syslinks("pthread")
+    end
+
+-- 查询重放：在本地 MySQL 上重放 /bdsmysql record 录制的语句
+target("bdsmysql-replay")
+    set_kind("binary")
+    set_languages("c++20")
+    add_packages("mysql", "nlohmann_json")
+    add_includedirs("shim", "../src")
+    add_files("QueryReplay.cpp")
+    add_files(table.unpack(database_sources))
+    if is_plat("windows") then
+        add_cxflags("/utf-8")
+        add_defines("NOMINMAX")
+        add_syslinks("ws2_32")
+    else
+        add_syslinks("pthread")
+    end
+
+-- 物品编解码微基准：自带 NBT 树和 SNBT/二进制 NBT 编解码，不依赖插件源码
+target("bdsmysql-codecbench")
+    set_kind("binary")
+    set_languages("c++20")
+    add_packages("zlib")
+    add_files("CodecBench.cpp")
+    if is_plat("windows") then
+        add_cxflags("/utf-8")
+    end
@@ -0,0 +1,91 @@
+#include "mod/AllocStats.h"
+#include "mod/Metrics.h"
+#include <array>
+#include <format>
+#include <mutex>
+
+namespace bdsmysql {
+
+namespace {
+
+constexpr size_t kStageCount = static_cast<size_t>(AllocStage::Count);
+
+constexpr std::array<const char*, kStageCount> kStageNames = {
+    "other",
+    "join.load",
+    "join.apply",
+    "capture",
+    "save.commit",
+};
+
+// 每个阶段独占一个缓存行，避免不同阶段的线程互相争用
+struct alignas(64) StageCells {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> frees{0};
+};
+
+std::array<StageCells, kStageCount> gCells;
+
+thread_local AllocStage tStage = AllocStage::Other;
+
+} // namespace
+
+std::atomic<bool> AllocStats::sEnabled{false};
+
+void AllocStats::enable() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        auto& metrics = Metrics::getInstance();
+        for (size_t i = 0; i < kStageCount; i++) {
+            auto& cells = gCells[i];
+            metrics.gauge(std::format("alloc.{}.count", kStageNames[i]), [&cells] {
+                return static_cast<double>(cells.allocations.load(std::memory_order_relaxed));
+            });
+            metrics.gauge(std::format("alloc.{}.bytes", kStageNames[i]), [&cells] {
+                return static_cast<double>(cells.bytes.load(std::memory_order_relaxed));
+            });
+            metrics.gauge(std::format("alloc.{}.frees", kStageNames[i]), [&cells] {
+                return static_cast<double>(cells.frees.load(std::memory_order_relaxed));
+            });
+        }
+    });
+    sEnabled.store(true, std::memory_order_relaxed);
+}
+
+void AllocStats::record(size_t size) noexcept {
+    auto& cells = gCells[static_cast<size_t>(tStage)];
+    cells.allocations.fetch_add(1, std::memory_order_relaxed);
+    cells.bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void AllocStats::recordRelease() noexcept {
+    gCells[static_cast<size_t>(tStage)].frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+const char* AllocStats::stageName(AllocStage stage) { return kStageNames[static_cast<size_t>(stage)]; }
+
+AllocStageSnapshot AllocStats::snapshot(AllocStage stage) {
+    auto&              cells = gCells[static_cast<size_t>(stage)];
+    AllocStageSnapshot result;
+    result.name        = stageName(stage);
+    result.allocations = cells.allocations.load(std::memory_order_relaxed);
+    result.bytes       = cells.bytes.load(std::memory_order_relaxed);
+    result.frees       = cells.frees.load(std::memory_order_relaxed);
+    return result;
+}
+
+std::vector<AllocStageSnapshot> AllocStats::snapshots() {
+    std::vector<AllocStageSnapshot> result;
+    result.reserve(kStageCount);
+    for (size_t i = 0; i < kStageCount; i++) {
+        result.push_back(snapshot(static_cast<AllocStage>(i)));
+    }
+    return result;
+}
+
+AllocScope::AllocScope(AllocStage stage) : mSaved(tStage) { tStage = stage; }
+
+AllocScope::~AllocScope() { tStage = mSaved; }
+
+} // namespace bdsmysql
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bdsmysql {
+
+// 分配统计的归类：当前线程所处的流程阶段（由 AllocScope 设置）
+enum class AllocStage : uint8_t {
+    Other,       // 不在任何阶段内
+    JoinLoad,    // 加入：后台读取
+    JoinApply,   // 加入：主线程应用
+    Capture,     // 离开/传送：主线程采集快照并入队
+    SaveCommit,  // 后台提交快照（保存队列和加入时的补齐写入）
+    Count
+};
+
+struct AllocStageSnapshot {
+    const char* name        = "";
+    uint64_t    allocations = 0;
+    uint64_t    bytes       = 0;  // 申请的字节数（不扣除释放）
+    uint64_t    frees       = 0;
+};
+
+// 分配统计：插件的 operator new/delete（MemoryOperators.cpp）在每次分配和释放时调用 onAllocate/onRelease，
+// 按当前线程的阶段累加到全局计数器。默认关闭（metrics.allocStats），关闭时每次分配只多一次原子读。
+// 钩子在 operator new 内部调用，不能分配内存
+class AllocStats {
+public:
+    static bool enabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+    // 开启后把各阶段的计数注册为 Metrics 仪表（alloc.<阶段>.count/bytes/frees）
+    static void enable();
+
+    static void onAllocate(size_t size) noexcept {
+        if (enabled()) {
+            record(size);
+        }
+    }
+    static void onRelease() noexcept {
+        if (enabled()) {
+            recordRelease();
+        }
+    }
+
+    static const char*                     stageName(AllocStage stage);
+    static AllocStageSnapshot              snapshot(AllocStage stage);
+    static std::vector<AllocStageSnapshot> snapshots();
+
+private:
+    static void record(size_t size) noexcept;
+    static void recordRelease() noexcept;
+
+    static std::atomic<bool> sEnabled;
+};
+
+// 在作用域内设置当前线程的分配阶段，作用域结束时恢复
+class AllocScope {
+public:
+    explicit AllocScope(AllocStage stage);
+    ~AllocScope();
+
+    AllocScope(const AllocScope&)            = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+private:
+    AllocStage mSaved;
+};
+
+} // namespace bdsmysql
@@ -0,0 +1,260 @@
+#include "mod/BdsPlayerState.h"
+#include "mc/deps/shared_types/legacy/actor/ArmorSlot.h"
+#include "mc/deps/shared_types/legacy/item/EquipmentSlot.h"
+#include "mc/nbt/CompoundTag.h"
+#include "mc/platform/UUID.h"
+#include "mc/server/ServerPlayer.h"
+#include "mc/util/ActorInventoryUtils.h"
+#include "mc/world/actor/player/Inventory.h"
+#include "mc/world/attribute/AttributeInstance.h"
+#include "mc/world/attribute/MutableAttributeWithContext.h"
+#include "mc/world/attribute/SharedAttributes.h"
+#include "mc/world/item/Item.h"
+#include "mc/world/item/ItemStack.h"
+#include "mod/Config.h"
+#include "mod/Log.h"
+#include "mod/Metrics.h"
+#include <algorithm>
+#include <array>
+#include <bitset>
+
+namespace bdsmysql {
+
+std::string BdsPlayerState::uuid() const { return mPlayer.getUuid().asString(); }
+
+std::string BdsPlayerState::name() const { return mPlayer.getRealName(); }
+
+PlayerSnapshot BdsPlayerState::capture() {
+    static const auto kLatency    = Metrics::getInstance().histogram("capture.snapshot");
+    static const auto kNbtLatency = Metrics::getInstance().histogram("capture.nbtSerialize");
+    ScopedTimer       timer(kLatency);
+
+    PlayerSnapshot snapshot;
+    auto&          syncData = snapshot.syncData;
+    syncData.uuid           = mPlayer.getUuid().asString();
+    syncData.serverName     = Config::getInstance().getDatabaseConfig().serverName;
+    syncData.gamemode       = static_cast<int>(mPlayer.getPlayerGameType());
+
+    // 属性数据
+    auto healthAttr    = mPlayer.getAttribute(SharedAttributes::HEALTH());
+    syncData.health    = static_cast<int>(healthAttr.mCurrentValue);
+    syncData.maxHealth = static_cast<int>(healthAttr.mCurrentMaxValue);
+
+    auto hungerAttr = mPlayer.getAttribute(Player::HUNGER());
+    syncData.food   = static_cast<int>(hungerAttr.mCurrentValue);
+
+    auto saturationAttr     = mPlayer.getAttribute(Player::SATURATION());
+    syncData.foodSaturation = static_cast<float>(saturationAttr.mCurrentValue);
+
+    try {
+        auto xpAttr        = mPlayer.getAttribute(Player::EXPERIENCE());
+        syncData.expLevel  = static_cast<int>(xpAttr.mCurrentMaxValue);
+        syncData.expPoints = static_cast<int>(xpAttr.mCurrentValue * 100);
+    } catch (...) {
+        syncData.expLevel  = 0;
+        syncData.expPoints = 0;
+    }
+
+    // 背包数据（槽位 0-35），空槽位也写入，保证覆盖旧数据
+    auto& playerInv      = mPlayer.getInventory();
+    int   inventorySlots = std::min(playerInv.getContainerSize(), 36);
+    snapshot.items.reserve(inventorySlots + 5, 0);
+    auto addItem = [&](int slot, const ItemStack* itemStack) {
+        std::string_view itemType;
+        std::string      nbt;
+        int              count  = 0;
+        int              damage = 0;
+        if (itemStack && !itemStack->isNull()) {
+            if (itemStack->mItem) {
+                itemType = itemStack->mItem->getSerializedName();
+            }
+            count  = static_cast<int>(itemStack->mCount);
+            damage = itemStack->mAuxValue;
+            if (itemStack->mUserData) {
+                ScopedTimer nbtTimer(kNbtLatency);
+                try {
+                    nbt = itemStack->mUserData->toSnbt();
+                } catch (...) {}
+            }
+        }
+        snapshot.items.add(slot, itemType, count, damage, nbt);
+    };
+
+    for (int i = 0; i < inventorySlots; i++) {
+        addItem(i, &playerInv.getItem(i));
+    }
+
+    // 装备数据（槽位 36-40：头盔/胸甲/护腿/靴子/副手）
+    constexpr std::array<SharedTypes::Legacy::EquipmentSlot, 5> equipmentSlots = {
+        SharedTypes::Legacy::EquipmentSlot::Head,
+        SharedTypes::Legacy::EquipmentSlot::Torso,
+        SharedTypes::Legacy::EquipmentSlot::Legs,
+        SharedTypes::Legacy::EquipmentSlot::Feet,
+        SharedTypes::Legacy::EquipmentSlot::Offhand,
+    };
+    for (int i = 0; i < static_cast<int>(equipmentSlots.size()); i++) {
+        addItem(ItemList::kFirstEquipmentSlot + i, ActorInventoryUtils::getItem(mPlayer, equipmentSlots[i], 0));
+    }
+
+    return snapshot;
+}
+
+void BdsPlayerState::applyAttributes(const PlayerSyncData& syncData) {
+    static const auto kLatency = Metrics::getInstance().histogram("apply.attributes");
+    ScopedTimer       timer(kLatency);
+
+    std::string playerName = mPlayer.getRealName();
+    BDS_LOG_DEBUG("\033[33m[数据同步] [{}] 开始设置玩家属性\033[0m", playerName);
+    BDS_LOG_DEBUG("\033[33m[数据同步] [{}] 目标值 - 生命值: {}/{}, 饱食度: {}, 饱和度: {}, 经验等级: {}, 经验点数: {}\033[0m", 
+        playerName, syncData.health, syncData.maxHealth, syncData.food, syncData.foodSaturation, 
+        syncData.expLevel, syncData.expPoints);
+    
+    // 获取属性并记录当前值
+    auto healthAttr = mPlayer.getAttribute(SharedAttributes::HEALTH());
+    auto hungerAttr = mPlayer.getAttribute(Player::HUNGER());
+    auto saturationAttr = mPlayer.getAttribute(Player::SATURATION());
+    auto xpAttr = mPlayer.getAttribute(Player::EXPERIENCE());
+    
+    BDS_LOG_DEBUG("\033[33m[数据同步] [{}] 设置前 - 生命值: {:.1f}/{:.1f}, 饱食度: {:.1f}, 饱和度: {:.1f}, 经验等级: {:.0f}, 经验进度: {:.1f}%\033[0m",
+        playerName, 
+        healthAttr.mCurrentValue, healthAttr.mCurrentMaxValue,
+        hungerAttr.mCurrentValue,
+        saturationAttr.mCurrentValue,
+        xpAttr.mCurrentMaxValue,
+        xpAttr.mCurrentValue * 100.0f);
+    
+    // 设置生命值
+    healthAttr.mCurrentMaxValue = static_cast<float>(syncData.maxHealth);
+    healthAttr.mCurrentValue = static_cast<float>(syncData.health);
+    
+    // 设置饱食度
+    hungerAttr.mCurrentValue = static_cast<float>(syncData.food);
+    
+    // 设置饱和度
+    saturationAttr.mCurrentValue = syncData.foodSaturation;
+    
+    // 设置经验等级和进度
+    xpAttr.mCurrentMaxValue = static_cast<float>(syncData.expLevel);
+    xpAttr.mCurrentValue = static_cast<float>(syncData.expPoints) / 100.0f;
+    
+    BDS_LOG_DEBUG("\033[33m[数据同步] [{}] 设置后 - 生命值: {:.1f}/{:.1f}, 饱食度: {:.1f}, 饱和度: {:.1f}, 经验等级: {:.0f}, 经验进度: {:.1f}%\033[0m",
+        playerName, 
+        healthAttr.mCurrentValue, healthAttr.mCurrentMaxValue,
+        hungerAttr.mCurrentValue,
+        saturationAttr.mCurrentValue,
+        xpAttr.mCurrentMaxValue,
+        xpAttr.mCurrentValue * 100.0f);
+    
+    // 尝试同步到客户端
+    try {
+        auto& serverPlayer = static_cast<ServerPlayer&>(mPlayer);
+        serverPlayer.sendInventory(false);
+        BDS_LOG_DEBUG("\033[32m[数据同步] [{}] 已调用 sendInventory() 同步到客户端\033[0m", playerName);
+    } catch (const std::exception& e) {
+        BDS_LOG_WARN("\033[33m[数据同步] [{}] sendInventory() 调用失败: {}\033[0m", playerName, e.what());
+    }
+    
+    BDS_LOG_DEBUG("\033[32m[数据同步] [{}] 属性设置和同步完成\033[0m", playerName);
+}
+
+void BdsPlayerState::applyInventory(const ItemList& items) {
+    // 分别统计 ItemStack 构造和 NBT 解析，定位加入时主线程的耗时
+    static const auto kLatency      = Metrics::getInstance().histogram("apply.inventory");
+    static const auto kStackLatency = Metrics::getInstance().histogram("apply.itemStack");
+    static const auto kNbtLatency   = Metrics::getInstance().histogram("apply.nbtParse");
+    ScopedTimer       timer(kLatency);
+
+    auto& serverPlayer = static_cast<ServerPlayer&>(mPlayer);
+    auto& playerInv    = mPlayer.getInventory();
+
+    // 背包（槽位 0-35）和装备（槽位 36-40）在同一个列表中，按槽位直接覆盖
+    int            backpackCount = 0;
+    int            armorCount    = 0;
+    std::bitset<5> armorSlotsToSync;
+
+    for (const auto& item : items) {
+        std::string_view itemType  = item.itemType();
+        bool             equipment = item.slot >= ItemList::kFirstEquipmentSlot;
+        ItemStack        stack;
+
+        // 如果物品类型为空，说明是空槽位
+        if (!item.empty()) {
+            {
+                ScopedTimer stackTimer(kStackLatency);
+                stack = ItemStack(itemType, item.count, item.damage);
+            }
+
+            // 应用 NBT 数据（包括附魔）
+            std::string_view nbt = items.nbt(item);
+            if (!nbt.empty()) {
+                ScopedTimer nbtTimer(kNbtLatency);
+                try {
+                    auto nbtResult = CompoundTag::fromSnbt(nbt);
+                    if (nbtResult) {
+                        stack.mUserData = std::make_unique<CompoundTag>(std::move(*nbtResult));
+                        if (equipment) {
+                            BDS_LOG_DEBUG("\033[33m[装备同步] 已应用物品 {} (槽位 {}) 的 NBT 数据\033[0m", itemType, item.slot);
+                        }
+                    }
+                } catch (const std::exception& e) {
+                    BDS_LOG_WARN(
+                        "\033[33m[{}] 应用物品 {} (槽位 {}) 的 NBT 数据失败: {}\033[0m",
+                        equipment ? "装备同步" : "背包同步",
+                        itemType,
+                        item.slot,
+                        e.what()
+                    );
+                }
+            }
+        }
+
+        if (!equipment) {
+            playerInv.setItem(item.slot, stack);
+            if (!item.empty()) backpackCount++;
+            continue;
+        }
+
+        // 设置装备和副手（36-40）
+        std::string_view shown = item.empty() ? std::string_view("(空)") : itemType;
+        if (item.slot == 36) {
+            // 头盔
+            serverPlayer.setArmor(SharedTypes::Legacy::ArmorSlot::Head, stack);
+            armorSlotsToSync.set(0);
+            BDS_LOG_DEBUG("\033[33m[装备同步] 已设置头盔槽位: {}\033[0m", shown);
+        } else if (item.slot == 37) {
+            // 胸甲
+            serverPlayer.setArmor(SharedTypes::Legacy::ArmorSlot::Torso, stack);
+            armorSlotsToSync.set(1);
+            BDS_LOG_DEBUG("\033[33m[装备同步] 已设置胸甲槽位: {}\033[0m", shown);
+        } else if (item.slot == 38) {
+            // 护腿
+            serverPlayer.setArmor(SharedTypes::Legacy::ArmorSlot::Legs, stack);
+            armorSlotsToSync.set(2);
+            BDS_LOG_DEBUG("\033[33m[装备同步] 已设置护腿槽位: {}\033[0m", shown);
+        } else if (item.slot == 39) {
+            // 靴子
+            serverPlayer.setArmor(SharedTypes::Legacy::ArmorSlot::Feet, stack);
+            armorSlotsToSync.set(3);
+            BDS_LOG_DEBUG("\033[33m[装备同步] 已设置靴子槽位: {}\033[0m", shown);
+        } else if (item.slot == 40) {
+            // 副手
+            serverPlayer.setOffhandSlot(stack);
+            BDS_LOG_DEBUG("\033[33m[装备同步] 已设置副手槽位: {}\033[0m", shown);
+        } else {
+            continue;
+        }
+        if (!item.empty()) armorCount++;
+    }
+
+    BDS_LOG_INFO("\033[32m[背包同步] 已应用 {} 个背包物品\033[0m", backpackCount);
+
+    // 同步装备到客户端
+    if (armorSlotsToSync.any()) {
+        serverPlayer.sendArmor(armorSlotsToSync);
+    }
+    serverPlayer.sendInventory(false);
+
+    BDS_LOG_INFO("\033[32m[装备同步] 已应用 {} 个装备\033[0m", armorCount);
+}
+
+} // namespace bdsmysql
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "mc/world/actor/player/Player.h"
+#include "mod/PlayerState.h"
+
+namespace bdsmysql {
+
+// 游戏中的玩家：通过属性、背包和装备接口读写，只能在主线程使用
+class BdsPlayerState : public PlayerStateSource, public PlayerStateSink {
+public:
+    explicit BdsPlayerState(Player& player) : mPlayer(player) {}
+
+    std::string    uuid() const override;
+    std::string    name() const override;
+    PlayerSnapshot capture() override;
+
+    void applyAttributes(const PlayerSyncData& syncData) override;
+    void applyInventory(const ItemList& items) override;
+
+private:
+    Player& mPlayer;
+};
+
+} // namespace bdsmysql
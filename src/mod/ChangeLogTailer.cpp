@@ -0,0 +1,125 @@
+#include "mod/ChangeLogTailer.h"
+#include "ll/api/io/Logger.h"
+#include "ll/api/mod/NativeMod.h"
+#include "mod/Config.h"
+#include "mod/Database.h"
+#include "mod/Log.h"
+#include "mod/SnapshotCache.h"
+#include <mysql.h>
+#include <algorithm>
+#include <vector>
+
+namespace bdsmysql {
+
+ChangeLogTailer& ChangeLogTailer::getInstance() {
+    static ChangeLogTailer instance;
+    return instance;
+}
+
+bool ChangeLogTailer::start() {
+    const auto& config = Config::getInstance().getDatabaseConfig().changeLog;
+    if (!config.enabled) {
+        return true;
+    }
+
+    std::lock_guard lock(mMutex);
+    if (mRunning) {
+        return true;
+    }
+
+    // 从当前最大序号开始追踪，不回放历史
+    if (!Database::getInstance().loadChangeLogHead(mCursor)) {
+        return false;
+    }
+    mGapSeq    = 0;
+    mLastPrune = Clock::now();
+    mRunning   = true;
+    mThread    = std::thread([this] { run(); });
+
+    BDS_LOG_INFO("\033[32m[变更日志] 开始追踪，起始序号: {}\033[0m", mCursor);
+    return true;
+}
+
+void ChangeLogTailer::stop() {
+    {
+        std::lock_guard lock(mMutex);
+        if (!mRunning) {
+            return;
+        }
+        mRunning = false;
+    }
+    mCv.notify_all();
+
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+}
+
+void ChangeLogTailer::run() {
+    mysql_thread_init();
+
+    const auto& config   = Config::getInstance().getDatabaseConfig().changeLog;
+    auto        interval = std::chrono::milliseconds(std::max(config.pollIntervalMs, 50));
+
+    std::unique_lock lock(mMutex);
+    while (mRunning) {
+        lock.unlock();
+        poll();
+        lock.lock();
+
+        mCv.wait_for(lock, interval, [this] { return !mRunning; });
+    }
+
+    mysql_thread_end();
+}
+
+void ChangeLogTailer::poll() {
+    const auto& config    = Config::getInstance().getDatabaseConfig().changeLog;
+    auto        pollStart = Clock::now();
+
+    std::vector<ChangeLogEntry> entries;
+    if (!Database::getInstance().loadChangeLog(mCursor, config.batchSize, entries)) {
+        return;
+    }
+
+    auto& cache = SnapshotCache::getInstance();
+    for (const auto& entry : entries) {
+        cache.invalidateBefore(entry.uuid, entry.seq);
+    }
+
+    // 只在序号连续时推进游标；遇到空洞（事务尚未提交）时等待，超时后跳过
+    bool gapPending = false;
+    for (const auto& entry : entries) {
+        if (entry.seq == mCursor + 1) {
+            mCursor = entry.seq;
+            continue;
+        }
+
+        uint64_t missing = mCursor + 1;
+        if (mGapSeq != missing) {
+            mGapSeq   = missing;
+            mGapSince = pollStart;
+        }
+        if (pollStart - mGapSince < std::chrono::milliseconds(config.gapTimeoutMs)) {
+            gapPending = true;
+            break;
+        }
+        mCursor = entry.seq;
+    }
+    if (!gapPending) {
+        mGapSeq = 0;
+    }
+
+    // 已读到轮询开始时的所有已提交写入：之前收到的缓存项均确认为最新。
+    // 等待中的空洞之后可能还有未读到的写入，这时不能确认
+    if (!gapPending && static_cast<int>(entries.size()) < config.batchSize) {
+        cache.markValidated(pollStart);
+    }
+
+    if (pollStart - mLastPrune >= std::chrono::seconds(config.pruneIntervalSeconds)) {
+        mLastPrune = pollStart;
+        Database::getInstance().pruneChangeLog(config.retentionSeconds, 10000);
+    }
+}
+
+} // namespace bdsmysql
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace bdsmysql {
+
+// 变更日志追踪：每个轮询周期执行一次增量查询（seq > 游标），
+// 只失效受影响玩家的缓存项，并定期清理过期日志
+class ChangeLogTailer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static ChangeLogTailer& getInstance();
+
+    bool start();
+    void stop();
+
+    uint64_t getCursor() const { return mCursor; }
+
+private:
+    ChangeLogTailer()  = default;
+    ~ChangeLogTailer() = default;
+
+    ChangeLogTailer(const ChangeLogTailer&)            = delete;
+    ChangeLogTailer& operator=(const ChangeLogTailer&) = delete;
+
+    void run();
+    void poll();
+
+    std::thread             mThread;
+    std::mutex              mMutex;
+    std::condition_variable mCv;
+    bool                    mRunning = false;
+
+    // 以下成员只在追踪线程访问
+    uint64_t          mCursor = 0;  // 已连续处理到的最大序号
+    uint64_t          mGapSeq = 0;  // 正在等待的序号空洞
+    Clock::time_point mGapSince;
+    Clock::time_point mLastPrune;
+};
+
+} // namespace bdsmysql
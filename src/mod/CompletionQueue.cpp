@@ -0,0 +1,175 @@
+#include "mod/CompletionQueue.h"
+#include "ll/api/thread/ServerThreadExecutor.h"
+#include "mod/Config.h"
+#include "mod/Log.h"
+#include "mod/Metrics.h"
+#include "mod/MyMod.h"
+#include "mod/TickUsage.h"
+#include <algorithm>
+
+namespace bdsmysql {
+
+namespace {
+
+constexpr auto kTickInterval = std::chrono::milliseconds(50);
+
+} // namespace
+
+CompletionQueue& CompletionQueue::getInstance() {
+    static CompletionQueue instance;
+    return instance;
+}
+
+CompletionQueue::CompletionQueue() : mHead(&mStub), mTail(&mStub) {}
+
+CompletionQueue::~CompletionQueue() {
+    while (Node* node = pop()) {
+        delete node;
+    }
+}
+
+void CompletionQueue::start() {
+    auto& config = Config::getInstance().getDatabaseConfig().scheduler;
+    mBudget      = std::chrono::microseconds(std::max(config.completionBudgetUs, 100));
+
+    // 积压、累计处理数和超出预算的 tick 数在 /bdsmysql stats 和 metrics.txt 中显示
+    auto& metrics = Metrics::getInstance();
+    metrics.gauge("completionQueue.backlog", [this] {
+        return static_cast<double>(mBacklog.load(std::memory_order_relaxed));
+    });
+    metrics.gauge("completionQueue.drained", [this] {
+        return static_cast<double>(mTotalDrained.load(std::memory_order_relaxed));
+    });
+    metrics.gauge("completionQueue.carriedTicks", [this] {
+        return static_cast<double>(mCarriedTicks.load(std::memory_order_relaxed));
+    });
+
+    if (!mRunning.exchange(true)) {
+        scheduleTick();
+    }
+}
+
+void CompletionQueue::stop() {
+    mRunning = false;
+
+    // 停止前投递的结果全部处理，不受时间预算限制
+    drain(Clock::duration::max());
+}
+
+void CompletionQueue::post(Completion completion) {
+    if (!mRunning) {
+        ll::thread::ServerThreadExecutor::getDefault().execute(std::move(completion));
+        return;
+    }
+
+    auto* node       = new Node;
+    node->completion = std::move(completion);
+    mBacklog.fetch_add(1, std::memory_order_relaxed);
+    push(node);
+}
+
+void CompletionQueue::push(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* prev = mHead.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+CompletionQueue::Node* CompletionQueue::pop() {
+    Node* tail = mTail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &mStub) {
+        if (!next) {
+            return nullptr;  // 队列为空
+        }
+        mTail = next;
+        tail  = next;
+        next  = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        mTail = next;
+        return tail;
+    }
+
+    // tail 是最后一个节点：生产者正在交换 mHead 但尚未链接时，留到下一次处理
+    if (tail != mHead.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    push(&mStub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        mTail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+size_t CompletionQueue::drain(Clock::duration budget) {
+    auto   start   = Clock::now();
+    size_t drained = 0;
+    bool   carried = false;
+
+    while (Node* node = pop()) {
+        mBacklog.fetch_sub(1, std::memory_order_relaxed);
+        try {
+            node->completion();
+        } catch (const std::exception& e) {
+            BDS_LOG_ERROR("\033[31m[主线程] 处理后台结果失败: {}\033[0m", e.what());
+        }
+        delete node;
+        drained++;
+
+        if (Clock::now() - start >= budget) {
+            carried = mBacklog.load(std::memory_order_relaxed) > 0;
+            break;
+        }
+    }
+
+    auto   drainTime = Clock::now() - start;
+    double elapsed   = std::chrono::duration<double, std::milli>(drainTime).count();
+    mStats.lastDrained = drained;
+    mStats.lastDrainMs = elapsed;
+    mStats.maxDrainMs  = std::max(mStats.maxDrainMs, elapsed);
+    mTotalDrained.fetch_add(drained, std::memory_order_relaxed);
+    if (carried) {
+        mCarriedTicks.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 只记录有结果的 tick，空 tick 不稀释分位数
+    if (drained > 0) {
+        static const auto kDrainLatency = Metrics::getInstance().histogram("completionQueue.drain");
+        Metrics::getInstance().record(kDrainLatency, drainTime);
+    }
+    return drained;
+}
+
+CompletionQueueStats CompletionQueue::getStats() const {
+    CompletionQueueStats stats = mStats;
+    stats.backlog              = mBacklog.load(std::memory_order_relaxed);
+    stats.totalDrained         = mTotalDrained.load(std::memory_order_relaxed);
+    stats.carriedTicks         = mCarriedTicks.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void CompletionQueue::scheduleTick() {
+    ll::thread::ServerThreadExecutor::getDefault().executeAfter(
+        [] {
+            auto& queue = CompletionQueue::getInstance();
+            if (!queue.mRunning) {
+                return;
+            }
+            // 处理结果（加入完成后应用数据等）同样占用主线程
+            static const auto kSite = TickUsage::site("CompletionQueue");
+            {
+                StallScope scope(kSite);
+                queue.drain(queue.mBudget);
+            }
+            queue.scheduleTick();
+        },
+        kTickInterval
+    );
+}
+
+} // namespace bdsmysql
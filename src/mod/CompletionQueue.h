@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace bdsmysql {
+
+struct CompletionQueueStats {
+    size_t   lastDrained  = 0;  // 上一个 tick 处理的结果数
+    double   lastDrainMs  = 0;  // 上一个 tick 的处理耗时
+    double   maxDrainMs   = 0;
+    size_t   backlog      = 0;  // 尚未处理的结果数
+    uint64_t totalDrained = 0;
+    uint64_t carriedTicks = 0;  // 超出时间预算、把剩余结果留到下一个 tick 的次数
+};
+
+// 后台线程 -> 主线程的结果队列（无锁多生产者单消费者队列）
+// 后台线程投递结果时只做一次原子交换，不会与主线程争用任何互斥锁；
+// 主线程每个 tick 在时间预算内处理一批，剩余的留到下一个 tick
+class CompletionQueue {
+public:
+    using Completion = std::function<void()>;
+    using Clock      = std::chrono::steady_clock;
+
+    static CompletionQueue& getInstance();
+
+    void start();  // 在主线程调用，开始每 tick 处理
+    void stop();   // 在主线程调用，处理完剩余结果后停止
+
+    // 任意线程调用；队列未运行时回退到 ServerThreadExecutor
+    void post(Completion completion);
+
+    // 主线程调用：在 budget 内处理结果，返回处理数量
+    size_t drain(Clock::duration budget);
+
+    CompletionQueueStats getStats() const;
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        Completion         completion;
+    };
+
+    CompletionQueue();
+    ~CompletionQueue();
+
+    CompletionQueue(const CompletionQueue&)            = delete;
+    CompletionQueue& operator=(const CompletionQueue&) = delete;
+
+    void  push(Node* node);
+    Node* pop();  // 只在主线程调用
+    void  scheduleTick();
+
+    std::atomic<Node*>  mHead;  // 生产者端
+    Node*               mTail;  // 消费者端（只在主线程访问）
+    Node                mStub;
+    std::atomic<size_t> mBacklog{0};
+    std::atomic<bool>   mRunning{false};
+    Clock::duration     mBudget = std::chrono::milliseconds(5);
+
+    // 以下成员只在主线程写入；累计值由仪表在其它线程读取，使用原子变量
+    CompletionQueueStats  mStats;
+    std::atomic<uint64_t> mTotalDrained{0};
+    std::atomic<uint64_t> mCarriedTicks{0};
+};
+
+} // namespace bdsmysql
@@ -2,6 +2,7 @@
 #include "ll/api/mod/NativeMod.h"
 #include "ll/api/io/FileUtils.h"
 #include "ll/api/io/Logger.h"
+#include "mod/Log.h"
 #include <fstream>
 #include <filesystem>
 
@@ -20,14 +21,14 @@ bool Config::load() {
     
     if (std::filesystem::exists(modDir)) {
         mConfigPath = modDir.string();
-        mod->getLogger().info("Loading config from: {}", mConfigPath);
+        BDS_LOG_INFO("Loading config from: {}", mConfigPath);
     } else {
         // 不存在，创建默认配置
         mConfigPath = modDir.string();
         createDefaultConfig();
         save();
-        mod->getLogger().info("Created default config file at: {}", mConfigPath);
-        mod->getLogger().info("\033[33m[配置] 默认服务器名称: {}\033[0m", mDatabaseConfig.serverName);
+        BDS_LOG_INFO("Created default config file at: {}", mConfigPath);
+        BDS_LOG_INFO("\033[33m[配置] 默认服务器名称: {}\033[0m", mDatabaseConfig.serverName);
         return true;
     }
 
@@ -36,12 +37,12 @@ bool Config::load() {
         nlohmann::json j;
         file >> j;
         mDatabaseConfig = j.get<DatabaseConfig>();
-        mod->getLogger().info("Config loaded successfully");
-        mod->getLogger().info("\033[33m[配置] 服务器名称: {}\033[0m", mDatabaseConfig.serverName);
-        mod->getLogger().info("\033[33m[配置] 数据库: {} @ {}:{}\033[0m", mDatabaseConfig.database, mDatabaseConfig.host, mDatabaseConfig.port);
+        BDS_LOG_INFO("Config loaded successfully");
+        BDS_LOG_INFO("\033[33m[配置] 服务器名称: {}\033[0m", mDatabaseConfig.serverName);
+        BDS_LOG_INFO("\033[33m[配置] 数据库: {} @ {}:{}\033[0m", mDatabaseConfig.database, mDatabaseConfig.host, mDatabaseConfig.port);
         return true;
     } catch (const std::exception& e) {
-        mod->getLogger().error("Failed to load config: {}", e.what());
+        BDS_LOG_ERROR("Failed to load config: {}", e.what());
         return false;
     }
 }
@@ -57,8 +58,7 @@ bool Config::save() {
         file << j.dump(4);
         return true;
     } catch (const std::exception& e) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("Failed to save config: {}", e.what());
+        BDS_LOG_ERROR("Failed to save config: {}", e.what());
         return false;
     }
 }
@@ -71,6 +71,8 @@ void Config::createDefaultConfig() {
     mDatabaseConfig.password    = "password";
     mDatabaseConfig.charset     = "utf8mb4";
     mDatabaseConfig.serverName  = "main";  // 默认服务器名称
+    mDatabaseConfig.poolSize          = 4;
+    mDatabaseConfig.transferTimeoutMs = 5000;
 }
 
 } // namespace bdsmysql
\ No newline at end of file
@@ -5,16 +5,198 @@
 
 namespace bdsmysql {
 
+// 服务器间快照推送通道
+struct PeerConfig {
+    bool        enabled         = false;
+    std::string bindHost        = "0.0.0.0";
+    int         port            = 19140;  // 本服务器监听的推送端口
+    std::string token;                    // 各服务器共享的密钥，不匹配的推送会被拒绝
+    int         timeoutMs       = 500;    // 推送连接/收发超时（毫秒）
+    int         cacheTtlSeconds = 60;     // 已接收快照的有效期
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(PeerConfig, enabled, bindHost, port, token, timeoutMs, cacheTtlSeconds)
+};
+
+// 变更日志追踪（跨服务器缓存失效）
+struct ChangeLogConfig {
+    bool enabled              = true;
+    int  pollIntervalMs       = 1000;  // 轮询间隔
+    int  batchSize            = 500;   // 每次最多读取的条目数
+    int  gapTimeoutMs         = 5000;  // 序号空洞（未提交的事务）最长等待时间
+    int  retentionSeconds     = 3600;  // 日志保留时间
+    int  pruneIntervalSeconds = 60;    // 清理间隔
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(
+        ChangeLogConfig,
+        enabled,
+        pollIntervalMs,
+        batchSize,
+        gapTimeoutMs,
+        retentionSeconds,
+        pruneIntervalSeconds
+    )
+};
+
+// 保存队列（离线、传送、关服保存的合并与背压）
+struct SaveQueueConfig {
+    int         capacity       = 256;      // 最多同时排队的玩家数（同一玩家的多次保存合并为一项）
+    std::string policy         = "spill";  // 离线/传送保存在队列已满时的策略: spill / dropOldest（在主线程入队，不等待）
+    int         blockTimeoutMs = 200;      // 关服保存在队列已满时的最长等待时间，超时后写入本地日志
+    int         warnDepth      = 64;       // 队列深度达到该值时输出警告
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(SaveQueueConfig, capacity, policy, blockTimeoutMs, warnDepth)
+};
+
+// 加入准入控制（重启后大量玩家同时重连时限制并发读取）
+struct JoinAdmissionConfig {
+    int minInFlight     = 1;    // 同时进行的加入读取数下限
+    int maxInFlight     = 16;   // 上限
+    int initialInFlight = 4;    // 初始值，之后根据数据库延迟自动调整
+    int targetLatencyMs = 100;  // 单次加入读取的目标耗时，超过则降低并发
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(
+        JoinAdmissionConfig,
+        minInFlight,
+        maxInFlight,
+        initialInFlight,
+        targetLatencyMs
+    )
+};
+
+// 后台任务调度：按优先级类别加权轮转，等待过久的任务优先执行
+struct SchedulerConfig {
+    int interactiveWeight = 8;     // 玩家加入读取
+    int transferWeight    = 4;     // 传送提交
+    int leaveSaveWeight   = 2;     // 离线/关服保存
+    int backgroundWeight  = 1;     // 在线时长更新、日志重放等
+    int starvationMs      = 1000;  // 任务等待超过该时间后不再受权重限制
+
+    int completionBudgetUs = 5000;  // 主线程每 tick 处理后台结果的时间预算（微秒）
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(
+        SchedulerConfig,
+        interactiveWeight,
+        transferWeight,
+        leaveSaveWeight,
+        backgroundWeight,
+        starvationMs,
+        completionBudgetUs
+    )
+};
+
+// 非阻塞查询事件循环：一个 I/O 线程在少量连接上同时进行多个查询
+struct EventLoopConfig {
+    bool enabled        = false;
+    int  connections    = 2;  // 事件循环专用连接数（不占用连接池）
+    int  pollIntervalMs = 2;  // 等待套接字就绪的最长时间，到期后重新检查新提交的查询
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(EventLoopConfig, enabled, connections, pollIntervalMs)
+};
+
+// 指标导出：定期把延迟直方图和计数器写入文本文件（/bdsmysql stats 可随时查看）
+struct MetricsConfig {
+    int         exportIntervalSeconds = 60;             // 写入间隔，0 表示不写入文件
+    std::string exportFile            = "metrics.txt";  // 相对插件目录
+    bool        allocStats            = false;          // 按加入/离开阶段统计内存分配次数和字节数（alloc.* 仪表）
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(MetricsConfig, exportIntervalSeconds, exportFile, allocStats)
+};
+
+// 主线程耗时归因：事件监听器、命令和每 tick 任务占用主线程的时间
+struct TickUsageConfig {
+    int slowEventUs   = 5000;  // 单次占用超过该值（微秒）时输出各阶段耗时
+    int windowSeconds = 10;    // 每 tick 占用时间的滚动统计窗口（最长 59 秒）
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(TickUsageConfig, slowEventUs, windowSeconds)
+};
+
+// 操作追踪：按玩家记录数据库调用、序列化和应用的时间线，导出为 Chrome trace 格式
+struct TraceConfig {
+    bool enabled      = false;  // 启动时开启（也可用 /bdsmysql trace on 临时开启）
+    int  bufferEvents = 65536;  // 环形缓冲区事件数，写满后覆盖最旧的事件
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(TraceConfig, enabled, bufferEvents)
+};
+
+// 慢查询日志：超过阈值的语句写入按大小轮转的日志，新出现的语句形态执行一次 EXPLAIN
+struct SlowQueryConfig {
+    int         thresholdMs = 200;                     // 语句耗时超过该值（毫秒）时记录，0 表示关闭
+    bool        explain     = true;                    // 新形态的 SELECT/UPDATE/DELETE 自动执行 EXPLAIN
+    std::string logFile     = "logs/slow-query.log";  // 相对插件目录
+    int         maxFileKB   = 4096;                    // 单个日志文件上限（KB），超过后轮转
+    int         maxFiles    = 3;                       // 保留的日志文件数（含当前文件）
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(SlowQueryConfig, thresholdMs, explain, logFile, maxFileKB, maxFiles)
+};
+
+// 插件日志：运行时级别、每个调用点的限流和异步输出队列
+struct LogConfig {
+    std::string level         = "info";  // trace / debug / info / warn / error
+    int         perSiteLimit  = 20;      // 同一调用点每秒最多输出的条数，0 表示不限
+    int         queueCapacity = 8192;    // 异步队列容量，写满后丢弃新日志
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(LogConfig, level, perSiteLimit, queueCapacity)
+};
+
+// 查询录制：Database 执行的语句形态、参数和耗时写入二进制录制文件，用 bdsmysql-replay 在本地 MySQL 上重放
+struct RecorderConfig {
+    bool        enabled       = false;         // 启动时开始录制（也可用 /bdsmysql record start 临时开启）
+    bool        anonymize     = true;          // 字符串参数替换为等长的伪随机文本，同一次录制中相同的值对应相同的文本
+    std::string directory     = "recordings";  // 相对插件目录
+    int         maxFileMB     = 256;           // 单个录制文件上限（MB），达到后自动停止录制
+    int         queueCapacity = 65536;         // 待写入的记录数上限，写入线程跟不上时丢弃新记录
+
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(RecorderConfig, enabled, anonymize, directory, maxFileMB, queueCapacity)
+};
+
 struct DatabaseConfig {
     std::string host;
-    int         port;
+    int         port = 3306;
     std::string database;
     std::string username;
     std::string password;
     std::string charset;
     std::string serverName;  // 当前服务器名称，用于数据互通
+    int         poolSize          = 4;     // 连接池大小（主线程 + 后台工作线程）
+    int         transferTimeoutMs = 5000;  // 传送前保存数据的超时时间（毫秒）
+
+    PeerConfig          peer;       // 服务器间快照推送
+    ChangeLogConfig     changeLog;  // 变更日志追踪
+    SaveQueueConfig     saveQueue;  // 保存队列
+    JoinAdmissionConfig admission;  // 加入准入控制
+    SchedulerConfig     scheduler;  // 后台任务调度
+    EventLoopConfig     eventLoop;  // 非阻塞查询事件循环
+    MetricsConfig       metrics;    // 指标导出
+    TickUsageConfig     tickUsage;  // 主线程耗时归因
+    TraceConfig         trace;      // 操作追踪
+    SlowQueryConfig     slowQuery;  // 慢查询日志
+    RecorderConfig      recorder;   // 查询录制
+    LogConfig           log;        // 插件日志
 
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(DatabaseConfig, host, port, database, username, password, charset, serverName)
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(
+        DatabaseConfig,
+        host,
+        port,
+        database,
+        username,
+        password,
+        charset,
+        serverName,
+        poolSize,
+        transferTimeoutMs,
+        peer,
+        changeLog,
+        saveQueue,
+        admission,
+        scheduler,
+        eventLoop,
+        metrics,
+        tickUsage,
+        trace,
+        slowQuery,
+        recorder,
+        log
+    )
 };
 
 class Config {
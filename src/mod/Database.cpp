@@ -1,253 +1,441 @@
 #include "mod/Database.h"
+#include "mod/DatabaseEventLoop.h"
+#include "mod/Log.h"
+#include "mod/Metrics.h"
+#include "mod/PlayerTables.h"
+#include "mod/RowView.h"
+#include "mod/SlowQueryLog.h"
 #include "ll/api/io/Logger.h"
 #include "ll/api/mod/NativeMod.h"
+#include <algorithm>
 #include <sstream>
 #include <format>
+#include <thread>
+#include <utility>
 
 namespace bdsmysql {
 
+namespace {
+
+constexpr unsigned int kErrBadDb       = 1049;  // ER_BAD_DB_ERROR：数据库不存在
+constexpr unsigned int kErrNoSuchTable = 1146;  // ER_NO_SUCH_TABLE
+constexpr unsigned int kErrServerGone  = 2006;  // CR_SERVER_GONE_ERROR
+constexpr unsigned int kErrServerLost  = 2013;  // CR_SERVER_LOST
+
+// initTables 为旧版本创建的表追加的列（MySQL 8 不支持 ADD COLUMN IF NOT EXISTS）
+struct AddedColumn {
+    const char* table;
+    const char* column;
+    const char* definition;
+};
+
+constexpr AddedColumn kAddedColumns[] = {
+    {"player_sync_data", "snapshot_version", "BIGINT UNSIGNED NOT NULL DEFAULT 0"},
+};
+
+constexpr std::string_view kSchemaFingerprintKey = "schema_fingerprint";
+
+// 表结构指纹：所有建表语句和追加列的 FNV-1a 哈希，修改表定义后指纹随之改变
+std::string schemaFingerprint() {
+    uint64_t hash = 14695981039346656037ull;
+    auto     mix  = [&](std::string_view text) {
+        for (unsigned char c : text) {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        hash = (hash ^ 0xFF) * 1099511628211ull;  // 分隔符，避免相邻文本拼接后碰撞
+    };
+
+    mix(schema::kCreateSql<tables::kPlayerData>.view());
+    mix(schema::kCreateSql<tables::kPlayerSyncData>.view());
+    mix(schema::kCreateSql<tables::kPlayerInventory>.view());
+    mix(schema::kCreateSql<tables::kPlayerBackpack>.view());
+    mix(schema::kCreateSql<tables::kPlayerEquipment>.view());
+    mix(schema::kCreateSql<tables::kPlayerChangeLog>.view());
+    mix(schema::kCreateSql<tables::kSchemaMeta>.view());
+    for (const auto& added : kAddedColumns) {
+        mix(added.table);
+        mix(added.column);
+        mix(added.definition);
+    }
+    return std::format("{:016x}", hash);
+}
+
+// 投影查询列由表定义生成；坐标和维度不再读取
+void decodeSyncData(const RowView& row, PlayerSyncData& data) {
+    schema::decodeRow<tables::kPlayerSyncData>(row, data);
+    data.x         = 0;
+    data.y         = 64;
+    data.z         = 0;
+    data.dimension = 0;
+}
+
+// 执行查询并取回完整结果集
+bool queryRows(MYSQL* conn, const std::string& query, OwnedResult& rows, const char* what) {
+    SlowQueryProbe probe(conn, query);
+    if (mysql_query(conn, query.c_str())) {
+        BDS_LOG_ERROR("\033[31m[数据库] {}失败！错误: {}\033[0m", what, mysql_error(conn));
+        return false;
+    }
+
+    MYSQL_RES* result = mysql_store_result(conn);
+    if (!result) {
+        return false;
+    }
+    rows = OwnedResult(result);
+    return true;
+}
+
+// 物品行中 NBT 的总长度（各物品表的列相同），用于一次性预留 ItemList。
+// 只取 NBT 列的长度，不解码整行
+size_t itemNbtBytes(const OwnedResult& rows) {
+    constexpr unsigned int kNbtColumn = schema::selectIndex<tables::kPlayerBackpack>("nbt");
+
+    size_t bytes = 0;
+    for (const auto& row : rows) {
+        bytes += row.text(kNbtColumn).size();
+    }
+    return bytes;
+}
+
+template <const auto& Table>
+void appendItemRows(const OwnedResult& rows, ItemList& items) {
+    tables::ItemColumns columns;
+    for (const auto& row : rows) {
+        schema::decodeRow<Table>(row, columns);
+        items.add(columns.slot, columns.itemType, columns.count, columns.damage, columns.nbt);
+    }
+}
+
+std::string selectSyncDataQuery(const std::string& uuid) {
+    return std::string(schema::kSelectSql<tables::kPlayerSyncData>.view()) + " WHERE `uuid` = '" + uuid + "'";
+}
+
+// 读取快照的属性查询：在投影列之后附加快照版本号
+std::string selectSnapshotSyncQuery(const std::string& uuid) {
+    return std::format(
+        "SELECT {}, `snapshot_version` FROM `player_sync_data` WHERE `uuid` = '{}'",
+        schema::kSelectColumns<tables::kPlayerSyncData>.view(),
+        uuid
+    );
+}
+
+template <const auto& Table>
+std::string selectItemsQuery(const std::string& uuid) {
+    return std::string(schema::kSelectSql<Table>.view()) + " WHERE `uuid` = '" + uuid + "' ORDER BY `slot`";
+}
+
+// 解码快照的三个结果集：背包和装备都取回后一次性预留，整个物品列表只分配一次
+void decodeSnapshot(const OwnedResult& sync, const OwnedResult& backpack, const OwnedResult& equipment, SnapshotLoad& load) {
+    constexpr auto versionColumn = static_cast<unsigned int>(tables::kPlayerSyncData.count(schema::Select));
+
+    auto& snapshot = load.snapshot;
+    if (!sync.empty()) {
+        const auto& row = sync.front();
+        decodeSyncData(row, snapshot.syncData);
+        snapshot.version = row.number<uint64_t>(versionColumn);
+        load.hasSyncData = true;
+    }
+    snapshot.items.reserve(backpack.size() + equipment.size(), itemNbtBytes(backpack) + itemNbtBytes(equipment));
+    appendItemRows<tables::kPlayerBackpack>(backpack, snapshot.items);
+    appendItemRows<tables::kPlayerEquipment>(equipment, snapshot.items);
+}
+
+} // namespace
+
 Database& Database::getInstance() {
     static Database instance;
     return instance;
 }
 
 bool Database::connect() {
+    static const auto kLatency = Metrics::getInstance().histogram("db.connect");
+    ScopedTimer       timer(kLatency);
+
     if (mConnected) {
         return true;
     }
 
-    mConnection = mysql_init(nullptr);
-    if (!mConnection) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("Failed to initialize MySQL connection");
+    // 直接连接到配置的数据库，只有数据库不存在时才创建：正常启动只需要一次握手
+    unsigned int error = 0;
+    MYSQL*       first = openConnection(mConfig.database.c_str(), CLIENT_MULTI_STATEMENTS, &error);
+    if (!first && error == kErrBadDb) {
+        first = createDatabase();
+    }
+    if (!first) {
         return false;
     }
 
-    bool reconnect = true;
-    mysql_options(mConnection, MYSQL_OPT_RECONNECT, &reconnect);
-
-    auto mod = ll::mod::NativeMod::current();
-    
-    // 先尝试连接到 MySQL 服务器（不指定数据库）
-    if (!mysql_real_connect(
-            mConnection,
-            mConfig.host.c_str(),
-            mConfig.username.c_str(),
-            mConfig.password.c_str(),
-            nullptr,
-            mConfig.port,
-            nullptr,
-            0
-        )) {
-        mod->getLogger().error("\033[31m[数据库] MySQL 服务器连接失败！错误: {}\033[0m", mysql_error(mConnection));
-        mysql_close(mConnection);
-        mConnection = nullptr;
+    // 连接池的其余连接和事件循环的连接（单语句）一起并行建立，启动耗时不随连接数增加
+    int  poolSize  = std::max(mConfig.poolSize, 2);
+    int  loopCount = mConfig.eventLoop.enabled ? std::max(mConfig.eventLoop.connections, 1) : 0;
+    auto flags     = std::vector<unsigned long>(poolSize - 1, CLIENT_MULTI_STATEMENTS);
+    flags.resize(flags.size() + loopCount, 0);
+
+    auto                connections = openConnections(mConfig.database.c_str(), flags);
+    auto                poolEnd     = connections.begin() + (poolSize - 1);
+    std::vector<MYSQL*> pool(connections.begin(), poolEnd);
+    std::vector<MYSQL*> loopConnections(poolEnd, connections.end());
+    pool.push_back(first);
+
+    if (std::ranges::find(pool, nullptr) != pool.end()) {
+        for (auto* conn : connections) {
+            if (conn) {
+                mysql_close(conn);
+            }
+        }
+        mysql_close(first);
         return false;
     }
+    {
+        std::lock_guard lock(mPoolMutex);
+        mIdleConnections = std::move(pool);
+        mPoolSize        = poolSize;
+    }
 
-    // 检查数据库是否存在，不存在则创建
-    std::string checkQuery = "SELECT SCHEMA_NAME FROM INFORMATION_SCHEMA.SCHEMATA WHERE SCHEMA_NAME = '" + mConfig.database + "'";
-    if (mysql_query(mConnection, checkQuery.c_str())) {
-        mod->getLogger().error("\033[31m[数据库] 检查数据库失败！错误: {}\033[0m", mysql_error(mConnection));
-        mysql_close(mConnection);
-        mConnection = nullptr;
-        return false;
+    mConnected = true;
+
+    // 非阻塞查询事件循环使用独立的连接
+    if (loopCount > 0) {
+        std::erase(loopConnections, nullptr);
+        DatabaseEventLoop::getInstance().start(std::move(loopConnections), mConfig.eventLoop.pollIntervalMs, [this] {
+            return openConnection(mConfig.database.c_str(), 0);
+        });
+    }
+
+    BDS_LOG_INFO("\033[1;32m[数据库] ========== MySQL 数据库连接成功！ ==========\033[0m");
+    BDS_LOG_INFO("\033[1;32m[数据库] 数据库: {} @ {}:{} (连接池: {})\033[0m", mConfig.database, mConfig.host, mConfig.port, poolSize);
+    return true;
+}
+
+void Database::disconnect() {
+    if (!mConnected.exchange(false)) {
+        return;
     }
 
-    MYSQL_RES* result = mysql_store_result(mConnection);
-    bool dbExists = (result && mysql_num_rows(result) > 0);
-    if (result) mysql_free_result(result);
+    DatabaseEventLoop::getInstance().stop();
 
-    if (!dbExists) {
-        mod->getLogger().info("\033[33m[数据库] 数据库 '{}' 不存在，正在创建...\033[0m", mConfig.database);
-        std::string createQuery = "CREATE DATABASE `" + mConfig.database + "` CHARACTER SET utf8mb4 COLLATE utf8mb4_unicode_ci";
-        if (mysql_query(mConnection, createQuery.c_str())) {
-            mod->getLogger().error("\033[31m[数据库] 创建数据库失败！错误: {}\033[0m", mysql_error(mConnection));
-            mysql_close(mConnection);
-            mConnection = nullptr;
-            return false;
+    {
+        std::lock_guard lock(mPoolMutex);
+        for (auto* conn : mIdleConnections) {
+            closeStatements(conn);
+            mysql_close(conn);
         }
-        mod->getLogger().info("\033[32m[数据库] 数据库 '{}' 创建成功！\033[0m", mConfig.database);
-    } else {
-        mod->getLogger().info("\033[32m[数据库] 数据库 '{}' 已存在\033[0m", mConfig.database);
+        mIdleConnections.clear();
+        mPoolSize = 0;
     }
+    mPoolCv.notify_all();
 
-    // 关闭连接，然后重新连接到指定数据库
-    mysql_close(mConnection);
-    mConnection = mysql_init(nullptr);
-    if (!mConnection) {
-        mod->getLogger().error("\033[31m[数据库] 重新初始化 MySQL 连接失败！\033[0m");
-        return false;
+    BDS_LOG_INFO("\033[33m[数据库] 已断开 MySQL 数据库连接\033[0m");
+}
+
+MYSQL* Database::openConnection(const char* database, unsigned long flags, unsigned int* errorCode) {
+    MYSQL* conn = mysql_init(nullptr);
+    if (!conn) {
+        BDS_LOG_ERROR("Failed to initialize MySQL connection");
+        return nullptr;
     }
 
+    // 不自动重连：事务中途重连后剩余语句会以自动提交执行，COMMIT 仍然成功，写了一半的快照被当作已提交。
+    // 断开的连接在归还时重新建立（releaseConnection）
+    bool reconnect = false;
+    mysql_options(conn, MYSQL_OPT_RECONNECT, &reconnect);
+
     if (!mysql_real_connect(
-            mConnection,
+            conn,
             mConfig.host.c_str(),
             mConfig.username.c_str(),
             mConfig.password.c_str(),
-            mConfig.database.c_str(),
+            database,
             mConfig.port,
             nullptr,
-            CLIENT_MULTI_STATEMENTS
+            flags
         )) {
-        mod->getLogger().error("\033[31m[数据库] 连接数据库失败！错误: {}\033[0m", mysql_error(mConnection));
-        mysql_close(mConnection);
-        mConnection = nullptr;
-        return false;
+        unsigned int error = mysql_errno(conn);
+        if (errorCode) {
+            *errorCode = error;
+        }
+        if (!errorCode || error != kErrBadDb) {
+            BDS_LOG_ERROR("\033[31m[数据库] 连接数据库失败！错误: {}\033[0m", mysql_error(conn));
+        }
+        mysql_close(conn);
+        return nullptr;
     }
 
-    if (mysql_set_character_set(mConnection, mConfig.charset.c_str())) {
-        mod->getLogger().warn("\033[33m[数据库] 设置字符集失败：{}\033[0m", mysql_error(mConnection));
+    if (mysql_set_character_set(conn, mConfig.charset.c_str())) {
+        BDS_LOG_WARN("\033[33m[数据库] 设置字符集失败：{}\033[0m", mysql_error(conn));
     }
 
-    mConnected = true;
-    mod->getLogger().info("\033[1;32m[数据库] ========== MySQL 数据库连接成功！ ==========\033[0m");
-    mod->getLogger().info("\033[1;32m[数据库] 数据库: {} @ {}:{}\033[0m", mConfig.database, mConfig.host, mConfig.port);
-    return true;
+    return conn;
 }
 
-void Database::disconnect() {
+MYSQL* Database::createDatabase() {
+    BDS_LOG_INFO("\033[33m[数据库] 数据库 '{}' 不存在，正在创建...\033[0m", mConfig.database);
+    MYSQL* conn = openConnection(nullptr, CLIENT_MULTI_STATEMENTS);
+    if (!conn) {
+        return nullptr;
+    }
+
+    std::string createQuery = "CREATE DATABASE IF NOT EXISTS `" + mConfig.database
+                            + "` CHARACTER SET utf8mb4 COLLATE utf8mb4_unicode_ci";
+    if (mysql_query(conn, createQuery.c_str()) || mysql_select_db(conn, mConfig.database.c_str())) {
+        BDS_LOG_ERROR("\033[31m[数据库] 创建数据库失败！错误: {}\033[0m", mysql_error(conn));
+        mysql_close(conn);
+        return nullptr;
+    }
+
+    BDS_LOG_INFO("\033[32m[数据库] 数据库 '{}' 创建成功！\033[0m", mConfig.database);
+    return conn;
+}
+
+std::vector<MYSQL*> Database::openConnections(const char* database, const std::vector<unsigned long>& flags) {
+    std::vector<MYSQL*>      connections(flags.size(), nullptr);
+    std::vector<std::thread> threads;
+    threads.reserve(flags.size());
+    for (size_t i = 0; i < flags.size(); i++) {
+        threads.emplace_back([this, &connections, i, database, connFlags = flags[i]] {
+            mysql_thread_init();
+            connections[i] = openConnection(database, connFlags);
+            mysql_thread_end();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return connections;
+}
+
+Database::ConnectionLease Database::acquireConnection() {
+    static const auto kLatency = Metrics::getInstance().histogram("db.acquireConnection");
+    ScopedTimer       timer(kLatency);
+
+    std::unique_lock lock(mPoolMutex);
+    mPoolCv.wait(lock, [this] { return !mConnected || !mIdleConnections.empty(); });
+    if (!mConnected) {
+        return ConnectionLease(*this, nullptr);
+    }
+
+    MYSQL* conn = mIdleConnections.back();
+    mIdleConnections.pop_back();
+    return ConnectionLease(*this, conn);
+}
+
+MYSQL* Database::reopenConnection(MYSQL* conn) {
+    BDS_LOG_WARN("\033[33m[数据库] 连接已断开 ({})，正在重新连接\033[0m", mysql_error(conn));
+    MYSQL* fresh = openConnection(mConfig.database.c_str(), CLIENT_MULTI_STATEMENTS);
+    if (!fresh) {
+        // 重新连接失败：仍放回断开的连接，下次使用失败后再次尝试
+        return conn;
+    }
+    closeStatements(conn);
+    mysql_close(conn);
+    return fresh;
+}
+
+void Database::releaseConnection(MYSQL* conn) {
+    unsigned int error = mysql_errno(conn);
+    if (mConnected && (error == kErrServerGone || error == kErrServerLost)) {
+        conn = reopenConnection(conn);
+    }
+
+    {
+        std::lock_guard lock(mPoolMutex);
+        if (mConnected) {
+            mIdleConnections.push_back(conn);
+            conn = nullptr;
+        }
+    }
+    if (conn) {
+        // 连接池已关闭：归还的连接直接关闭
+        closeStatements(conn);
+        mysql_close(conn);
+        return;
+    }
+    mPoolCv.notify_one();
+}
+
+Database::ConnectionLease::ConnectionLease(ConnectionLease&& other) noexcept
+: mDatabase(other.mDatabase),
+  mConnection(std::exchange(other.mConnection, nullptr)) {}
+
+Database::ConnectionLease::~ConnectionLease() {
     if (mConnection) {
-        mysql_close(mConnection);
-        mConnection = nullptr;
-        mConnected  = false;
-        auto mod    = ll::mod::NativeMod::current();
-        mod->getLogger().info("\033[33m[数据库] 已断开 MySQL 数据库连接\033[0m");
+        mDatabase->releaseConnection(mConnection);
     }
 }
 
 bool Database::initTables() {
+    static const auto kLatency = Metrics::getInstance().histogram("db.initTables");
+    ScopedTimer       timer(kLatency);
+
     if (!mConnected) {
         return false;
     }
 
-    const char* createTableSQL = R"(
-        CREATE TABLE IF NOT EXISTS `player_data` (
-            `id` INT AUTO_INCREMENT PRIMARY KEY,
-            `uuid` VARCHAR(36) NOT NULL UNIQUE,
-            `name` VARCHAR(16) NOT NULL,
-            `xuid` VARCHAR(32) DEFAULT NULL,
-            `join_date` DATETIME NOT NULL,
-            `last_seen` DATETIME NOT NULL,
-            `play_time` INT DEFAULT 0,
-            `is_online` TINYINT(1) DEFAULT 0,
-            INDEX `idx_uuid` (`uuid`),
-            INDEX `idx_name` (`name`)
-        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci
-    )";
-
-    if (mysql_query(mConnection, createTableSQL)) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 创建 player_data 表失败！错误: {}\033[0m", mysql_error(mConnection));
-        return false;
-    }
-
-    // 创建玩家同步数据表（共享数据：所有服务器共享同一份数据）
-    const char* createSyncTableSQL = R"(
-        CREATE TABLE IF NOT EXISTS `player_sync_data` (
-            `id` INT AUTO_INCREMENT PRIMARY KEY,
-            `uuid` VARCHAR(36) NOT NULL UNIQUE,
-            `server_name` VARCHAR(32) DEFAULT NULL,
-            `health` INT DEFAULT 20,
-            `max_health` INT DEFAULT 20,
-            `food` INT DEFAULT 20,
-            `food_saturation` FLOAT DEFAULT 20.0,
-            `exp_level` INT DEFAULT 0,
-            `exp_points` INT DEFAULT 0,
-            `gamemode` INT DEFAULT 0,
-            `x` FLOAT DEFAULT 0,
-            `y` FLOAT DEFAULT 64,
-            `z` FLOAT DEFAULT 0,
-            `dimension` INT DEFAULT 0,
-            `last_sync_time` DATETIME DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
-            INDEX `idx_uuid` (`uuid`)
-        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci
-    )";
-
-    if (mysql_query(mConnection, createSyncTableSQL)) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 创建 player_sync_data 表失败！错误: {}\033[0m", mysql_error(mConnection));
-        return false;
-    }
-
-    // 创建玩家背包数据表（共享数据：所有服务器共享同一份数据）
-    const char* createInventoryTableSQL = R"(
-        CREATE TABLE IF NOT EXISTS `player_inventory` (
-            `id` INT AUTO_INCREMENT PRIMARY KEY,
-            `uuid` VARCHAR(36) NOT NULL,
-            `server_name` VARCHAR(32) DEFAULT NULL,
-            `slot` INT NOT NULL,
-            `item_type` VARCHAR(64) DEFAULT NULL,
-            `count` INT DEFAULT 0,
-            `damage` INT DEFAULT 0,
-            `nbt` TEXT DEFAULT NULL,
-            UNIQUE KEY `unique_slot` (`uuid`, `slot`),
-            INDEX `idx_uuid` (`uuid`)
-        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci
-    )";
-
-    if (mysql_query(mConnection, createInventoryTableSQL)) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 创建 player_inventory 表失败！错误: {}\033[0m", mysql_error(mConnection));
-        return false;
-    }
-
-    // 创建玩家背包数据表（槽位 0-35）
-    const char* createBackpackTableSQL = R"(
-        CREATE TABLE IF NOT EXISTS `player_backpack` (
-            `id` INT AUTO_INCREMENT PRIMARY KEY,
-            `uuid` VARCHAR(36) NOT NULL,
-            `server_name` VARCHAR(32) DEFAULT NULL,
-            `slot` INT NOT NULL,
-            `item_type` VARCHAR(64) DEFAULT NULL,
-            `count` INT DEFAULT 0,
-            `damage` INT DEFAULT 0,
-            `nbt` TEXT DEFAULT NULL,
-            UNIQUE KEY `unique_slot` (`uuid`, `slot`),
-            INDEX `idx_uuid` (`uuid`),
-            CHECK (`slot` >= 0 AND `slot` <= 35)
-        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci
-    )";
-
-    if (mysql_query(mConnection, createBackpackTableSQL)) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 创建 player_backpack 表失败！错误: {}\033[0m", mysql_error(mConnection));
-        return false;
-    }
-
-    // 创建玩家装备数据表（槽位 36-40）
-    const char* createEquipmentTableSQL = R"(
-        CREATE TABLE IF NOT EXISTS `player_equipment` (
-            `id` INT AUTO_INCREMENT PRIMARY KEY,
-            `uuid` VARCHAR(36) NOT NULL,
-            `server_name` VARCHAR(32) DEFAULT NULL,
-            `slot` INT NOT NULL,
-            `item_type` VARCHAR(64) DEFAULT NULL,
-            `count` INT DEFAULT 0,
-            `damage` INT DEFAULT 0,
-            `nbt` TEXT DEFAULT NULL,
-            UNIQUE KEY `unique_slot` (`uuid`, `slot`),
-            INDEX `idx_uuid` (`uuid`),
-            CHECK (`slot` >= 36 AND `slot` <= 40)
-        ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci
-    )";
-
-    if (mysql_query(mConnection, createEquipmentTableSQL)) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 创建 player_equipment 表失败！错误: {}\033[0m", mysql_error(mConnection));
-        return false;
-    }
-
-    auto mod = ll::mod::NativeMod::current();
-    mod->getLogger().info("\033[32m[数据库] 数据表初始化成功！\033[0m");
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
+    // 表结构与上次建表时相同则跳过建表语句，正常启动只需一次查询
+    std::string fingerprint = schemaFingerprint();
+    std::string stored;
+    if (loadSchemaFingerprint(conn, stored) && stored == fingerprint) {
+        BDS_LOG_INFO("\033[32m[数据库] 表结构未变化 (指纹 {})，跳过建表\033[0m", fingerprint);
+        return true;
+    }
+
+    auto createTable = [&](const auto& table, const char* sql) {
+        if (mysql_query(conn, sql)) {
+            BDS_LOG_ERROR("\033[31m[数据库] 创建 {} 表失败！错误: {}\033[0m", table.name, mysql_error(conn));
+            return false;
+        }
+        return true;
+    };
+
+    // 背包、装备、变更日志均为共享数据：所有服务器共享同一份数据
+    bool created = createTable(tables::kPlayerData, schema::kCreateSql<tables::kPlayerData>.c_str())
+                && createTable(tables::kPlayerSyncData, schema::kCreateSql<tables::kPlayerSyncData>.c_str())
+                && createTable(tables::kPlayerInventory, schema::kCreateSql<tables::kPlayerInventory>.c_str())
+                && createTable(tables::kPlayerBackpack, schema::kCreateSql<tables::kPlayerBackpack>.c_str())
+                && createTable(tables::kPlayerEquipment, schema::kCreateSql<tables::kPlayerEquipment>.c_str())
+                && createTable(tables::kPlayerChangeLog, schema::kCreateSql<tables::kPlayerChangeLog>.c_str())
+                && createTable(tables::kSchemaMeta, schema::kCreateSql<tables::kSchemaMeta>.c_str());
+    if (!created) {
+        return false;
+    }
+
+    // 旧版本创建的表缺少后来追加的列
+    for (const auto& added : kAddedColumns) {
+        if (!ensureColumn(conn, added.table, added.column, added.definition)) {
+            return false;
+        }
+    }
+
+    // 建表全部成功后才写入指纹，中途失败时下次启动会重新执行
+    tables::MetaEntry                      entry{kSchemaFingerprintKey, fingerprint};
+    schema::RowBinder<tables::kSchemaMeta> binder;
+    constexpr auto                         upsertSql = schema::kUpsertSql<tables::kSchemaMeta>.view();
+    if (!executeStatement(conn, upsertSql, binder.bind(entry), "保存表结构指纹")) {
+        BDS_LOG_WARN("\033[33m[数据库] 保存表结构指纹失败，下次启动将重新执行建表语句\033[0m");
+    }
+
+    BDS_LOG_INFO("\033[32m[数据库] 数据表初始化成功！(指纹 {})\033[0m", fingerprint);
     return true;
 }
 
 bool Database::savePlayerData(const PlayerData& data) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.savePlayerData");
+    ScopedTimer       timer(kLatency);
+
     if (!mConnected) {
         return false;
     }
 
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
     std::ostringstream query;
     query << "INSERT INTO `player_data` (`uuid`, `name`, `xuid`, `join_date`, `last_seen`, `play_time`, `is_online`) "
           << "VALUES ('" << data.uuid << "', '" << data.name << "', '" << data.xuid << "', NOW(), NOW(), "
@@ -255,9 +443,10 @@ bool Database::savePlayerData(const PlayerData& data) {
           << "ON DUPLICATE KEY UPDATE "
           << "`name` = VALUES(`name`), `xuid` = VALUES(`xuid`)";
 
-    if (mysql_query(mConnection, query.str().c_str())) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 保存玩家数据失败！错误: {}\033[0m", mysql_error(mConnection));
+    std::string    sql = query.str();
+    SlowQueryProbe probe(conn, sql);
+    if (mysql_query(conn, sql.c_str())) {
+        BDS_LOG_ERROR("\033[31m[数据库] 保存玩家数据失败！错误: {}\033[0m", mysql_error(conn));
         return false;
     }
 
@@ -265,10 +454,18 @@ bool Database::savePlayerData(const PlayerData& data) {
 }
 
 bool Database::updatePlayerData(const PlayerData& data) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.updatePlayerData");
+    ScopedTimer       timer(kLatency);
+
     if (!mConnected) {
         return false;
     }
 
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
     std::ostringstream query;
     query << "UPDATE `player_data` SET "
           << "`name` = '" << data.name << "', "
@@ -277,9 +474,10 @@ bool Database::updatePlayerData(const PlayerData& data) {
           << "`is_online` = " << (data.isOnline ? 1 : 0) << " "
           << "WHERE `uuid` = '" << data.uuid << "'";
 
-    if (mysql_query(mConnection, query.str().c_str())) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 更新玩家数据失败！错误: {}\033[0m", mysql_error(mConnection));
+    std::string    sql = query.str();
+    SlowQueryProbe probe(conn, sql);
+    if (mysql_query(conn, sql.c_str())) {
+        BDS_LOG_ERROR("\033[31m[数据库] 更新玩家数据失败！错误: {}\033[0m", mysql_error(conn));
         return false;
     }
 
@@ -287,62 +485,73 @@ bool Database::updatePlayerData(const PlayerData& data) {
 }
 
 bool Database::loadPlayerData(const std::string& uuid, PlayerData& data) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.loadPlayerData");
+    ScopedTimer       timer(kLatency);
+
     if (!mConnected) {
         return false;
     }
 
-    std::string query = "SELECT * FROM `player_data` WHERE `uuid` = '" + uuid + "'";
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
+    std::string query = std::string(schema::kSelectSql<tables::kPlayerData>.view()) + " WHERE `uuid` = '" + uuid + "'";
 
-    if (mysql_query(mConnection, query.c_str())) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 加载玩家数据失败！错误: {}\033[0m", mysql_error(mConnection));
+    SlowQueryProbe probe(conn, query);
+    if (mysql_query(conn, query.c_str())) {
+        BDS_LOG_ERROR("\033[31m[数据库] 加载玩家数据失败！错误: {}\033[0m", mysql_error(conn));
         return false;
     }
 
-    MYSQL_RES* result = mysql_store_result(mConnection);
+    MYSQL_RES* result = mysql_store_result(conn);
     if (!result) {
         return false;
     }
 
-    MYSQL_ROW row = mysql_fetch_row(result);
-    if (!row) {
+    RowCursor cursor(result);
+    RowView   row;
+    if (!cursor.next(row)) {
         mysql_free_result(result);
         return false;
     }
 
-    data.id       = std::stoi(row[0]);
-    data.uuid     = row[1];
-    data.name     = row[2];
-    data.xuid     = row[3] ? row[3] : "";
-    data.joinDate = row[4];
-    data.lastSeen = row[5];
-    data.playTime = std::stoi(row[6]);
-    data.isOnline = std::stoi(row[7]) != 0;
+    schema::decodeRow<tables::kPlayerData>(row, data);
 
     mysql_free_result(result);
     return true;
 }
 
 bool Database::isPlayerExists(const std::string& uuid) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.isPlayerExists");
+    ScopedTimer       timer(kLatency);
+
     if (!mConnected) {
         return false;
     }
 
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
     std::string query = "SELECT COUNT(*) FROM `player_data` WHERE `uuid` = '" + uuid + "'";
 
-    if (mysql_query(mConnection, query.c_str())) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 检查玩家是否存在失败！错误: {}\033[0m", mysql_error(mConnection));
+    SlowQueryProbe probe(conn, query);
+    if (mysql_query(conn, query.c_str())) {
+        BDS_LOG_ERROR("\033[31m[数据库] 检查玩家是否存在失败！错误: {}\033[0m", mysql_error(conn));
         return false;
     }
 
-    MYSQL_RES* result = mysql_store_result(mConnection);
+    MYSQL_RES* result = mysql_store_result(conn);
     if (!result) {
         return false;
     }
 
-    MYSQL_ROW row = mysql_fetch_row(result);
-    int      count = row ? std::stoi(row[0]) : 0;
+    RowCursor cursor(result);
+    RowView   row;
+    int       count = cursor.next(row) ? row.number<int>(0) : 0;
 
     mysql_free_result(result);
     return count > 0;
@@ -350,81 +559,75 @@ bool Database::isPlayerExists(const std::string& uuid) {
 
 // 保存玩家同步数据
 bool Database::savePlayerSyncData(const PlayerSyncData& data) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.savePlayerSyncData");
+    ScopedTimer       timer(kLatency);
+
     if (!mConnected) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 数据库未连接，无法保存同步数据\033[0m");
+        BDS_LOG_ERROR("\033[31m[数据库] 数据库未连接，无法保存同步数据\033[0m");
         return false;
     }
 
-    auto mod = ll::mod::NativeMod::current();
-    mod->getLogger().info("\033[33m[数据库] 准备保存玩家同步数据: UUID={}, 服务器={}\033[0m", data.uuid, data.serverName);
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
 
-    std::ostringstream query;
-    query << "INSERT INTO `player_sync_data` (`uuid`, `server_name`, `health`, `max_health`, `food`, `food_saturation`, "
-          << "`exp_level`, `exp_points`, `gamemode`) "
-          << "VALUES ('" << data.uuid << "', '" << data.serverName << "', " << data.health << ", " << data.maxHealth << ", "
-          << data.food << ", " << data.foodSaturation << ", " << data.expLevel << ", " << data.expPoints << ", "
-          << data.gamemode << ") "
-          << "ON DUPLICATE KEY UPDATE "
-          << "`server_name` = VALUES(`server_name`), "
-          << "`health` = VALUES(`health`), `max_health` = VALUES(`max_health`), "
-          << "`food` = VALUES(`food`), `food_saturation` = VALUES(`food_saturation`), "
-          << "`exp_level` = VALUES(`exp_level`), `exp_points` = VALUES(`exp_points`), "
-          << "`gamemode` = VALUES(`gamemode`)";
+    return savePlayerSyncData(conn, data) && recordChange(conn, data.uuid, "player_sync_data");
+}
 
-    mod->getLogger().info("\033[33m[数据库] SQL查询: {}\033[0m", query.str());
+bool Database::savePlayerSyncData(MYSQL* conn, const PlayerSyncData& data) {
+    BDS_LOG_DEBUG("\033[33m[数据库] 准备保存玩家同步数据: UUID={}, 服务器={}\033[0m", data.uuid, data.serverName);
 
-    if (mysql_query(mConnection, query.str().c_str())) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 保存玩家同步数据失败！错误: {}\033[0m", mysql_error(mConnection));
+    schema::RowBinder<tables::kPlayerSyncData> binder;
+    constexpr auto                             upsertSql = schema::kUpsertSql<tables::kPlayerSyncData>.view();
+    if (!executeStatement(conn, upsertSql, binder.bind(data), "保存玩家同步数据")) {
         return false;
     }
 
-    mod->getLogger().info("\033[32m[数据库] 玩家同步数据保存成功\033[0m");
+    BDS_LOG_DEBUG("\033[32m[数据库] 玩家同步数据保存成功\033[0m");
     return true;
 }
 
 // 加载玩家同步数据（共享数据：不区分服务器）
 bool Database::loadPlayerSyncData(const std::string& uuid, const std::string& serverName, PlayerSyncData& data) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.loadPlayerSyncData");
+    ScopedTimer       timer(kLatency);
+
     if (!mConnected) {
         return false;
     }
 
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
+    return loadPlayerSyncData(conn, uuid, data);
+}
+
+bool Database::loadPlayerSyncData(MYSQL* conn, const std::string& uuid, PlayerSyncData& data) {
     // 不再根据 server_name 过滤，所有服务器共享同一份数据
-    std::string query = "SELECT * FROM `player_sync_data` WHERE `uuid` = '" + uuid + "'";
+    std::string query = selectSyncDataQuery(uuid);
 
-    if (mysql_query(mConnection, query.c_str())) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 加载玩家同步数据失败！错误: {}\033[0m", mysql_error(mConnection));
+    SlowQueryProbe probe(conn, query);
+    if (mysql_query(conn, query.c_str())) {
+        BDS_LOG_ERROR("\033[31m[数据库] 加载玩家同步数据失败！错误: {}\033[0m", mysql_error(conn));
         return false;
     }
 
-    MYSQL_RES* result = mysql_store_result(mConnection);
+    MYSQL_RES* result = mysql_store_result(conn);
     if (!result) {
         return false;
     }
 
-    MYSQL_ROW row = mysql_fetch_row(result);
-    if (!row) {
+    RowCursor cursor(result);
+    RowView   row;
+    if (!cursor.next(row)) {
         mysql_free_result(result);
         return false;
     }
 
-    data.id             = std::stoi(row[0]);
-    data.uuid           = row[1];
-    data.serverName     = row[2];  // 保留服务器名称，但不用于过滤
-    data.health         = std::stoi(row[3]);
-    data.maxHealth      = std::stoi(row[4]);
-    data.food           = std::stoi(row[5]);
-    data.foodSaturation = std::stof(row[6]);
-    data.expLevel       = std::stoi(row[7]);
-    data.expPoints      = std::stoi(row[8]);
-    data.gamemode       = std::stoi(row[9]);
-    data.x              = 0;  // 不再使用坐标
-    data.y              = 64;
-    data.z              = 0;
-    data.dimension      = 0;
-    data.lastSyncTime   = row[10];
+    decodeSyncData(row, data);
 
     mysql_free_result(result);
     return true;
@@ -432,10 +635,18 @@ bool Database::loadPlayerSyncData(const std::string& uuid, const std::string& se
 
 // 更新玩家同步数据（共享数据：不区分服务器）
 bool Database::updatePlayerSyncData(const PlayerSyncData& data) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.updatePlayerSyncData");
+    ScopedTimer       timer(kLatency);
+
     if (!mConnected) {
         return false;
     }
 
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
     std::ostringstream query;
     query << "UPDATE `player_sync_data` SET "
           << "`server_name` = '" << data.serverName << "', "
@@ -448,40 +659,108 @@ bool Database::updatePlayerSyncData(const PlayerSyncData& data) {
           << "`gamemode` = " << data.gamemode << " "
           << "WHERE `uuid` = '" << data.uuid << "'";
 
-    if (mysql_query(mConnection, query.str().c_str())) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 更新玩家同步数据失败！错误: {}\033[0m", mysql_error(mConnection));
+    std::string    sql = query.str();
+    SlowQueryProbe probe(conn, sql);
+    if (mysql_query(conn, sql.c_str())) {
+        BDS_LOG_ERROR("\033[31m[数据库] 更新玩家同步数据失败！错误: {}\033[0m", mysql_error(conn));
         return false;
     }
 
-    return true;
+    return recordChange(conn, data.uuid, "player_sync_data");
 }
 
 // 保存玩家背包数据（共享数据：所有服务器共享同一份数据）
-bool Database::savePlayerInventory(const std::string& uuid, const std::string& serverName, const std::vector<PlayerInventoryItem>& items) {
+bool Database::savePlayerInventory(const std::string& uuid, const std::string& serverName, const ItemList& items) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.savePlayerInventory");
+    ScopedTimer       timer(kLatency);
+
+    if (!mConnected) {
+        return false;
+    }
+
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
+    // 旧表不区分背包和装备，写入全部槽位
+    return saveItemRows<tables::kPlayerInventory>(conn, uuid, serverName, items, 0, ItemList::kLastEquipmentSlot, "背包");
+}
+
+// 加载玩家背包数据（共享数据：不区分服务器）
+bool Database::loadPlayerInventory(const std::string& uuid, const std::string& serverName, ItemList& items) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.loadPlayerInventory");
+    ScopedTimer       timer(kLatency);
+
+    if (!mConnected) {
+        return false;
+    }
+
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
+    OwnedResult rows;
+    if (!queryRows(conn, selectItemsQuery<tables::kPlayerInventory>(uuid), rows, "加载玩家背包数据")) {
+        return false;
+    }
+
+    items.reserve(rows.size(), itemNbtBytes(rows));
+    appendItemRows<tables::kPlayerInventory>(rows, items);
+    return true;
+}
+
+// 保存玩家背包数据（槽位 0-35）
+bool Database::savePlayerBackpack(const std::string& uuid, const std::string& serverName, const ItemList& items) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.savePlayerBackpack");
+    ScopedTimer       timer(kLatency);
+
     if (!mConnected) {
         return false;
     }
 
-    // 先删除该玩家的旧背包数据（不区分服务器）
-    std::string deleteQuery = "DELETE FROM `player_inventory` WHERE `uuid` = '" + uuid + "'";
-    if (mysql_query(mConnection, deleteQuery.c_str())) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 删除旧背包数据失败！错误: {}\033[0m", mysql_error(mConnection));
+    auto conn = acquireConnection();
+    if (!conn) {
         return false;
     }
 
-    // 插入新的背包数据
-    for (const auto& item : items) {
-        std::ostringstream query;
-        query << "INSERT INTO `player_inventory` (`uuid`, `server_name`, `slot`, `item_type`, `count`, `damage`, `nbt`) "
-              << "VALUES ('" << uuid << "', '" << serverName << "', " << item.slot << ", "
-              << "'" << item.itemType << "', " << item.count << ", " << item.damage << ", "
-              << (item.nbt.empty() ? "NULL" : "'" + item.nbt + "'") << ")";
+    return savePlayerBackpack(conn, uuid, serverName, items) && recordChange(conn, uuid, "player_backpack");
+}
+
+bool Database::savePlayerBackpack(MYSQL* conn, const std::string& uuid, const std::string& serverName, const ItemList& items) {
+    return saveItemRows<tables::kPlayerBackpack>(conn, uuid, serverName, items, 0, ItemList::kLastBackpackSlot, "背包");
+}
 
-        if (mysql_query(mConnection, query.str().c_str())) {
-            auto mod = ll::mod::NativeMod::current();
-            mod->getLogger().error("\033[31m[数据库] 保存背包物品失败！错误: {}\033[0m", mysql_error(mConnection));
+// 先删除该玩家的旧数据，再用同一条预处理语句逐个写入 [firstSlot, lastSlot] 内的记录
+template <const auto& Table>
+bool Database::saveItemRows(
+    MYSQL*             conn,
+    const std::string& uuid,
+    const std::string& serverName,
+    const ItemList&    items,
+    int                firstSlot,
+    int                lastSlot,
+    const char*        what
+) {
+    std::string deleteQuery = std::format("DELETE FROM `{}` WHERE `uuid` = '{}'", Table.name, uuid);
+    {
+        SlowQueryProbe probe(conn, deleteQuery);
+        if (mysql_query(conn, deleteQuery.c_str())) {
+            BDS_LOG_ERROR("\033[31m[数据库] 删除旧{}数据失败！错误: {}\033[0m", what, mysql_error(conn));
+            return false;
+        }
+    }
+
+    schema::RowBinder<Table> binder;
+    constexpr auto           upsertSql = schema::kUpsertSql<Table>.view();
+    std::string              failure   = std::format("保存{}物品", what);
+    for (const auto& record : items) {
+        if (record.slot < firstSlot || record.slot > lastSlot) {
+            continue;
+        }
+        tables::ItemColumns columns{record.slot, record.itemType(), record.count, record.damage, items.nbt(record)};
+        if (!executeStatement(conn, upsertSql, binder.bind(columns, {uuid, serverName}), failure.c_str())) {
             return false;
         }
     }
@@ -489,177 +768,551 @@ bool Database::savePlayerInventory(const std::string& uuid, const std::string& s
     return true;
 }
 
-// 加载玩家背包数据（共享数据：不区分服务器）
-bool Database::loadPlayerInventory(const std::string& uuid, const std::string& serverName, std::vector<PlayerInventoryItem>& items) {
+// 加载玩家背包数据（槽位 0-35）
+bool Database::loadPlayerBackpack(const std::string& uuid, const std::string& serverName, ItemList& items) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.loadPlayerBackpack");
+    ScopedTimer       timer(kLatency);
+
     if (!mConnected) {
         return false;
     }
 
-    // 不再根据 server_name 过滤，所有服务器共享同一份数据
-    std::string query = "SELECT `slot`, `item_type`, `count`, `damage`, `nbt` FROM `player_inventory` "
-                       "WHERE `uuid` = '" + uuid + "' ORDER BY `slot`";
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
 
-    if (mysql_query(mConnection, query.c_str())) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 加载玩家背包数据失败！错误: {}\033[0m", mysql_error(mConnection));
+    OwnedResult rows;
+    if (!queryRows(conn, selectItemsQuery<tables::kPlayerBackpack>(uuid), rows, "加载玩家背包数据")) {
         return false;
     }
 
-    MYSQL_RES* result = mysql_store_result(mConnection);
-    if (!result) {
+    items.reserve(rows.size(), itemNbtBytes(rows));
+    appendItemRows<tables::kPlayerBackpack>(rows, items);
+    return true;
+}
+
+// 保存玩家装备数据（槽位 36-40）
+bool Database::savePlayerEquipment(const std::string& uuid, const std::string& serverName, const ItemList& items) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.savePlayerEquipment");
+    ScopedTimer       timer(kLatency);
+
+    if (!mConnected) {
         return false;
     }
 
-    items.clear();
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        PlayerInventoryItem item;
-        item.slot     = std::stoi(row[0]);
-        item.itemType = row[1] ? row[1] : "";
-        item.count    = std::stoi(row[2]);
-        item.damage   = std::stoi(row[3]);
-        item.nbt      = row[4] ? row[4] : "";
-        items.push_back(item);
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
     }
 
-    mysql_free_result(result);
+    return savePlayerEquipment(conn, uuid, serverName, items) && recordChange(conn, uuid, "player_equipment");
+}
+
+bool Database::savePlayerEquipment(MYSQL* conn, const std::string& uuid, const std::string& serverName, const ItemList& items) {
+    return saveItemRows<tables::kPlayerEquipment>(
+        conn,
+        uuid,
+        serverName,
+        items,
+        ItemList::kFirstEquipmentSlot,
+        ItemList::kLastEquipmentSlot,
+        "装备"
+    );
+}
+
+// 加载玩家装备数据（槽位 36-40）
+bool Database::loadPlayerEquipment(const std::string& uuid, const std::string& serverName, ItemList& items) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.loadPlayerEquipment");
+    ScopedTimer       timer(kLatency);
+
+    if (!mConnected) {
+        return false;
+    }
+
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
+    OwnedResult rows;
+    if (!queryRows(conn, selectItemsQuery<tables::kPlayerEquipment>(uuid), rows, "加载玩家装备数据")) {
+        return false;
+    }
+
+    items.reserve(rows.size(), itemNbtBytes(rows));
+    appendItemRows<tables::kPlayerEquipment>(rows, items);
     return true;
 }
 
-// 保存玩家背包数据（槽位 0-35）
-bool Database::savePlayerBackpack(const std::string& uuid, const std::string& serverName, const std::vector<PlayerBackpackItem>& items) {
+// 保存玩家完整快照（属性 + 背包 + 装备），在同一事务中提交
+// 目标服务器要么读到旧数据，要么读到完整的新快照，不会读到写了一半的数据
+bool Database::savePlayerSnapshot(PlayerSnapshot& snapshot, std::optional<uint64_t> expectedVersion, bool* conflict) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.savePlayerSnapshot");
+    ScopedTimer       timer(kLatency);
+
     if (!mConnected) {
         return false;
     }
 
-    // 先删除该玩家的旧背包数据
-    std::string deleteQuery = "DELETE FROM `player_backpack` WHERE `uuid` = '" + uuid + "'";
-    if (mysql_query(mConnection, deleteQuery.c_str())) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 删除旧背包数据失败！错误: {}\033[0m", mysql_error(mConnection));
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
+    if (mysql_query(conn, "START TRANSACTION")) {
+        BDS_LOG_ERROR("\033[31m[数据库] 开启事务失败！错误: {}\033[0m", mysql_error(conn));
         return false;
     }
 
-    // 插入新的背包数据
-    for (const auto& item : items) {
-        std::ostringstream query;
-        query << "INSERT INTO `player_backpack` (`uuid`, `server_name`, `slot`, `item_type`, `count`, `damage`, `nbt`) "
-              << "VALUES ('" << uuid << "', '" << serverName << "', " << item.slot << ", "
-              << "'" << item.itemType << "', " << item.count << ", " << item.damage << ", "
-              << (item.nbt.empty() ? "NULL" : "'" + item.nbt + "'") << ")";
+    const auto& uuid       = snapshot.syncData.uuid;
+    const auto& serverName = snapshot.syncData.serverName;
 
-        if (mysql_query(mConnection, query.str().c_str())) {
-            auto mod = ll::mod::NativeMod::current();
-            mod->getLogger().error("\033[31m[数据库] 保存背包物品失败！错误: {}\033[0m", mysql_error(mConnection));
+    // 条件写入：加锁读取当前版本号，其它服务器在此之后的写入会等待本事务结束
+    if (expectedVersion) {
+        uint64_t current = 0;
+        if (!loadSnapshotVersion(conn, uuid, current, true) && mysql_errno(conn)) {
+            mysql_query(conn, "ROLLBACK");
+            return false;
+        }
+        if (current != *expectedVersion) {
+            BDS_LOG_WARN(
+                "\033[33m[数据库] 玩家 {} 的快照版本已变化 (预期 {}, 当前 {})，放弃写入\033[0m",
+                uuid,
+                *expectedVersion,
+                current
+            );
+            mysql_query(conn, "ROLLBACK");
+            if (conflict) {
+                *conflict = true;
+            }
             return false;
         }
     }
 
+    bool ok = savePlayerSyncData(conn, snapshot.syncData) && savePlayerBackpack(conn, uuid, serverName, snapshot.items)
+           && savePlayerEquipment(conn, uuid, serverName, snapshot.items)
+           && recordChange(conn, uuid, "player_snapshot", &snapshot.changeSeq)
+           && loadSnapshotVersion(conn, uuid, snapshot.version);
+
+    if (!ok || mysql_query(conn, "COMMIT")) {
+        BDS_LOG_ERROR("\033[31m[数据库] 提交玩家快照失败，已回滚！错误: {}\033[0m", mysql_error(conn));
+        mysql_query(conn, "ROLLBACK");
+        return false;
+    }
+
     return true;
 }
 
-// 加载玩家背包数据（槽位 0-35）
-bool Database::loadPlayerBackpack(const std::string& uuid, const std::string& serverName, std::vector<PlayerBackpackItem>& items) {
+// 读取玩家完整快照（版本号、属性、背包、装备）
+bool Database::loadPlayerSnapshot(const std::string& uuid, PlayerSnapshot& snapshot) {
+    SnapshotLoad load;
+    loadPlayerSnapshot(uuid, load);
+    snapshot = std::move(load.snapshot);
+    return load.success && (load.hasSyncData || !snapshot.items.empty());
+}
+
+bool Database::loadPlayerSnapshot(const std::string& uuid, SnapshotLoad& load) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.loadPlayerSnapshot");
+    ScopedTimer       timer(kLatency);
+
+    load.snapshot.syncData.uuid       = uuid;
+    load.snapshot.syncData.serverName = mConfig.serverName;
+
     if (!mConnected) {
         return false;
     }
 
-    std::string query = "SELECT `slot`, `item_type`, `count`, `damage`, `nbt` FROM `player_backpack` "
-                       "WHERE `uuid` = '" + uuid + "' ORDER BY `slot`";
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
+    // 在同一连接的一致性读视图中读取（InnoDB 默认的 REPEATABLE READ），
+    // 并发提交的快照要么全部可见、要么全部不可见，版本号与物品始终对应
+    if (mysql_query(conn, "START TRANSACTION WITH CONSISTENT SNAPSHOT, READ ONLY")) {
+        BDS_LOG_ERROR("\033[31m[数据库] 开启只读事务失败！错误: {}\033[0m", mysql_error(conn));
+        return false;
+    }
+
+    OwnedResult sync;
+    OwnedResult backpack;
+    OwnedResult equipment;
+    bool        ok = queryRows(conn, selectSnapshotSyncQuery(uuid), sync, "加载玩家同步数据")
+             && queryRows(conn, selectItemsQuery<tables::kPlayerBackpack>(uuid), backpack, "加载玩家背包数据")
+             && queryRows(conn, selectItemsQuery<tables::kPlayerEquipment>(uuid), equipment, "加载玩家装备数据");
+    mysql_query(conn, "COMMIT");
+    if (!ok) {
+        return false;
+    }
+
+    decodeSnapshot(sync, backpack, equipment, load);
+    load.success = true;
+    return true;
+}
+
+void Database::queryAsync(std::string sql, QueryCallback callback) {
+    if (DatabaseEventLoop::getInstance().isRunning()) {
+        DatabaseEventLoop::getInstance().submit(std::move(sql), std::move(callback));
+        return;
+    }
+
+    // 未启用事件循环：在当前线程使用连接池中的连接同步执行（事件循环在完成时自行记录耗时）
+    static const auto kLatency = Metrics::getInstance().histogram("db.queryAsync");
+
+    QueryResult result;
+    {
+        ScopedTimer    timer(kLatency);
+        auto           conn = acquireConnection();
+        SlowQueryProbe probe(conn, sql);
+        if (!conn) {
+            result.error = "数据库未连接";
+        } else if (mysql_real_query(conn, sql.c_str(), static_cast<unsigned long>(sql.size()))) {
+            result.error = mysql_error(conn);
+        } else if (MYSQL_RES* res = mysql_store_result(conn)) {
+            result.success = true;
+            result.rows    = OwnedResult(res);
+        } else if (mysql_errno(conn) != 0) {
+            result.error = mysql_error(conn);
+        } else {
+            result.success      = true;
+            result.affectedRows = mysql_affected_rows(conn);
+            result.insertId     = mysql_insert_id(conn);
+        }
+    }
+    callback(result);
+}
+
+void Database::loadPlayerSnapshotAsync(const std::string& uuid, SnapshotCallback callback) {
+    // 未启用事件循环：在当前线程同步读取
+    if (!DatabaseEventLoop::getInstance().isRunning()) {
+        SnapshotLoad load;
+        loadPlayerSnapshot(uuid, load);
+        callback(load);
+        return;
+    }
+
+    // 与同步读取相同：同一连接上的一致性快照，由事件循环依次推进，不占用工作线程
+    std::vector<std::string> statements;
+    statements.reserve(5);
+    statements.emplace_back("START TRANSACTION WITH CONSISTENT SNAPSHOT, READ ONLY");
+    statements.push_back(selectSnapshotSyncQuery(uuid));
+    statements.push_back(selectItemsQuery<tables::kPlayerBackpack>(uuid));
+    statements.push_back(selectItemsQuery<tables::kPlayerEquipment>(uuid));
+    statements.emplace_back("COMMIT");
+
+    auto startTime = Metrics::Clock::now();
+    DatabaseEventLoop::getInstance().submit(
+        std::move(statements),
+        [uuid, serverName = mConfig.serverName, callback = std::move(callback), startTime](
+            std::vector<QueryResult>& results
+        ) {
+            SnapshotLoad load;
+            load.snapshot.syncData.uuid       = uuid;
+            load.snapshot.syncData.serverName = serverName;
+            load.success = std::ranges::all_of(results, [](const QueryResult& result) { return result.success; });
+            if (load.success) {
+                decodeSnapshot(results[1].rows, results[2].rows, results[3].rows, load);
+            }
+
+            static const auto kLatency = Metrics::getInstance().histogram("db.loadPlayerSnapshotAsync");
+            Metrics::getInstance().record(kLatency, Metrics::Clock::now() - startTime);
+
+            callback(load);
+        }
+    );
+}
+
+bool Database::loadSnapshotVersion(const std::string& uuid, uint64_t& version) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.loadSnapshotVersion");
+    ScopedTimer       timer(kLatency);
 
-    if (mysql_query(mConnection, query.c_str())) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 加载玩家背包数据失败！错误: {}\033[0m", mysql_error(mConnection));
+    if (!mConnected) {
         return false;
     }
 
-    MYSQL_RES* result = mysql_store_result(mConnection);
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
+    return loadSnapshotVersion(conn, uuid, version);
+}
+
+bool Database::loadSnapshotVersion(MYSQL* conn, const std::string& uuid, uint64_t& version, bool forUpdate) {
+    std::string query = "SELECT `snapshot_version` FROM `player_sync_data` WHERE `uuid` = '" + uuid + "'";
+    if (forUpdate) {
+        query += " FOR UPDATE";
+    }
+
+    SlowQueryProbe probe(conn, query);
+    if (mysql_query(conn, query.c_str())) {
+        BDS_LOG_ERROR("\033[31m[数据库] 读取快照版本失败！错误: {}\033[0m", mysql_error(conn));
+        return false;
+    }
+
+    MYSQL_RES* result = mysql_store_result(conn);
     if (!result) {
         return false;
     }
 
-    items.clear();
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        PlayerBackpackItem item;
-        item.slot     = std::stoi(row[0]);
-        item.itemType = row[1] ? row[1] : "";
-        item.count    = std::stoi(row[2]);
-        item.damage   = std::stoi(row[3]);
-        item.nbt      = row[4] ? row[4] : "";
-        items.push_back(item);
+    RowCursor cursor(result);
+    RowView   row;
+    bool      found = cursor.next(row) && !row.isNull(0);
+    if (found) {
+        version = row.number<uint64_t>(0);
     }
 
     mysql_free_result(result);
+    return found;
+}
+
+// 执行预处理语句。语句按连接缓存，同一连接同一时间只被一个线程使用
+bool Database::executeStatement(MYSQL* conn, std::string_view sql, MYSQL_BIND* binds, const char* what) {
+    MYSQL_STMT* stmt = nullptr;
+    {
+        std::lock_guard lock(mStatementMutex);
+        auto&           statements = mStatements[conn];
+        if (auto it = statements.find(sql.data()); it != statements.end()) {
+            stmt = it->second;
+        }
+    }
+
+    if (!stmt) {
+        stmt = mysql_stmt_init(conn);
+        if (!stmt) {
+            BDS_LOG_ERROR("\033[31m[数据库] {}失败！错误: {}\033[0m", what, mysql_error(conn));
+            return false;
+        }
+        if (mysql_stmt_prepare(stmt, sql.data(), static_cast<unsigned long>(sql.size()))) {
+            BDS_LOG_ERROR("\033[31m[数据库] {}失败！错误: {}\033[0m", what, mysql_stmt_error(stmt));
+            mysql_stmt_close(stmt);
+            return false;
+        }
+        std::lock_guard lock(mStatementMutex);
+        mStatements[conn][sql.data()] = stmt;
+    }
+
+    SlowQueryProbe probe(conn, stmt, sql, binds);
+    if (mysql_stmt_bind_param(stmt, binds) || mysql_stmt_execute(stmt)) {
+        BDS_LOG_ERROR("\033[31m[数据库] {}失败！错误: {}\033[0m", what, mysql_stmt_error(stmt));
+        // 连接断开后语句失效：丢弃缓存，下次重新准备
+        {
+            std::lock_guard lock(mStatementMutex);
+            mStatements[conn].erase(sql.data());
+        }
+        mysql_stmt_close(stmt);
+        return false;
+    }
     return true;
 }
 
-// 保存玩家装备数据（槽位 36-40）
-bool Database::savePlayerEquipment(const std::string& uuid, const std::string& serverName, const std::vector<PlayerEquipmentItem>& items) {
-    if (!mConnected) {
+void Database::closeStatements(MYSQL* conn) {
+    std::lock_guard lock(mStatementMutex);
+    if (auto it = mStatements.find(conn); it != mStatements.end()) {
+        for (auto& [sql, stmt] : it->second) {
+            mysql_stmt_close(stmt);
+        }
+        mStatements.erase(it);
+    }
+}
+
+// 读取上次建表时保存的表结构指纹；元数据表不存在（首次启动或旧版本）时返回 false
+bool Database::loadSchemaFingerprint(MYSQL* conn, std::string& fingerprint) {
+    std::string query = std::format(
+        "{} WHERE `name` = '{}'",
+        schema::kSelectSql<tables::kSchemaMeta>.view(),
+        kSchemaFingerprintKey
+    );
+    if (mysql_query(conn, query.c_str())) {
+        if (mysql_errno(conn) != kErrNoSuchTable) {
+            BDS_LOG_WARN("\033[33m[数据库] 读取表结构指纹失败：{}\033[0m", mysql_error(conn));
+        }
+        return false;
+    }
+
+    OwnedResult rows(mysql_store_result(conn));
+    if (rows.empty()) {
+        return false;
+    }
+
+    tables::MetaEntry entry;
+    schema::decodeRow<tables::kSchemaMeta>(rows.front(), entry);
+    fingerprint = entry.value;
+    return true;
+}
+
+// 确保表中存在指定列（MySQL 8 不支持 ADD COLUMN IF NOT EXISTS）
+bool Database::ensureColumn(MYSQL* conn, const char* table, const char* column, const char* definition) {
+    std::string checkQuery = std::format(
+        "SELECT COUNT(*) FROM INFORMATION_SCHEMA.COLUMNS WHERE TABLE_SCHEMA = DATABASE() "
+        "AND TABLE_NAME = '{}' AND COLUMN_NAME = '{}'",
+        table,
+        column
+    );
+    if (mysql_query(conn, checkQuery.c_str())) {
+        BDS_LOG_ERROR("\033[31m[数据库] 检查 {}.{} 列失败！错误: {}\033[0m", table, column, mysql_error(conn));
         return false;
     }
 
-    // 先删除该玩家的旧装备数据
-    std::string deleteQuery = "DELETE FROM `player_equipment` WHERE `uuid` = '" + uuid + "'";
-    if (mysql_query(mConnection, deleteQuery.c_str())) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 删除旧装备数据失败！错误: {}\033[0m", mysql_error(mConnection));
+    MYSQL_RES* result = mysql_store_result(conn);
+    if (!result) {
         return false;
     }
+    MYSQL_ROW row    = mysql_fetch_row(result);
+    bool      exists = row && row[0] && std::stoi(row[0]) > 0;
+    mysql_free_result(result);
 
-    // 插入新的装备数据
-    for (const auto& item : items) {
-        std::ostringstream query;
-        query << "INSERT INTO `player_equipment` (`uuid`, `server_name`, `slot`, `item_type`, `count`, `damage`, `nbt`) "
-              << "VALUES ('" << uuid << "', '" << serverName << "', " << item.slot << ", "
-              << "'" << item.itemType << "', " << item.count << ", " << item.damage << ", "
-              << (item.nbt.empty() ? "NULL" : "'" + item.nbt + "'") << ")";
+    if (exists) {
+        return true;
+    }
 
-        if (mysql_query(mConnection, query.str().c_str())) {
-            auto mod = ll::mod::NativeMod::current();
-            mod->getLogger().error("\033[31m[数据库] 保存装备物品失败！错误: {}\033[0m", mysql_error(mConnection));
+    std::string alterQuery = std::format("ALTER TABLE `{}` ADD COLUMN `{}` {}", table, column, definition);
+    if (mysql_query(conn, alterQuery.c_str())) {
+        BDS_LOG_ERROR("\033[31m[数据库] 添加 {}.{} 列失败！错误: {}\033[0m", table, column, mysql_error(conn));
+        return false;
+    }
+
+    BDS_LOG_INFO("\033[33m[数据库] 已为 {} 表添加 {} 列\033[0m", table, column);
+    return true;
+}
+
+// 记录一次写入：递增快照版本号并追加变更日志
+bool Database::recordChange(MYSQL* conn, const std::string& uuid, const char* tableName, uint64_t* seq) {
+    std::string bumpQuery =
+        "UPDATE `player_sync_data` SET `snapshot_version` = `snapshot_version` + 1 WHERE `uuid` = '" + uuid + "'";
+    {
+        SlowQueryProbe probe(conn, bumpQuery);
+        if (mysql_query(conn, bumpQuery.c_str())) {
+            BDS_LOG_ERROR("\033[31m[数据库] 更新快照版本失败！错误: {}\033[0m", mysql_error(conn));
             return false;
         }
     }
 
+    std::string logQuery = std::format(
+        "INSERT INTO `player_change_log` (`uuid`, `table_name`, `version`, `server_name`) VALUES ('{}', '{}', "
+        "COALESCE((SELECT `snapshot_version` FROM `player_sync_data` WHERE `uuid` = '{}'), 0), '{}')",
+        uuid,
+        tableName,
+        uuid,
+        mConfig.serverName
+    );
+    SlowQueryProbe probe(conn, logQuery);
+    if (mysql_query(conn, logQuery.c_str())) {
+        BDS_LOG_ERROR("\033[31m[数据库] 写入变更日志失败！错误: {}\033[0m", mysql_error(conn));
+        return false;
+    }
+
+    if (seq) {
+        *seq = mysql_insert_id(conn);
+    }
     return true;
 }
 
-// 加载玩家装备数据（槽位 36-40）
-bool Database::loadPlayerEquipment(const std::string& uuid, const std::string& serverName, std::vector<PlayerEquipmentItem>& items) {
+// 读取序号大于 afterSeq 的变更日志
+bool Database::loadChangeLog(uint64_t afterSeq, int limit, std::vector<ChangeLogEntry>& entries) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.loadChangeLog");
+    ScopedTimer       timer(kLatency);
+
     if (!mConnected) {
         return false;
     }
 
-    std::string query = "SELECT `slot`, `item_type`, `count`, `damage`, `nbt` FROM `player_equipment` "
-                       "WHERE `uuid` = '" + uuid + "' ORDER BY `slot`";
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
+    std::string query = std::format(
+        "{} WHERE `seq` > {} ORDER BY `seq` LIMIT {}",
+        schema::kSelectSql<tables::kPlayerChangeLog>.view(),
+        afterSeq,
+        limit
+    );
 
-    if (mysql_query(mConnection, query.c_str())) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("\033[31m[数据库] 加载玩家装备数据失败！错误: {}\033[0m", mysql_error(mConnection));
+    SlowQueryProbe probe(conn, query);
+    if (mysql_query(conn, query.c_str())) {
+        BDS_LOG_ERROR("\033[31m[数据库] 读取变更日志失败！错误: {}\033[0m", mysql_error(conn));
         return false;
     }
 
-    MYSQL_RES* result = mysql_store_result(mConnection);
+    MYSQL_RES* result = mysql_store_result(conn);
     if (!result) {
         return false;
     }
 
-    items.clear();
-    MYSQL_ROW row;
-    while ((row = mysql_fetch_row(result))) {
-        PlayerEquipmentItem item;
-        item.slot     = std::stoi(row[0]);
-        item.itemType = row[1] ? row[1] : "";
-        item.count    = std::stoi(row[2]);
-        item.damage   = std::stoi(row[3]);
-        item.nbt      = row[4] ? row[4] : "";
-        items.push_back(item);
+    RowCursor cursor(result);
+    entries.clear();
+    entries.reserve(cursor.rowCount());
+    for (RowView row; cursor.next(row);) {
+        schema::decodeRow<tables::kPlayerChangeLog>(row, entries.emplace_back());
     }
 
     mysql_free_result(result);
     return true;
 }
 
+// 当前变更日志的最大序号（启动时从这里开始追踪，不回放历史）
+bool Database::loadChangeLogHead(uint64_t& seq) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.loadChangeLogHead");
+    ScopedTimer       timer(kLatency);
+
+    if (!mConnected) {
+        return false;
+    }
+
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
+    constexpr std::string_view query = "SELECT COALESCE(MAX(`seq`), 0) FROM `player_change_log`";
+    SlowQueryProbe             probe(conn, query);
+    if (mysql_query(conn, query.data())) {
+        BDS_LOG_ERROR("\033[31m[数据库] 读取变更日志序号失败！错误: {}\033[0m", mysql_error(conn));
+        return false;
+    }
+
+    MYSQL_RES* result = mysql_store_result(conn);
+    if (!result) {
+        return false;
+    }
+
+    RowCursor cursor(result);
+    RowView   row;
+    seq = cursor.next(row) ? row.number<uint64_t>(0) : 0;
+
+    mysql_free_result(result);
+    return true;
+}
+
+// 删除超过保留时间的变更日志（每次最多删除 limit 行，避免长事务）
+bool Database::pruneChangeLog(int retentionSeconds, int limit) {
+    static const auto kLatency = Metrics::getInstance().histogram("db.pruneChangeLog");
+    ScopedTimer       timer(kLatency);
+
+    if (!mConnected) {
+        return false;
+    }
+
+    auto conn = acquireConnection();
+    if (!conn) {
+        return false;
+    }
+
+    std::string query = std::format(
+        "DELETE FROM `player_change_log` WHERE `created_at` < NOW() - INTERVAL {} SECOND LIMIT {}",
+        retentionSeconds,
+        limit
+    );
+
+    SlowQueryProbe probe(conn, query);
+    if (mysql_query(conn, query.c_str())) {
+        BDS_LOG_ERROR("\033[31m[数据库] 清理变更日志失败！错误: {}\033[0m", mysql_error(conn));
+        return false;
+    }
+
+    return true;
+}
+
 } // namespace bdsmysql
\ No newline at end of file
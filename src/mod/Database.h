@@ -1,9 +1,20 @@
 #pragma once
 
 #include <mysql.h>
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <memory>
+#include <vector>
 #include "mod/Config.h"
+#include "mod/DatabaseEventLoop.h"
+#include "mod/ItemRecord.h"
 
 namespace bdsmysql {
 
@@ -37,41 +48,59 @@ struct PlayerSyncData {
     std::string lastSyncTime;    // 最后同步时间
 };
 
-// 玩家背包物品数据
-struct PlayerInventoryItem {
-    int    slot;        // 槽位
-    std::string itemType;  // 物品类型
-    int    count;       // 数量
-    int    damage;      // 损坏值
-    std::string nbt;        // NBT数据
+// 玩家完整快照（属性 + 背包 + 装备），作为一个整体提交
+struct PlayerSnapshot {
+    uint64_t       version   = 0;  // 提交后的快照版本号（player_sync_data.snapshot_version）
+    uint64_t       changeSeq = 0;  // 提交时写入的变更日志序号
+    PlayerSyncData syncData;
+    ItemList       items;  // 槽位 0-35 背包，36-40 装备
 };
 
-// 玩家背包数据（槽位 0-35）
-struct PlayerBackpackItem {
-    int    slot;        // 槽位 (0-35)
-    std::string itemType;  // 物品类型
-    int    count;       // 数量
-    int    damage;      // 损坏值
-    std::string nbt;        // NBT数据
+// 读取玩家完整快照的结果
+struct SnapshotLoad {
+    bool           success     = false;  // 查询全部成功；失败时不能当作玩家没有数据
+    bool           hasSyncData = false;
+    PlayerSnapshot snapshot;
 };
 
-// 玩家装备数据（槽位 36-40）
-struct PlayerEquipmentItem {
-    int    slot;        // 槽位 (36-39: 头盔/胸甲/护腿/靴子, 40: 副手)
-    std::string itemType;  // 物品类型
-    int    count;       // 数量
-    int    damage;      // 损坏值
-    std::string nbt;        // NBT数据
+// 变更日志条目（player_change_log）
+struct ChangeLogEntry {
+    uint64_t    seq = 0;
+    std::string uuid;
+    std::string tableName;
+    uint64_t    version = 0;
+    std::string serverName;
 };
 
 class Database {
 public:
+    // 连接池租约：析构时自动归还连接，可在任意线程使用
+    class ConnectionLease {
+    public:
+        ConnectionLease(Database& database, MYSQL* connection) : mDatabase(&database), mConnection(connection) {}
+        ConnectionLease(ConnectionLease&& other) noexcept;
+        ~ConnectionLease();
+
+        ConnectionLease(const ConnectionLease&)            = delete;
+        ConnectionLease& operator=(const ConnectionLease&) = delete;
+        ConnectionLease& operator=(ConnectionLease&&)      = delete;
+
+        operator MYSQL*() const { return mConnection; }
+
+    private:
+        Database* mDatabase;
+        MYSQL*    mConnection;
+    };
+
     static Database& getInstance();
 
     bool connect();
     void disconnect();
     bool isConnected() const { return mConnected; }
 
+    // 从连接池借出一个连接（池空时阻塞等待，未连接时返回空）
+    ConnectionLease acquireConnection();
+
     bool initTables();
     bool savePlayerData(const PlayerData& data);
     bool updatePlayerData(const PlayerData& data);
@@ -83,15 +112,40 @@ class Database {
     bool loadPlayerSyncData(const std::string& uuid, const std::string& serverName, PlayerSyncData& data);
     bool updatePlayerSyncData(const PlayerSyncData& data);
     
-    // 背包和装备同步（分开存储）
-    bool savePlayerBackpack(const std::string& uuid, const std::string& serverName, const std::vector<PlayerBackpackItem>& items);
-    bool loadPlayerBackpack(const std::string& uuid, const std::string& serverName, std::vector<PlayerBackpackItem>& items);
-    bool savePlayerEquipment(const std::string& uuid, const std::string& serverName, const std::vector<PlayerEquipmentItem>& items);
-    bool loadPlayerEquipment(const std::string& uuid, const std::string& serverName, std::vector<PlayerEquipmentItem>& items);
+    // 背包和装备同步（分开存储）：保存时只写入列表中对应槽位范围的记录，读取时追加到列表末尾
+    bool savePlayerBackpack(const std::string& uuid, const std::string& serverName, const ItemList& items);
+    bool loadPlayerBackpack(const std::string& uuid, const std::string& serverName, ItemList& items);
+    bool savePlayerEquipment(const std::string& uuid, const std::string& serverName, const ItemList& items);
+    bool loadPlayerEquipment(const std::string& uuid, const std::string& serverName, ItemList& items);
     
     // 旧接口（兼容性保留）
-    bool savePlayerInventory(const std::string& uuid, const std::string& serverName, const std::vector<PlayerInventoryItem>& items);
-    bool loadPlayerInventory(const std::string& uuid, const std::string& serverName, std::vector<PlayerInventoryItem>& items);
+    bool savePlayerInventory(const std::string& uuid, const std::string& serverName, const ItemList& items);
+    bool loadPlayerInventory(const std::string& uuid, const std::string& serverName, ItemList& items);
+
+    // 快照事务提交（可在后台线程调用），成功后写回 snapshot.version。
+    // 传入 expectedVersion 时只在数据库中的版本号仍等于它时写入，否则回滚并把 conflict 置为 true
+    bool savePlayerSnapshot(
+        PlayerSnapshot&         snapshot,
+        std::optional<uint64_t> expectedVersion = std::nullopt,
+        bool*                   conflict        = nullptr
+    );
+    bool loadSnapshotVersion(const std::string& uuid, uint64_t& version);
+    // 读取玩家完整快照（版本、属性、背包、装备），没有任何数据时返回 false
+    bool loadPlayerSnapshot(const std::string& uuid, PlayerSnapshot& snapshot);
+    /// @return False if a query failed (load.success).
+    bool loadPlayerSnapshot(const std::string& uuid, SnapshotLoad& load);
+
+    // 异步接口：启用事件循环时在 I/O 线程完成并回调，否则在当前线程同步执行后回调
+    using QueryCallback    = std::function<void(QueryResult&)>;
+    using SnapshotCallback = std::function<void(SnapshotLoad& load)>;
+
+    void queryAsync(std::string sql, QueryCallback callback);
+    void loadPlayerSnapshotAsync(const std::string& uuid, SnapshotCallback callback);
+
+    // 变更日志（跨服务器缓存失效）
+    bool loadChangeLog(uint64_t afterSeq, int limit, std::vector<ChangeLogEntry>& entries);
+    bool loadChangeLogHead(uint64_t& seq);
+    bool pruneChangeLog(int retentionSeconds, int limit);
 
 private:
     Database()  = default;
@@ -100,9 +154,46 @@ class Database {
     Database(const Database&)            = delete;
     Database& operator=(const Database&) = delete;
 
-    MYSQL*                 mConnection = nullptr;
-    bool                   mConnected  = false;
-    const DatabaseConfig&  mConfig     = Config::getInstance().getDatabaseConfig();
+    // 失败时把错误码写入 errorCode（传入 errorCode 时数据库不存在由调用方处理，不输出错误日志）
+    MYSQL*              openConnection(const char* database, unsigned long flags, unsigned int* errorCode = nullptr);
+    MYSQL*              createDatabase();  // 创建数据库，返回已选中该数据库的连接
+    // 并行建立连接，每个元素对应 flags 中的一项，失败的位置为空
+    std::vector<MYSQL*> openConnections(const char* database, const std::vector<unsigned long>& flags);
+    MYSQL*              reopenConnection(MYSQL* conn);  // 替换已断开的连接，失败时返回原连接
+    void                releaseConnection(MYSQL* conn);
+
+    bool savePlayerSyncData(MYSQL* conn, const PlayerSyncData& data);
+    bool loadPlayerSyncData(MYSQL* conn, const std::string& uuid, PlayerSyncData& data);
+    bool savePlayerBackpack(MYSQL* conn, const std::string& uuid, const std::string& serverName, const ItemList& items);
+    bool savePlayerEquipment(MYSQL* conn, const std::string& uuid, const std::string& serverName, const ItemList& items);
+    template <const auto& Table>
+    bool saveItemRows(
+        MYSQL*             conn,
+        const std::string& uuid,
+        const std::string& serverName,
+        const ItemList&    items,
+        int                firstSlot,
+        int                lastSlot,
+        const char*        what
+    );
+    bool loadSnapshotVersion(MYSQL* conn, const std::string& uuid, uint64_t& version, bool forUpdate = false);
+    bool executeStatement(MYSQL* conn, std::string_view sql, MYSQL_BIND* binds, const char* what);
+    void closeStatements(MYSQL* conn);
+    bool ensureColumn(MYSQL* conn, const char* table, const char* column, const char* definition);
+    bool loadSchemaFingerprint(MYSQL* conn, std::string& fingerprint);
+    bool recordChange(MYSQL* conn, const std::string& uuid, const char* tableName, uint64_t* seq = nullptr);
+
+    std::vector<MYSQL*>     mIdleConnections;
+    int                     mPoolSize = 0;
+    std::mutex              mPoolMutex;
+    std::condition_variable mPoolCv;
+    std::atomic<bool>       mConnected = false;
+
+    // 预处理语句缓存：连接 -> (SQL 文本地址 -> 语句)，SQL 来自表定义生成的常量
+    std::unordered_map<MYSQL*, std::unordered_map<const char*, MYSQL_STMT*>> mStatements;
+    std::mutex                                                               mStatementMutex;
+
+    const DatabaseConfig&   mConfig    = Config::getInstance().getDatabaseConfig();
 };
 
 } // namespace bdsmysql
\ No newline at end of file
@@ -0,0 +1,16 @@
+#include "mod/DatabaseAsync.h"
+#include "mod/Log.h"
+
+namespace bdsmysql {
+
+void GameTask::promise_type::unhandled_exception() noexcept {
+    try {
+        std::rethrow_exception(std::current_exception());
+    } catch (const std::exception& e) {
+        BDS_LOG_ERROR("\033[31m[协程] 未处理的异常: {}\033[0m", e.what());
+    } catch (...) {
+        BDS_LOG_ERROR("\033[31m[协程] 未处理的未知异常\033[0m");
+    }
+}
+
+} // namespace bdsmysql
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "mod/CompletionQueue.h"
+#include "mod/Database.h"
+#include "mod/DatabaseExecutor.h"
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace bdsmysql {
+
+// 取消令牌：玩家离线时取消，挂起中的协程不再恢复，协程帧在主线程销毁
+class CancellationToken {
+public:
+    CancellationToken() : mCancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+    void cancel() const { mCancelled->store(true); }
+    bool isCancelled() const { return mCancelled->load(); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> mCancelled;
+};
+
+// 在主线程启动的协程：立即开始执行，结束后自动销毁。
+// 参数列表中的 CancellationToken 会绑定到协程，用于取消
+class GameTask {
+public:
+    struct promise_type {
+        CancellationToken token;
+
+        promise_type() = default;
+
+        template <class... Args>
+        explicit promise_type(const Args&... args) {
+            (bind(args), ...);
+        }
+
+        GameTask            get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void                return_void() noexcept {}
+        void                unhandled_exception() noexcept;
+
+    private:
+        void bind(const CancellationToken& value) { token = value; }
+
+        template <class T>
+        void bind(const T&) {}
+    };
+};
+
+// 在后台线程执行 work，完成后在主线程恢复协程（协程已取消则销毁）
+// strandKey 非空时投递到对应 strand，与该玩家的其它数据库操作保持顺序
+template <class T>
+class DbAwaitable {
+public:
+    DbAwaitable(std::string strandKey, JobPriority priority, std::function<T()> work)
+    : mStrandKey(std::move(strandKey)),
+      mPriority(priority),
+      mWork(std::move(work)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<GameTask::promise_type> handle) {
+        CancellationToken token = handle.promise().token;
+
+        auto job = [this, handle, token] {
+            // 已取消：跳过数据库操作
+            if (!token.isCancelled()) {
+                try {
+                    mResult.emplace(mWork());
+                } catch (...) {
+                    mError = std::current_exception();
+                }
+            }
+            CompletionQueue::getInstance().post([handle, token] {
+                if (token.isCancelled()) {
+                    handle.destroy();
+                } else {
+                    handle.resume();
+                }
+            });
+        };
+
+        if (mStrandKey.empty()) {
+            DatabaseExecutor::getInstance().post(std::move(job), mPriority);
+        } else {
+            DatabaseExecutor::getInstance().post(mStrandKey, std::move(job), mPriority);
+        }
+    }
+
+    T await_resume() {
+        if (mError) {
+            std::rethrow_exception(mError);
+        }
+        return std::move(*mResult);
+    }
+
+private:
+    std::string        mStrandKey;
+    JobPriority        mPriority;
+    std::function<T()> mWork;
+    std::optional<T>   mResult;
+    std::exception_ptr mError;
+};
+
+// 回调式的后台操作：start 在后台线程调用，操作完成时调用 done（可以在事件循环 I/O 线程上），
+// 随后在主线程恢复协程。用于不占用工作线程等待结果的非阻塞查询
+template <class T>
+class DbCallbackAwaitable {
+public:
+    using Done  = std::function<void(T)>;
+    using Start = std::function<void(Done)>;
+
+    DbCallbackAwaitable(std::string strandKey, JobPriority priority, Start start)
+    : mStrandKey(std::move(strandKey)),
+      mPriority(priority),
+      mStart(std::move(start)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<GameTask::promise_type> handle) {
+        CancellationToken token = handle.promise().token;
+
+        auto resume = [handle, token] {
+            CompletionQueue::getInstance().post([handle, token] {
+                if (token.isCancelled()) {
+                    handle.destroy();
+                } else {
+                    handle.resume();
+                }
+            });
+        };
+
+        // strand 任务只负责提交：之前的保存已经完成，查询结果返回前 strand 可以继续执行
+        auto job = [this, token, resume] {
+            if (token.isCancelled()) {
+                resume();
+                return;
+            }
+            try {
+                mStart([this, resume](T result) {
+                    mResult.emplace(std::move(result));
+                    resume();
+                });
+            } catch (...) {
+                mError = std::current_exception();
+                resume();
+            }
+        };
+
+        if (mStrandKey.empty()) {
+            DatabaseExecutor::getInstance().post(std::move(job), mPriority);
+        } else {
+            DatabaseExecutor::getInstance().post(mStrandKey, std::move(job), mPriority);
+        }
+    }
+
+    T await_resume() {
+        if (mError) {
+            std::rethrow_exception(mError);
+        }
+        return std::move(*mResult);
+    }
+
+private:
+    std::string        mStrandKey;
+    JobPriority        mPriority;
+    Start              mStart;
+    std::optional<T>   mResult;
+    std::exception_ptr mError;
+};
+
+// Database 的协程接口：
+//   auto load = co_await AsyncDatabase::getInstance().loadPlayerSnapshot(uuid);
+// 在后台线程池执行，在主线程恢复
+class AsyncDatabase {
+public:
+    static AsyncDatabase& getInstance() {
+        static AsyncDatabase instance;
+        return instance;
+    }
+
+    // 一致性快照读取。启用事件循环时由 I/O 线程推进，等待结果期间不占用工作线程
+    DbCallbackAwaitable<SnapshotLoad>
+    loadPlayerSnapshot(const std::string& uuid, JobPriority priority = JobPriority::Interactive) {
+        using Done = DbCallbackAwaitable<SnapshotLoad>::Done;
+        return {uuid, priority, [uuid](Done done) {
+                    Database::getInstance().loadPlayerSnapshotAsync(uuid, [done = std::move(done)](SnapshotLoad& load) {
+                        done(std::move(load));
+                    });
+                }};
+    }
+
+    // 在后台线程执行任意数据库操作
+    template <class F>
+    DbAwaitable<std::invoke_result_t<F&>> run(const std::string& strandKey, JobPriority priority, F work) {
+        return {strandKey, priority, std::move(work)};
+    }
+
+private:
+    AsyncDatabase()  = default;
+    ~AsyncDatabase() = default;
+
+    AsyncDatabase(const AsyncDatabase&)            = delete;
+    AsyncDatabase& operator=(const AsyncDatabase&) = delete;
+};
+
+} // namespace bdsmysql
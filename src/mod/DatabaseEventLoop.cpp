@@ -0,0 +1,375 @@
+#ifdef _WIN32
+#include <winsock2.h>
+#else
+#include <poll.h>
+#endif
+
+#include "mod/DatabaseEventLoop.h"
+#include "ll/api/io/Logger.h"
+#include "ll/api/mod/NativeMod.h"
+#include "mod/Log.h"
+#include "mod/Metrics.h"
+#include "mod/QueryRecorder.h"
+#include "mod/SlowQueryLog.h"
+#include "mod/Tracer.h"
+#include <algorithm>
+
+namespace bdsmysql {
+
+namespace {
+
+#ifdef _WIN32
+int pollSockets(pollfd* fds, unsigned long n, int timeoutMs) { return WSAPoll(fds, n, timeoutMs); }
+#else
+int pollSockets(pollfd* fds, unsigned long n, int timeoutMs) { return poll(fds, n, timeoutMs); }
+#endif
+
+constexpr unsigned int kErrServerGone = 2006;  // CR_SERVER_GONE_ERROR
+constexpr unsigned int kErrServerLost = 2013;  // CR_SERVER_LOST
+
+constexpr auto kReconnectDelay = std::chrono::seconds(1);
+
+// 连接使用的套接字。MariaDB Connector/C 提供 mysql_get_socket；MySQL 客户端库没有公开的访问接口，
+// 只能读取 mysql_com.h 中的 NET。只在建立连接后读取一次
+my_socket socketOf(MYSQL* mysql) {
+#ifdef MARIADB_BASE_VERSION
+    return mysql_get_socket(mysql);
+#else
+    return mysql->net.fd;
+#endif
+}
+
+} // namespace
+
+DatabaseEventLoop& DatabaseEventLoop::getInstance() {
+    static DatabaseEventLoop instance;
+    return instance;
+}
+
+void DatabaseEventLoop::start(std::vector<MYSQL*> connections, int pollIntervalMs, Reconnect reconnect) {
+    std::lock_guard lock(mMutex);
+    if (mRunning || connections.empty()) {
+        for (MYSQL* conn : connections) {
+            mysql_close(conn);
+        }
+        return;
+    }
+
+    mConnections.clear();
+    for (MYSQL* conn : connections) {
+        attach(mConnections.emplace_back(), conn);
+    }
+    mReconnect      = std::move(reconnect);
+    mPollIntervalMs = std::max(pollIntervalMs, 1);
+    mStopping       = false;
+    mRunning        = true;
+    mThread         = std::thread([this] { run(); });
+
+    BDS_LOG_INFO("\033[32m[事件循环] 非阻塞查询事件循环已启动 ({} 个连接)\033[0m", mConnections.size());
+}
+
+void DatabaseEventLoop::stop() {
+    {
+        std::lock_guard lock(mMutex);
+        if (!mRunning) {
+            return;
+        }
+        mStopping = true;
+    }
+    mCv.notify_all();
+
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+
+    for (auto& connection : mConnections) {
+        if (connection.mysql) {
+            mysql_close(connection.mysql);
+        }
+    }
+    mConnections.clear();
+
+    std::lock_guard lock(mMutex);
+    mRunning = false;
+}
+
+void DatabaseEventLoop::submit(std::string sql, Callback callback) {
+    std::vector<std::string> statements;
+    statements.push_back(std::move(sql));
+    submit(std::move(statements), [callback = std::move(callback)](std::vector<QueryResult>& results) {
+        callback(results.front());
+    });
+}
+
+void DatabaseEventLoop::submit(std::vector<std::string> statements, BatchCallback callback) {
+    size_t count = statements.size();
+    {
+        std::lock_guard lock(mMutex);
+        if (mRunning && !mStopping) {
+            mQueue.push_back({std::move(statements), std::move(callback), Clock::now(), std::string(Tracer::currentKey())});
+            mCv.notify_one();
+            return;
+        }
+    }
+
+    std::vector<QueryResult> results(count);
+    for (auto& result : results) {
+        result.error = "事件循环未运行";
+    }
+    callback(results);
+}
+
+size_t DatabaseEventLoop::getQueuedCount() const {
+    std::lock_guard lock(mMutex);
+    return mQueue.size();
+}
+
+size_t DatabaseEventLoop::getInFlightCount() const {
+    std::lock_guard lock(mMutex);
+    return mInFlight;
+}
+
+void DatabaseEventLoop::run() {
+    mysql_thread_init();
+    Tracer::setThreadName("db-eventloop");
+
+    std::vector<pollfd>      fds;
+    std::vector<Connection*> polled;
+    while (true) {
+        // 1. 到时间的断开连接重新建立，再把排队的查询分配给空闲连接
+        {
+            std::unique_lock lock(mMutex);
+            if (mInFlight == 0) {
+                mCv.wait(lock, [this] { return mStopping || !mQueue.empty(); });
+                if (mQueue.empty()) {
+                    break;  // 正在停止且没有未完成的查询
+                }
+            }
+        }
+
+        auto now       = Clock::now();
+        bool available = false;
+        for (auto& connection : mConnections) {
+            if (!connection.mysql && now >= connection.retryAt) {
+                MYSQL* mysql = mReconnect ? mReconnect() : nullptr;
+                if (mysql) {
+                    attach(connection, mysql);
+                    BDS_LOG_INFO("\033[32m[事件循环] 已重新建立连接\033[0m");
+                } else {
+                    connection.retryAt = now + kReconnectDelay;
+                }
+            }
+            available = available || connection.mysql;
+        }
+
+        // 所有连接都已断开且无法重新建立：排队的查询直接失败，不让调用方一直等待
+        if (!available) {
+            failQueued("数据库连接已断开");
+        }
+
+        {
+            std::lock_guard lock(mMutex);
+            for (auto& connection : mConnections) {
+                if (!connection.mysql || connection.stage != Stage::Idle || mQueue.empty()) {
+                    continue;
+                }
+                connection.statements    = std::move(mQueue.front().statements);
+                connection.next          = 0;
+                connection.callback      = std::move(mQueue.front().callback);
+                connection.submitTime    = mQueue.front().submitTime;
+                connection.startTime     = Clock::now();
+                connection.traceKey      = std::move(mQueue.front().traceKey);
+                connection.stage         = Stage::Query;
+                connection.awaitingReply = false;
+                mQueue.pop_front();
+                mInFlight++;
+            }
+        }
+
+        // 2. 推进每个连接直到需要等待网络
+        fds.clear();
+        polled.clear();
+        for (auto& connection : mConnections) {
+            while (connection.stage != Stage::Idle) {
+                bool wasWritable    = connection.writable;
+                connection.writable = false;
+                if (step(connection)) {
+                    continue;
+                }
+                // 套接字可写时仍未完成：请求已经发出，之后只需等待服务器的响应
+                if (wasWritable) {
+                    connection.awaitingReply = true;
+                }
+                break;
+            }
+            if (connection.stage != Stage::Idle) {
+                pollfd pfd{};
+                pfd.fd     = connection.socket;
+                pfd.events = POLLIN;
+                if (connection.stage == Stage::Query && !connection.awaitingReply) {
+                    pfd.events |= POLLOUT;  // 请求可能还在发送
+                }
+                fds.push_back(pfd);
+                polled.push_back(&connection);
+            }
+        }
+
+        // 3. 等待任一连接可读写；超时后重新检查新提交的查询和需要重新建立的连接
+        if (!fds.empty() && pollSockets(fds.data(), static_cast<unsigned long>(fds.size()), mPollIntervalMs) > 0) {
+            for (size_t i = 0; i < fds.size(); i++) {
+                polled[i]->writable = (fds[i].revents & POLLOUT) != 0;
+            }
+        }
+    }
+
+    mysql_thread_end();
+}
+
+void DatabaseEventLoop::attach(Connection& connection, MYSQL* mysql) {
+    connection.mysql         = mysql;
+    connection.socket        = socketOf(mysql);
+    connection.writable      = false;
+    connection.awaitingReply = false;
+}
+
+void DatabaseEventLoop::onLost(Connection& connection, const std::string& error) {
+    BDS_LOG_WARN("\033[33m[事件循环] 连接已断开: {}，正在重新连接\033[0m", error);
+
+    // 服务器已回滚未提交的事务，剩余的语句都不会执行
+    while (connection.stage != Stage::Idle) {
+        QueryResult result;
+        result.error = error;
+        finish(connection, result);
+    }
+
+    mysql_close(connection.mysql);
+    connection.mysql = nullptr;
+    if (MYSQL* mysql = mReconnect ? mReconnect() : nullptr) {
+        attach(connection, mysql);
+        BDS_LOG_INFO("\033[32m[事件循环] 已重新建立连接\033[0m");
+    } else {
+        connection.retryAt = Clock::now() + kReconnectDelay;
+    }
+}
+
+void DatabaseEventLoop::failQueued(const char* error) {
+    std::deque<Request> failed;
+    {
+        std::lock_guard lock(mMutex);
+        failed.swap(mQueue);
+    }
+    for (auto& request : failed) {
+        std::vector<QueryResult> results(request.statements.size());
+        for (auto& result : results) {
+            result.error = error;
+        }
+        TraceKey key(request.traceKey);
+        try {
+            request.callback(results);
+        } catch (const std::exception& e) {
+            BDS_LOG_ERROR("\033[31m[事件循环] 查询回调执行失败: {}\033[0m", e.what());
+        }
+    }
+}
+
+bool DatabaseEventLoop::step(Connection& connection) {
+    MYSQL* mysql = connection.mysql;
+
+    if (connection.stage == Stage::Query) {
+        const auto& sql    = connection.statements[connection.next];
+        auto        status = mysql_real_query_nonblocking(mysql, sql.c_str(), static_cast<unsigned long>(sql.size()));
+        if (status == NET_ASYNC_NOT_READY) {
+            return false;
+        }
+        if (status == NET_ASYNC_ERROR) {
+            QueryResult result;
+            result.error = mysql_error(mysql);
+            if (unsigned int error = mysql_errno(mysql); error == kErrServerGone || error == kErrServerLost) {
+                onLost(connection, result.error);
+            } else {
+                finish(connection, result);
+            }
+            return true;
+        }
+        connection.stage = Stage::Store;
+    }
+
+    MYSQL_RES* res    = nullptr;
+    auto       status = mysql_store_result_nonblocking(mysql, &res);
+    if (status == NET_ASYNC_NOT_READY) {
+        return false;
+    }
+    if (status == NET_ASYNC_ERROR) {
+        if (unsigned int error = mysql_errno(mysql); error == kErrServerGone || error == kErrServerLost) {
+            onLost(connection, mysql_error(mysql));
+            return true;
+        }
+    }
+
+    QueryResult result;
+    if (status == NET_ASYNC_ERROR || (!res && mysql_errno(mysql) != 0)) {
+        result.error = mysql_error(mysql);
+    } else {
+        result.success = true;
+        if (res) {
+            result.rows = OwnedResult(res);
+        } else {
+            result.affectedRows = mysql_affected_rows(mysql);
+            result.insertId     = mysql_insert_id(mysql);
+        }
+    }
+    finish(connection, result);
+    return true;
+}
+
+void DatabaseEventLoop::finish(Connection& connection, QueryResult& result) {
+    const auto& sql     = connection.statements[connection.next];
+    auto        elapsed = Clock::now() - connection.startTime;
+    uint64_t    rows    = result.rows.empty() ? result.affectedRows : result.rows.size();
+    if (SlowQueryLog::getInstance().isSlow(elapsed)) {
+        SlowQueryLog::getInstance().record(sql, {}, rows, elapsed);
+    }
+    if (QueryRecorder::recording()) {
+        QueryRecorder::getInstance().recordText(connection.mysql, sql, connection.startTime, elapsed, rows, !result.success);
+    }
+    if (!result.success) {
+        BDS_LOG_ERROR("\033[31m[事件循环] 查询失败: {}\033[0m", result.error);
+    }
+
+    connection.results.push_back(std::move(result));
+    if (++connection.next < connection.statements.size()) {
+        connection.startTime     = Clock::now();
+        connection.stage         = Stage::Query;
+        connection.awaitingReply = false;
+        return;
+    }
+
+    auto callback = std::move(connection.callback);
+    auto results  = std::move(connection.results);
+    connection.statements.clear();
+    connection.results.clear();
+    connection.callback = nullptr;
+    connection.stage    = Stage::Idle;
+    {
+        std::lock_guard lock(mMutex);
+        mInFlight--;
+    }
+
+    // 提交到完成（含排队时间），与同步执行的 queryAsync 记入同一直方图
+    static const auto kLatency = Metrics::getInstance().histogram("db.queryAsync");
+    auto              end      = Clock::now();
+    Metrics::getInstance().record(kLatency, end - connection.submitTime);
+
+    TraceKey key(connection.traceKey);
+    if (Tracer::enabled()) {
+        Tracer::getInstance().complete(Metrics::getInstance().histogramName(kLatency), connection.submitTime, end);
+    }
+
+    try {
+        callback(results);
+    } catch (const std::exception& e) {
+        BDS_LOG_ERROR("\033[31m[事件循环] 查询回调执行失败: {}\033[0m", e.what());
+    }
+}
+
+} // namespace bdsmysql
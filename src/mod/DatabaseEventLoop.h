@@ -0,0 +1,102 @@
+#pragma once
+
+#include <mysql.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mod/RowView.h"
+
+namespace bdsmysql {
+
+struct QueryResult {
+    bool        success = false;
+    std::string error;
+    uint64_t    affectedRows = 0;
+    uint64_t    insertId     = 0;
+    OwnedResult rows;  // 结果集（直接引用 MYSQL_RES 缓冲区，随 QueryResult 释放）
+};
+
+// 非阻塞查询事件循环：
+// 使用 libmysqlclient 的 *_nonblocking 接口，由一个 I/O 线程在少量连接上同时推进多个查询，
+// 等待的查询不占用操作系统线程。每个连接同一时间只执行一条语句（不支持多语句）
+class DatabaseEventLoop {
+public:
+    using Callback      = std::function<void(QueryResult&)>;  // 在 I/O 线程调用，应尽快返回
+    using BatchCallback = std::function<void(std::vector<QueryResult>&)>;
+    using Reconnect     = std::function<MYSQL*()>;  // 在 I/O 线程重新建立断开的连接，失败时返回空
+
+    static DatabaseEventLoop& getInstance();
+
+    // 接管已建立的连接并启动 I/O 线程
+    void start(std::vector<MYSQL*> connections, int pollIntervalMs, Reconnect reconnect);
+    void stop();  // 完成已提交的查询后停止并关闭连接
+    bool isRunning() const { return mRunning; }
+
+    void submit(std::string sql, Callback callback);
+    // 在同一个连接上依次执行多条语句（可以组成一个事务），全部完成后按顺序回调每条语句的结果。
+    // 某条语句失败不会跳过后续语句，结尾的 COMMIT 总会执行
+    void submit(std::vector<std::string> statements, BatchCallback callback);
+
+    size_t getQueuedCount() const;
+    size_t getInFlightCount() const;
+
+private:
+    enum class Stage { Idle, Query, Store };
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Connection {
+        MYSQL*                   mysql         = nullptr;  // 连接断开且尚未重新建立时为空
+        my_socket                socket        = {};
+        Stage                    stage         = Stage::Idle;
+        bool                     writable      = false;  // 上一次等待时套接字可写
+        bool                     awaitingReply = false;  // 请求已发出，只需等待可读
+        Clock::time_point        retryAt;                // 下一次尝试重新连接的时间
+        std::vector<std::string> statements;
+        size_t                   next = 0;  // 正在执行的语句
+        std::vector<QueryResult> results;
+        BatchCallback            callback;
+        Clock::time_point        submitTime;
+        Clock::time_point        startTime;  // 当前语句开始在连接上执行（不含排队），用于慢查询日志
+        std::string              traceKey;
+    };
+
+    struct Request {
+        std::vector<std::string> statements;
+        BatchCallback            callback;
+        Clock::time_point        submitTime;
+        std::string              traceKey;  // 提交线程的追踪键，回调在同一键下执行
+    };
+
+    DatabaseEventLoop()  = default;
+    ~DatabaseEventLoop() = default;
+
+    DatabaseEventLoop(const DatabaseEventLoop&)            = delete;
+    DatabaseEventLoop& operator=(const DatabaseEventLoop&) = delete;
+
+    void run();
+    bool step(Connection& connection);  // 推进一步，返回 false 表示需要等待套接字
+    void finish(Connection& connection, QueryResult& result);  // 当前语句完成，执行下一条或回调
+    void attach(Connection& connection, MYSQL* mysql);
+    void onLost(Connection& connection, const std::string& error);  // 未执行的语句全部失败，然后重新连接
+    void failQueued(const char* error);
+
+    std::vector<Connection> mConnections;  // 只在 I/O 线程访问
+    Reconnect               mReconnect;
+    std::deque<Request>     mQueue;
+    size_t                  mInFlight       = 0;
+    int                     mPollIntervalMs = 2;
+    mutable std::mutex      mMutex;
+    std::condition_variable mCv;
+    std::thread             mThread;
+    bool                    mRunning  = false;
+    bool                    mStopping = false;
+};
+
+} // namespace bdsmysql
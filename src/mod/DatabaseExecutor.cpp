@@ -0,0 +1,290 @@
+#include "mod/DatabaseExecutor.h"
+#include "ll/api/io/Logger.h"
+#include "ll/api/mod/NativeMod.h"
+#include "mod/Config.h"
+#include "mod/Log.h"
+#include "mod/Metrics.h"
+#include "mod/Tracer.h"
+#include <algorithm>
+#include <format>
+#include <mysql.h>
+
+namespace bdsmysql {
+
+namespace {
+
+constexpr std::array<const char*, kJobPriorityCount> kClassNames = {
+    "interactive",
+    "transfer",
+    "leaveSave",
+    "background",
+};
+
+} // namespace
+
+DatabaseExecutor& DatabaseExecutor::getInstance() {
+    static DatabaseExecutor instance;
+    return instance;
+}
+
+void DatabaseExecutor::start(int threadCount) {
+    {
+        std::lock_guard lock(mMutex);
+        if (mRunning) {
+            return;
+        }
+
+        auto& config = Config::getInstance().getDatabaseConfig().scheduler;
+        mWeights     = {
+            std::max(config.interactiveWeight, 1),
+            std::max(config.transferWeight, 1),
+            std::max(config.leaveSaveWeight, 1),
+            std::max(config.backgroundWeight, 1),
+        };
+        mCredits    = mWeights;
+        mStarvation = std::chrono::milliseconds(std::max(config.starvationMs, 1));
+
+        mStopping = false;
+        mRunning  = true;
+        for (int i = 0; i < threadCount; i++) {
+            mWorkers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    // 仪表在 Metrics 的锁内读取 getStats()，不能在持有 mMutex 时注册
+    // 各类别的排队数、等待时间和饥饿次数在 /bdsmysql stats 和 metrics.txt 中显示
+    auto& metrics = Metrics::getInstance();
+    for (size_t i = 0; i < kJobPriorityCount; i++) {
+        auto name = kClassNames[i];
+        metrics.gauge(std::format("executor.{}.pending", name), [this, i] {
+            return static_cast<double>(getStats()[i].pending);
+        });
+        metrics.gauge(std::format("executor.{}.avgWaitMs", name), [this, i] {
+            auto stats = getStats()[i];
+            return stats.executed > 0 ? stats.totalWaitMs / static_cast<double>(stats.executed) : 0.0;
+        });
+        metrics.gauge(std::format("executor.{}.maxWaitMs", name), [this, i] { return getStats()[i].maxWaitMs; });
+        metrics.gauge(std::format("executor.{}.starved", name), [this, i] {
+            return static_cast<double>(getStats()[i].starved);
+        });
+    }
+
+    BDS_LOG_INFO("\033[32m[数据库] 后台工作线程已启动 ({} 个)\033[0m", threadCount);
+}
+
+void DatabaseExecutor::stop() {
+    {
+        std::lock_guard lock(mMutex);
+        if (!mRunning) {
+            return;
+        }
+        mStopping = true;
+    }
+    mCv.notify_all();
+
+    for (auto& worker : mWorkers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    mWorkers.clear();
+
+    std::lock_guard lock(mMutex);
+    mRunning = false;
+}
+
+void DatabaseExecutor::post(Job job, JobPriority priority) {
+    {
+        std::lock_guard lock(mMutex);
+        if (mRunning && !mStopping) {
+            mQueues[static_cast<size_t>(priority)].push_back({std::move(job), Clock::now()});
+            job = nullptr;
+        }
+    }
+
+    if (job) {
+        // 线程池未运行（启动前或关闭中）：同步执行，保证数据不丢失
+        job();
+        return;
+    }
+    mCv.notify_one();
+}
+
+void DatabaseExecutor::post(const std::string& strandKey, Job job, JobPriority priority) {
+    uint64_t ticket = 0;
+    {
+        std::lock_guard lock(mStrandMutex);
+        auto&           strand = mStrands[strandKey];
+        strand.jobs.emplace_back(std::move(job), priority);
+        // 正在执行时由执行完的任务重新排队；已按不低于该任务的优先级排队时无需处理
+        if (strand.running || (strand.ticket != 0 && strand.priority <= priority)) {
+            return;
+        }
+        // 未排队，或排队的优先级更低（如排在在线时长更新之后的加入读取）：按该任务的优先级重新排队
+        ticket = scheduleStrand(strand, priority);
+    }
+
+    post([this, strandKey, ticket] { runStrand(strandKey, ticket); }, priority);
+}
+
+uint64_t DatabaseExecutor::scheduleStrand(Strand& strand, JobPriority priority) {
+    strand.ticket   = mNextTicket++;
+    strand.priority = priority;
+    return strand.ticket;
+}
+
+void DatabaseExecutor::runStrand(const std::string& strandKey, uint64_t ticket) {
+    Job job;
+    {
+        std::lock_guard lock(mStrandMutex);
+        auto            it = mStrands.find(strandKey);
+        if (it == mStrands.end() || it->second.ticket != ticket) {
+            return;  // 已被更高优先级的调度任务取代
+        }
+        auto& strand   = it->second;
+        strand.ticket  = 0;
+        strand.running = true;
+        job            = std::move(strand.jobs.front().first);
+    }
+
+    try {
+        TraceKey key(strandKey);  // strand 键即玩家 UUID
+        job();
+    } catch (const std::exception& e) {
+        BDS_LOG_ERROR("\033[31m[数据库] 后台任务执行失败 ({}): {}\033[0m", strandKey, e.what());
+    } catch (...) {
+        // 任何异常都不能跳过下面的出队，否则该 strand 永远停在这个任务上
+        BDS_LOG_ERROR("\033[31m[数据库] 后台任务执行失败 ({}): 未知异常\033[0m", strandKey);
+    }
+
+    uint64_t    next         = 0;
+    JobPriority nextPriority = JobPriority::Background;
+    {
+        std::lock_guard lock(mStrandMutex);
+        auto            it     = mStrands.find(strandKey);
+        auto&           strand = it->second;
+        strand.jobs.pop_front();
+        strand.running = false;
+        if (strand.jobs.empty()) {
+            mStrands.erase(it);
+        } else {
+            for (const auto& [queued, priority] : strand.jobs) {
+                nextPriority = std::min(nextPriority, priority);
+            }
+            next = scheduleStrand(strand, nextPriority);
+        }
+    }
+
+    if (next != 0) {
+        // 每次只执行一个任务后重新排队，避免单个玩家的任务长时间占用工作线程
+        post([this, strandKey, next] { runStrand(strandKey, next); }, nextPriority);
+    } else {
+        mStrandCv.notify_all();
+    }
+}
+
+void DatabaseExecutor::waitForStrand(const std::string& strandKey) {
+    std::unique_lock lock(mStrandMutex);
+    mStrandCv.wait(lock, [&] { return !mStrands.contains(strandKey); });
+}
+
+bool DatabaseExecutor::hasPendingStrand(const std::string& strandKey) const {
+    std::lock_guard lock(mStrandMutex);
+    return mStrands.contains(strandKey);
+}
+
+size_t DatabaseExecutor::getPendingStrandCount() const {
+    std::lock_guard lock(mStrandMutex);
+    return mStrands.size();
+}
+
+std::array<JobClassStats, kJobPriorityCount> DatabaseExecutor::getStats() const {
+    std::lock_guard lock(mMutex);
+    auto            stats = mStats;
+    for (size_t i = 0; i < kJobPriorityCount; i++) {
+        stats[i].pending = mQueues[i].size();
+    }
+    return stats;
+}
+
+bool DatabaseExecutor::hasQueuedJobs() const {
+    for (const auto& queue : mQueues) {
+        if (!queue.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+DatabaseExecutor::Job DatabaseExecutor::takeNextJob() {
+    auto now = Clock::now();
+
+    // 1. 饥饿保护：等待最久的队首任务超过阈值时直接执行
+    size_t chosen = kJobPriorityCount;
+    for (size_t i = 0; i < kJobPriorityCount; i++) {
+        if (mQueues[i].empty() || now - mQueues[i].front().enqueuedAt < mStarvation) {
+            continue;
+        }
+        if (chosen == kJobPriorityCount || mQueues[i].front().enqueuedAt < mQueues[chosen].front().enqueuedAt) {
+            chosen = i;
+        }
+    }
+    bool starved = chosen != kJobPriorityCount;
+
+    // 2. 加权轮转：按优先级顺序取仍有额度的类别，所有非空类别额度用尽后重新分配
+    for (int round = 0; round < 2 && chosen == kJobPriorityCount; round++) {
+        for (size_t i = 0; i < kJobPriorityCount; i++) {
+            if (!mQueues[i].empty() && mCredits[i] > 0) {
+                chosen = i;
+                mCredits[i]--;
+                break;
+            }
+        }
+        if (chosen == kJobPriorityCount) {
+            mCredits = mWeights;
+        }
+    }
+
+    auto queued = std::move(mQueues[chosen].front());
+    mQueues[chosen].pop_front();
+
+    auto&  stats  = mStats[chosen];
+    double waitMs = std::chrono::duration<double, std::milli>(now - queued.enqueuedAt).count();
+    stats.executed++;
+    stats.totalWaitMs += waitMs;
+    stats.maxWaitMs    = std::max(stats.maxWaitMs, waitMs);
+    if (starved) {
+        stats.starved++;
+    }
+    return std::move(queued.job);
+}
+
+void DatabaseExecutor::workerLoop() {
+    mysql_thread_init();
+    Tracer::setThreadName("db-worker");
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(mMutex);
+            mCv.wait(lock, [this] { return mStopping || hasQueuedJobs(); });
+            if (!hasQueuedJobs()) {
+                break;  // 正在停止且队列已清空
+            }
+            job = takeNextJob();
+        }
+
+        try {
+            job();
+        } catch (const std::exception& e) {
+            BDS_LOG_ERROR("\033[31m[数据库] 后台任务执行失败: {}\033[0m", e.what());
+        } catch (...) {
+            // 异常逃出工作线程会终止服务器
+            BDS_LOG_ERROR("\033[31m[数据库] 后台任务执行失败: 未知异常\033[0m");
+        }
+    }
+
+    mysql_thread_end();
+}
+
+} // namespace bdsmysql
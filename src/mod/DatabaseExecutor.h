@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace bdsmysql {
+
+// 后台任务优先级类别（数值越小越优先）
+enum class JobPriority : int {
+    Interactive = 0,  // 玩家加入读取：玩家在完成前无法游戏
+    Transfer    = 1,  // 传送提交：玩家在完成前无法跳转
+    LeaveSave   = 2,  // 离线/关服保存
+    Background  = 3,  // 在线时长更新、日志重放等可以等待的任务
+};
+
+inline constexpr size_t kJobPriorityCount = 4;
+
+struct JobClassStats {
+    size_t   pending     = 0;
+    uint64_t executed    = 0;
+    uint64_t starved     = 0;  // 因等待过久越过权重执行的次数
+    double   maxWaitMs   = 0;
+    double   totalWaitMs = 0;
+};
+
+// 数据库后台工作线程池：耗时的数据库操作在这里执行，不阻塞游戏主线程
+// 各优先级类别按权重轮转执行，等待超过 starvationMs 的任务优先执行，避免低优先级任务饿死
+class DatabaseExecutor {
+public:
+    using Job   = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    static DatabaseExecutor& getInstance();
+
+    void start(int threadCount);
+    void stop();  // 执行完队列中剩余的任务后停止
+    bool isRunning() const { return mRunning; }
+
+    // 投递任务；线程池未启动时直接在当前线程执行
+    void post(Job job, JobPriority priority = JobPriority::Background);
+
+    // 投递到指定串行队列（strand）：同一 key 的任务按投递顺序依次执行，
+    // 不同 key 之间在线程池上完全并行。用于保证同一玩家的离线保存先于下次加入的读取。
+    // strand 按其中优先级最高的任务参与调度：排在后台任务之后的加入读取不会以后台权重等待
+    void post(const std::string& strandKey, Job job, JobPriority priority = JobPriority::Background);
+
+    // 阻塞等待指定 strand 中已投递的任务全部完成
+    void waitForStrand(const std::string& strandKey);
+
+    bool hasPendingStrand(const std::string& strandKey) const;
+
+    size_t getPendingStrandCount() const;
+
+    std::array<JobClassStats, kJobPriorityCount> getStats() const;
+
+private:
+    DatabaseExecutor()  = default;
+    ~DatabaseExecutor() = default;
+
+    DatabaseExecutor(const DatabaseExecutor&)            = delete;
+    DatabaseExecutor& operator=(const DatabaseExecutor&) = delete;
+
+    struct QueuedJob {
+        Job               job;
+        Clock::time_point enqueuedAt;
+    };
+
+    struct Strand {
+        std::deque<std::pair<Job, JobPriority>> jobs;
+        uint64_t                                ticket   = 0;  // 当前有效的调度任务，0 表示未排队
+        JobPriority                             priority = JobPriority::Background;  // 调度任务的优先级
+        bool                                    running  = false;
+    };
+
+    void workerLoop();
+    bool hasQueuedJobs() const;
+    Job  takeNextJob();  // 调用方持有 mMutex
+    void runStrand(const std::string& strandKey, uint64_t ticket);
+    // 以新的 ticket 排队（之前排队的调度任务随之失效），返回 ticket；调用方持有 mStrandMutex
+    uint64_t scheduleStrand(Strand& strand, JobPriority priority);
+
+    std::vector<std::thread>                               mWorkers;
+    std::array<std::deque<QueuedJob>, kJobPriorityCount>   mQueues;
+    std::array<int, kJobPriorityCount>                     mWeights{8, 4, 2, 1};
+    std::array<int, kJobPriorityCount>                     mCredits{};
+    std::array<JobClassStats, kJobPriorityCount>           mStats;
+    Clock::duration                                        mStarvation = std::chrono::seconds(1);
+    mutable std::mutex                                     mMutex;
+    std::condition_variable                                mCv;
+    bool                                                   mRunning  = false;
+    bool                                                   mStopping = false;
+
+    std::unordered_map<std::string, Strand> mStrands;  // 只包含有待执行任务的 strand
+    uint64_t                                mNextTicket = 1;
+    mutable std::mutex                      mStrandMutex;
+    std::condition_variable                 mStrandCv;
+};
+
+} // namespace bdsmysql
@@ -0,0 +1,175 @@
+#include "mod/ItemRecord.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace bdsmysql {
+
+namespace {
+
+struct NameTable {
+    std::shared_mutex                              mutex;
+    std::deque<std::string>                        names{""};  // deque 追加元素不会移动已有元素
+    std::unordered_map<std::string_view, uint32_t> ids;
+};
+
+NameTable& nameTable() {
+    static NameTable table;
+    return table;
+}
+
+} // namespace
+
+uint32_t ItemNames::intern(std::string_view name) {
+    if (name.empty()) {
+        return 0;
+    }
+
+    auto& table = nameTable();
+    {
+        std::shared_lock lock(table.mutex);
+        if (auto it = table.ids.find(name); it != table.ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock lock(table.mutex);
+    if (auto it = table.ids.find(name); it != table.ids.end()) {
+        return it->second;
+    }
+    auto id = static_cast<uint32_t>(table.names.size());
+    table.ids.emplace(table.names.emplace_back(name), id);
+    return id;
+}
+
+std::string_view ItemNames::name(uint32_t id) {
+    if (id == 0) {
+        return {};
+    }
+    auto&            table = nameTable();
+    std::shared_lock lock(table.mutex);
+    return id < table.names.size() ? std::string_view(table.names[id]) : std::string_view{};
+}
+
+ItemList::ItemList(const ItemList& other) {
+    if (other.mSize == 0) {
+        return;
+    }
+    reallocate(other.mSize, other.mNbtSize);
+    std::memcpy(records(), other.records(), other.mSize * sizeof(ItemRecord));
+    std::memcpy(nbtData(), other.nbtData(), other.mNbtSize);
+    mSize    = other.mSize;
+    mNbtSize = other.mNbtSize;
+}
+
+ItemList::ItemList(ItemList&& other) noexcept
+: mBuffer(std::move(other.mBuffer)),
+  mSize(std::exchange(other.mSize, 0)),
+  mCapacity(std::exchange(other.mCapacity, 0)),
+  mNbtSize(std::exchange(other.mNbtSize, 0)),
+  mNbtCapacity(std::exchange(other.mNbtCapacity, 0)) {}
+
+ItemList& ItemList::operator=(const ItemList& other) {
+    if (this != &other) {
+        ItemList copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+ItemList& ItemList::operator=(ItemList&& other) noexcept {
+    mBuffer      = std::move(other.mBuffer);
+    mSize        = std::exchange(other.mSize, 0);
+    mCapacity    = std::exchange(other.mCapacity, 0);
+    mNbtSize     = std::exchange(other.mNbtSize, 0);
+    mNbtCapacity = std::exchange(other.mNbtCapacity, 0);
+    return *this;
+}
+
+void ItemList::reserve(size_t count, size_t nbtBytes) {
+    size_t capacity    = mSize + count;
+    size_t nbtCapacity = mNbtSize + nbtBytes;
+    if (capacity > mCapacity || nbtCapacity > mNbtCapacity) {
+        reallocate(std::max<size_t>(capacity, mCapacity), std::max<size_t>(nbtCapacity, mNbtCapacity));
+    }
+}
+
+void ItemList::add(int slot, std::string_view itemType, int count, int damage, std::string_view nbt) {
+    if (mSize == mCapacity || mNbtSize + nbt.size() > mNbtCapacity) {
+        // 未预留时按倍数增长
+        reallocate(
+            mSize == mCapacity ? std::max<size_t>(mCapacity * 2, 8) : mCapacity,
+            std::max<size_t>(mNbtCapacity * 2, mNbtSize + nbt.size())
+        );
+    }
+
+    ItemRecord record;
+    record.itemId    = ItemNames::intern(itemType);
+    record.nbtOffset = mNbtSize;
+    record.nbtSize   = static_cast<uint32_t>(nbt.size());
+    record.slot      = static_cast<uint8_t>(slot);
+    record.count     = static_cast<uint8_t>(count);
+    record.damage    = static_cast<int16_t>(damage);
+
+    std::memcpy(records() + mSize, &record, sizeof(ItemRecord));
+    if (!nbt.empty()) {
+        std::memcpy(nbtData() + mNbtSize, nbt.data(), nbt.size());
+    }
+    mSize++;
+    mNbtSize += record.nbtSize;
+}
+
+void ItemList::clear() {
+    mSize    = 0;
+    mNbtSize = 0;
+}
+
+size_t ItemList::countSlots(int firstSlot, int lastSlot) const {
+    return static_cast<size_t>(std::count_if(begin(), end(), [&](const ItemRecord& record) {
+        return record.slot >= firstSlot && record.slot <= lastSlot;
+    }));
+}
+
+bool ItemList::sameSlots(const ItemList& other) const {
+    std::array<const ItemRecord*, 256> mine{};
+    std::array<const ItemRecord*, 256> theirs{};
+    for (const auto& record : *this) {
+        if (!record.empty()) mine[record.slot] = &record;
+    }
+    for (const auto& record : other) {
+        if (!record.empty()) theirs[record.slot] = &record;
+    }
+
+    for (size_t slot = 0; slot < mine.size(); slot++) {
+        const ItemRecord* a = mine[slot];
+        const ItemRecord* b = theirs[slot];
+        if (!a || !b) {
+            if (a != b) return false;
+            continue;
+        }
+        if (a->itemId != b->itemId || a->count != b->count || a->damage != b->damage || nbt(*a) != other.nbt(*b)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ItemList::reallocate(size_t capacity, size_t nbtCapacity) {
+    auto buffer  = std::make_unique_for_overwrite<std::byte[]>(capacity * sizeof(ItemRecord) + nbtCapacity);
+    auto* target = buffer.get();
+    if (mBuffer) {
+        std::memcpy(target, mBuffer.get(), mSize * sizeof(ItemRecord));
+        std::memcpy(target + capacity * sizeof(ItemRecord), nbtData(), mNbtSize);
+    }
+    mBuffer      = std::move(buffer);
+    mCapacity    = static_cast<uint32_t>(capacity);
+    mNbtCapacity = static_cast<uint32_t>(nbtCapacity);
+}
+
+} // namespace bdsmysql
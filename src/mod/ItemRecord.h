@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace bdsmysql {
+
+// 物品类型名称驻留表：每种物品名称只保存一份，记录中只存 32 位 id（0 表示空槽位）。
+// 名称只增不减，返回的 string_view 在进程生命周期内有效，可在任意线程调用
+class ItemNames {
+public:
+    static uint32_t         intern(std::string_view name);
+    static std::string_view name(uint32_t id);
+};
+
+// 一个物品槽位（16 字节，可平凡复制）。NBT 文本保存在所属 ItemList 的缓冲区中
+struct ItemRecord {
+    uint32_t itemId    = 0;  // ItemNames 中的 id，0 表示空槽位
+    uint32_t nbtOffset = 0;
+    uint32_t nbtSize   = 0;
+    uint8_t  slot      = 0;  // 0-35 背包，36-39 头盔/胸甲/护腿/靴子，40 副手
+    uint8_t  count     = 0;
+    int16_t  damage    = 0;
+
+    bool             empty() const { return itemId == 0; }
+    std::string_view itemType() const { return ItemNames::name(itemId); }
+};
+
+static_assert(sizeof(ItemRecord) == 16);
+
+// 一个玩家的全部物品槽位。记录和 NBT 文本放在同一块内存中：[ItemRecord...][NBT 文本...]，
+// 预留足够空间后整个背包 + 装备只需一次分配；复制时按实际大小分配
+class ItemList {
+public:
+    static constexpr int kLastBackpackSlot   = 35;
+    static constexpr int kFirstEquipmentSlot = 36;
+    static constexpr int kLastEquipmentSlot  = 40;
+
+    ItemList() = default;
+    ItemList(const ItemList& other);
+    ItemList(ItemList&& other) noexcept;
+    ItemList& operator=(const ItemList& other);
+    ItemList& operator=(ItemList&& other) noexcept;
+    ~ItemList() = default;
+
+    // 为再追加 count 个记录和 nbtBytes 字节 NBT 预留空间
+    void reserve(size_t count, size_t nbtBytes);
+    void add(int slot, std::string_view itemType, int count, int damage, std::string_view nbt);
+    void clear();
+
+    size_t            size() const { return mSize; }
+    bool              empty() const { return mSize == 0; }
+    const ItemRecord* begin() const { return records(); }
+    const ItemRecord* end() const { return records() + mSize; }
+
+    std::string_view nbt(const ItemRecord& record) const { return {nbtData() + record.nbtOffset, record.nbtSize}; }
+
+    // 槽位在 [firstSlot, lastSlot] 内的记录数
+    size_t countSlots(int firstSlot, int lastSlot) const;
+
+    // 按槽位比较物品（类型、数量、耐久、NBT），与记录顺序无关，空槽位与缺少该槽位等价
+    bool sameSlots(const ItemList& other) const;
+
+private:
+    ItemRecord* records() const { return reinterpret_cast<ItemRecord*>(mBuffer.get()); }
+    char*       nbtData() const { return reinterpret_cast<char*>(mBuffer.get()) + mCapacity * sizeof(ItemRecord); }
+
+    void reallocate(size_t capacity, size_t nbtCapacity);
+
+    std::unique_ptr<std::byte[]> mBuffer;
+    uint32_t                     mSize        = 0;
+    uint32_t                     mCapacity    = 0;
+    uint32_t                     mNbtSize     = 0;
+    uint32_t                     mNbtCapacity = 0;
+};
+
+} // namespace bdsmysql
@@ -0,0 +1,127 @@
+#include "mod/JoinAdmission.h"
+#include "mod/Config.h"
+#include "mod/Log.h"
+#include <algorithm>
+
+namespace bdsmysql {
+
+namespace {
+
+double elapsedMs(JoinAdmission::Clock::time_point from, JoinAdmission::Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
+
+JoinAdmission& JoinAdmission::getInstance() {
+    static JoinAdmission instance;
+    return instance;
+}
+
+void JoinAdmission::start() {
+    auto& config = Config::getInstance().getDatabaseConfig().admission;
+
+    mMinLimit = std::max(config.minInFlight, 1);
+    mMaxLimit = std::max<double>(config.maxInFlight, mMinLimit);
+    mLimit    = std::clamp<double>(config.initialInFlight, mMinLimit, mMaxLimit);
+    mTargetMs = std::max(config.targetLatencyMs, 1);
+}
+
+JoinAdmission::Acquire JoinAdmission::acquire(const std::string& uuid, const std::string& name) {
+    // 同一玩家的旧请求（理论上不会出现）直接放弃
+    cancel(uuid);
+
+    uint64_t id    = mNextId++;
+    mLoading[uuid] = id;
+    return Acquire(uuid, name, id);
+}
+
+bool JoinAdmission::Acquire::await_ready() {
+    auto& admission = JoinAdmission::getInstance();
+    if (admission.mQueue.empty() && admission.hasCapacity()) {
+        admission.mInFlight++;
+        return true;
+    }
+    return false;
+}
+
+void JoinAdmission::Acquire::await_suspend(std::coroutine_handle<> handle) {
+    auto& admission = JoinAdmission::getInstance();
+    admission.mQueue.push_back({mId, mUuid, handle});
+
+    BDS_LOG_INFO(
+        "\033[33m[加入] 玩家 {} 排队等待加载 (排队: {}, 读取中: {}, 并发上限: {:.1f})\033[0m",
+        mName,
+        admission.mQueue.size(),
+        admission.mInFlight,
+        admission.mLimit
+    );
+}
+
+JoinAdmission::Slot::~Slot() {
+    if (mActive) {
+        JoinAdmission::getInstance().release();
+    }
+}
+
+void JoinAdmission::Slot::complete(double loadMs) {
+    if (mActive) {
+        JoinAdmission::getInstance().adjustLimit(loadMs);
+    }
+}
+
+void JoinAdmission::finish(const std::string& uuid) { mLoading.erase(uuid); }
+
+void JoinAdmission::cancel(const std::string& uuid) {
+    if (mLoading.erase(uuid) == 0) {
+        return;
+    }
+
+    // 仍在排队的协程尚未持有名额，直接销毁
+    auto it = std::find_if(mQueue.begin(), mQueue.end(), [&](const Waiter& waiter) { return waiter.uuid == uuid; });
+    if (it != mQueue.end()) {
+        auto handle = it->handle;
+        mQueue.erase(it);
+        handle.destroy();
+    }
+}
+
+void JoinAdmission::cancelAll() {
+    auto queue = std::move(mQueue);
+    mQueue.clear();
+    mLoading.clear();
+    for (auto& waiter : queue) {
+        waiter.handle.destroy();
+    }
+}
+
+void JoinAdmission::release() {
+    mInFlight--;
+    pump();
+}
+
+void JoinAdmission::pump() {
+    // 按加入顺序放行，保证排队的玩家不会被后来者插队
+    while (!mQueue.empty() && hasCapacity()) {
+        auto handle = mQueue.front().handle;
+        mQueue.pop_front();
+        mInFlight++;
+        handle.resume();
+    }
+}
+
+void JoinAdmission::adjustLimit(double loadMs) {
+    auto now = Clock::now();
+    if (loadMs > mTargetMs) {
+        // 每个读取周期最多降低一次，避免同一批慢请求把上限压到最低
+        if (elapsedMs(mLastDecrease, now) >= loadMs) {
+            mLimit        = std::max(mMinLimit, mLimit * 0.75);
+            mLastDecrease = now;
+        }
+    } else {
+        // 每完成约一轮（mLimit 个）读取增加 1
+        mLimit = std::min(mMaxLimit, mLimit + 1.0 / mLimit);
+    }
+}
+
+} // namespace bdsmysql
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "mod/Database.h"
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace bdsmysql {
+
+// 加入时读取的玩家数据（后台线程填充，主线程应用）
+struct PlayerLoadResult {
+    bool           fromCache        = false;  // 推送的快照经版本校验仍然有效
+    bool           hasSyncData      = false;
+    bool           hasInventoryData = false;
+    double         loadMs           = 0;  // 后台读取耗时
+    PlayerSnapshot snapshot;
+};
+
+// 加入准入控制：
+// 限制同时进行的加入读取数，其余按加入顺序排队；读取完成前玩家处于“加载中”状态。
+// 并发上限根据读取耗时自动调整（低于目标耗时缓慢增加，超过则成倍降低）
+//
+//   auto slot = co_await JoinAdmission::getInstance().acquire(uuid, name);
+//   ... 读取数据 ...
+//   slot.complete(loadMs);
+//   JoinAdmission::getInstance().finish(uuid);
+//
+// 所有方法只在主线程调用
+class JoinAdmission {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // 一个读取名额，析构时归还
+    class Slot {
+    public:
+        Slot() = default;
+        Slot(Slot&& other) noexcept : mActive(std::exchange(other.mActive, false)) {}
+        Slot& operator=(Slot&&) = delete;
+        ~Slot();
+
+        // 报告本次读取耗时，用于调整并发上限
+        void complete(double loadMs);
+
+    private:
+        friend class JoinAdmission;
+        explicit Slot(bool active) : mActive(active) {}
+
+        bool mActive = false;
+    };
+
+    class Acquire {
+    public:
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> handle);
+        Slot await_resume() noexcept { return Slot(true); }
+
+    private:
+        friend class JoinAdmission;
+        Acquire(std::string uuid, std::string name, uint64_t id) : mUuid(std::move(uuid)), mName(std::move(name)), mId(id) {}
+
+        std::string mUuid;
+        std::string mName;
+        uint64_t    mId;
+    };
+
+    static JoinAdmission& getInstance();
+
+    void start();
+
+    // 进入加载中状态并等待读取名额
+    Acquire acquire(const std::string& uuid, const std::string& name);
+
+    // 数据已应用：离开加载中状态
+    void finish(const std::string& uuid);
+
+    bool isLoading(const std::string& uuid) const { return mLoading.contains(uuid); }
+
+    // 玩家在数据应用前离线：离开加载中状态，仍在排队的协程直接销毁
+    void cancel(const std::string& uuid);
+    void cancelAll();
+
+    size_t getQueuedCount() const { return mQueue.size(); }
+    size_t getInFlightCount() const { return mInFlight; }
+    double getInFlightLimit() const { return mLimit; }
+
+private:
+    struct Waiter {
+        uint64_t                id = 0;
+        std::string             uuid;
+        std::coroutine_handle<> handle;
+    };
+
+    JoinAdmission()  = default;
+    ~JoinAdmission() = default;
+
+    JoinAdmission(const JoinAdmission&)            = delete;
+    JoinAdmission& operator=(const JoinAdmission&) = delete;
+
+    bool hasCapacity() const { return mInFlight < static_cast<size_t>(mLimit); }
+    void release();
+    void pump();
+    void adjustLimit(double loadMs);
+
+    std::deque<Waiter>                        mQueue;
+    std::unordered_map<std::string, uint64_t> mLoading;  // 排队中或读取中的玩家 -> 请求 id
+    size_t                                    mInFlight = 0;
+    double                                    mLimit    = 4;
+    double                                    mMinLimit = 1;
+    double                                    mMaxLimit = 16;
+    double                                    mTargetMs = 100;
+    Clock::time_point                         mLastDecrease;
+    uint64_t                                  mNextId = 1;
+};
+
+} // namespace bdsmysql
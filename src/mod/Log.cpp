@@ -0,0 +1,163 @@
+#include "mod/Log.h"
+#include "ll/api/io/Logger.h"
+#include "ll/api/mod/NativeMod.h"
+#include "mod/Config.h"
+#include <algorithm>
+#include <chrono>
+
+namespace bdsmysql {
+
+namespace {
+
+LogLevel parseLevel(std::string_view name) {
+    if (name == "trace") {
+        return LogLevel::Trace;
+    }
+    if (name == "debug") {
+        return LogLevel::Debug;
+    }
+    if (name == "warn") {
+        return LogLevel::Warn;
+    }
+    if (name == "error") {
+        return LogLevel::Error;
+    }
+    return LogLevel::Info;
+}
+
+} // namespace
+
+bool LogSite::admit(uint32_t& suppressed) {
+    auto    now    = std::chrono::steady_clock::now().time_since_epoch();
+    int64_t window = std::chrono::duration_cast<std::chrono::seconds>(now).count();
+
+    // 进入新窗口时重置计数（并发的调用点偶尔多放行一条，可以接受）
+    if (mWindow.load(std::memory_order_relaxed) != window) {
+        mWindow.store(window, std::memory_order_relaxed);
+        mCount.store(0, std::memory_order_relaxed);
+    }
+
+    int limit = AsyncLog::getInstance().perSiteLimit();
+    if (limit > 0 && mCount.fetch_add(1, std::memory_order_relaxed) >= static_cast<uint32_t>(limit)) {
+        mSuppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    suppressed = mSuppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+AsyncLog& AsyncLog::getInstance() {
+    static AsyncLog instance;
+    return instance;
+}
+
+void AsyncLog::start() {
+    const auto& config = Config::getInstance().getDatabaseConfig().log;
+    mLevel.store(static_cast<int>(parseLevel(config.level)), std::memory_order_relaxed);
+    mPerSiteLimit.store(config.perSiteLimit, std::memory_order_relaxed);
+
+    std::lock_guard lock(mMutex);
+    if (mRunning) {
+        return;
+    }
+    mLogger   = &ll::mod::NativeMod::current()->getLogger();
+    mCapacity = static_cast<size_t>(std::max(config.queueCapacity, 256));
+    mRunning  = true;
+    mThread   = std::thread([this] { run(); });
+}
+
+void AsyncLog::stop() {
+    {
+        std::lock_guard lock(mMutex);
+        if (!mRunning) {
+            return;
+        }
+        mRunning = false;
+    }
+    mCv.notify_all();
+
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+}
+
+void AsyncLog::push(LogLevel level, uint32_t suppressed, std::function<std::string()> format) {
+    {
+        std::lock_guard lock(mMutex);
+        if (mRunning) {
+            if (mQueue.size() >= mCapacity) {
+                mDropped++;
+                return;
+            }
+            mQueue.push_back({level, suppressed, std::move(format)});
+            if (mQueue.size() == 1) {
+                mCv.notify_one();
+            }
+            return;
+        }
+    }
+
+    // 输出线程未运行（启动前或关闭后）：同步输出
+    write({level, suppressed, std::move(format)});
+}
+
+void AsyncLog::write(const Record& record) {
+    auto& logger = mLogger ? *mLogger : ll::mod::NativeMod::current()->getLogger();
+
+    std::string text;
+    try {
+        text = record.format();
+    } catch (const std::exception& e) {
+        text = std::string("日志格式化失败: ") + e.what();
+    }
+    if (record.suppressed > 0) {
+        text += std::format(" (同一位置另有 {} 条日志被限流)", record.suppressed);
+    }
+
+    switch (record.level) {
+    case LogLevel::Trace:
+        logger.trace("{}", text);
+        break;
+    case LogLevel::Debug:
+        logger.debug("{}", text);
+        break;
+    case LogLevel::Info:
+        logger.info("{}", text);
+        break;
+    case LogLevel::Warn:
+        logger.warn("{}", text);
+        break;
+    case LogLevel::Error:
+        logger.error("{}", text);
+        break;
+    }
+}
+
+void AsyncLog::run() {
+    std::deque<Record> batch;
+    std::unique_lock   lock(mMutex);
+    while (true) {
+        mCv.wait(lock, [this] { return !mRunning || !mQueue.empty(); });
+        if (mQueue.empty()) {
+            break;  // 正在停止且队列已清空
+        }
+
+        batch.swap(mQueue);
+        uint64_t dropped = std::exchange(mDropped, 0);
+        lock.unlock();
+
+        for (const auto& record : batch) {
+            write(record);
+        }
+        batch.clear();
+        if (dropped > 0) {
+            write({LogLevel::Warn, 0, [dropped] {
+                       return std::format("\033[33m[日志] 日志队列已满，丢弃了 {} 条日志\033[0m", dropped);
+                   }});
+        }
+
+        lock.lock();
+    }
+}
+
+} // namespace bdsmysql
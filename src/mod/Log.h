@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <format>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ll::io {
+class Logger;
+}
+
+namespace bdsmysql {
+
+enum class LogLevel : int { Trace = 0, Debug, Info, Warn, Error };
+
+// 编译期最低日志级别（0=Trace, 1=Debug, 2=Info, 3=Warn, 4=Error）。
+// 低于该级别的 BDS_LOG_* 调用在编译时移除，参数也不会求值；发布构建可定义为 2 去掉全部调试日志
+#ifndef BDSMYSQL_LOG_LEVEL
+#define BDSMYSQL_LOG_LEVEL 1
+#endif
+
+inline constexpr LogLevel kCompiledLogLevel = static_cast<LogLevel>(BDSMYSQL_LOG_LEVEL);
+
+// 一个日志调用点的限流状态：每秒最多输出 log.perSiteLimit 条，其余计数，下次输出时附带被抑制的条数
+class LogSite {
+public:
+    // 允许输出时返回 true，suppressed 为上次输出以来被抑制的条数
+    bool admit(uint32_t& suppressed);
+
+private:
+    std::atomic<int64_t>  mWindow{-1};
+    std::atomic<uint32_t> mCount{0};
+    std::atomic<uint32_t> mSuppressed{0};
+};
+
+// 异步日志：调用线程只复制参数并入队，格式化和写控制台在后台线程完成。
+// 队列满时丢弃新日志并计数，不阻塞调用线程；未启动或已停止时在调用线程同步输出
+class AsyncLog {
+public:
+    static AsyncLog& getInstance();
+
+    void start();  // 读取配置（运行时级别、限流、队列容量）并启动输出线程
+    void stop();   // 输出队列中剩余的日志后停止
+
+    bool enabled(LogLevel level) const { return static_cast<int>(level) >= mLevel.load(std::memory_order_relaxed); }
+    int  perSiteLimit() const { return mPerSiteLimit.load(std::memory_order_relaxed); }
+
+    template <class... Args>
+    void submit(LogSite& site, LogLevel level, std::format_string<Args...> fmt, Args&&... args) {
+        uint32_t suppressed = 0;
+        if (!site.admit(suppressed)) {
+            return;
+        }
+        // 字符串类参数复制为 std::string，其余按值保存，调用返回后引用的数据可以失效
+        push(level, suppressed, [fmt = fmt.get(), stored = std::make_tuple(Stored<Args>(std::forward<Args>(args))...)] {
+            return std::apply(
+                [&](const auto&... values) { return std::vformat(fmt, std::make_format_args(values...)); },
+                stored
+            );
+        });
+    }
+
+private:
+    template <class T>
+    using Stored = std::conditional_t<std::is_convertible_v<const std::decay_t<T>&, std::string_view>, std::string, std::decay_t<T>>;
+
+    struct Record {
+        LogLevel                     level;
+        uint32_t                     suppressed;
+        std::function<std::string()> format;
+    };
+
+    AsyncLog()  = default;
+    ~AsyncLog() = default;
+
+    AsyncLog(const AsyncLog&)            = delete;
+    AsyncLog& operator=(const AsyncLog&) = delete;
+
+    void push(LogLevel level, uint32_t suppressed, std::function<std::string()> format);
+    void write(const Record& record);
+    void run();
+
+    std::atomic<int> mLevel{static_cast<int>(LogLevel::Info)};
+    std::atomic<int> mPerSiteLimit{20};
+
+    std::mutex              mMutex;
+    std::condition_variable mCv;
+    std::deque<Record>      mQueue;
+    size_t                  mCapacity = 8192;
+    uint64_t                mDropped  = 0;
+    bool                    mRunning  = false;
+    std::thread             mThread;
+    ll::io::Logger*         mLogger = nullptr;
+};
+
+} // namespace bdsmysql
+
+// 日志宏：级别低于 BDSMYSQL_LOG_LEVEL 时整条语句被移除；运行时级别关闭时不复制参数；
+// 每个调用点有独立的限流状态。用法与 Logger 相同：BDS_LOG_INFO("玩家 {} 加入", name);
+#define BDS_LOG(level, ...)                                                                      \
+    do {                                                                                         \
+        if constexpr ((level) >= ::bdsmysql::kCompiledLogLevel) {                                \
+            if (auto& bdsLog = ::bdsmysql::AsyncLog::getInstance(); bdsLog.enabled(level)) {     \
+                static ::bdsmysql::LogSite bdsLogSite;                                           \
+                bdsLog.submit(bdsLogSite, level, __VA_ARGS__);                                   \
+            }                                                                                    \
+        }                                                                                        \
+    } while (false)
+
+#define BDS_LOG_TRACE(...) BDS_LOG(::bdsmysql::LogLevel::Trace, __VA_ARGS__)
+#define BDS_LOG_DEBUG(...) BDS_LOG(::bdsmysql::LogLevel::Debug, __VA_ARGS__)
+#define BDS_LOG_INFO(...)  BDS_LOG(::bdsmysql::LogLevel::Info, __VA_ARGS__)
+#define BDS_LOG_WARN(...)  BDS_LOG(::bdsmysql::LogLevel::Warn, __VA_ARGS__)
+#define BDS_LOG_ERROR(...) BDS_LOG(::bdsmysql::LogLevel::Error, __VA_ARGS__)
@@ -1,6 +1,71 @@
 // This file will make your mod use LeviLamina's memory operators by default.
 // This improves the memory management of your mod and is recommended to use.
-
-#define LL_MEMORY_OPERATORS
+//
+// The operators are defined here instead of through LL_MEMORY_OPERATORS so that every allocation
+// can be counted by AllocStats (metrics.allocStats) before it is handed to LeviLamina's allocator.
 
 #include "ll/api/memory/MemoryOperators.h" // IWYU pragma: keep
+#include "mod/AllocStats.h"
+
+#include <new>
+
+namespace {
+
+void* allocate(size_t size) {
+    bdsmysql::AllocStats::onAllocate(size);
+    return ::ll::memory::getDefaultAllocator().allocate(size);
+}
+
+void* alignedAllocate(size_t size, std::align_val_t alignment) {
+    bdsmysql::AllocStats::onAllocate(size);
+    return ::ll::memory::getDefaultAllocator().alignedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void release(void* p) noexcept {
+    if (p) {
+        bdsmysql::AllocStats::onRelease();
+    }
+    ::ll::memory::getDefaultAllocator().release(p);
+}
+
+void alignedRelease(void* p) noexcept {
+    if (p) {
+        bdsmysql::AllocStats::onRelease();
+    }
+    ::ll::memory::getDefaultAllocator().alignedRelease(p);
+}
+
+} // namespace
+
+#pragma warning(push)
+#pragma warning(disable : 28251) // inconsistent annotation with the CRT declarations
+
+[[nodiscard]] void* operator new(size_t size) { return allocate(size); }
+[[nodiscard]] void* operator new[](size_t size) { return allocate(size); }
+[[nodiscard]] void* operator new(size_t size, std::nothrow_t const&) noexcept { return allocate(size); }
+[[nodiscard]] void* operator new[](size_t size, std::nothrow_t const&) noexcept { return allocate(size); }
+
+[[nodiscard]] void* operator new(size_t size, std::align_val_t al) { return alignedAllocate(size, al); }
+[[nodiscard]] void* operator new[](size_t size, std::align_val_t al) { return alignedAllocate(size, al); }
+[[nodiscard]] void* operator new(size_t size, std::align_val_t al, std::nothrow_t const&) noexcept {
+    return alignedAllocate(size, al);
+}
+[[nodiscard]] void* operator new[](size_t size, std::align_val_t al, std::nothrow_t const&) noexcept {
+    return alignedAllocate(size, al);
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, std::nothrow_t const&) noexcept { release(p); }
+void operator delete[](void* p, std::nothrow_t const&) noexcept { release(p); }
+void operator delete(void* p, size_t) noexcept { release(p); }
+void operator delete[](void* p, size_t) noexcept { release(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { alignedRelease(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedRelease(p); }
+void operator delete(void* p, std::align_val_t, std::nothrow_t const&) noexcept { alignedRelease(p); }
+void operator delete[](void* p, std::align_val_t, std::nothrow_t const&) noexcept { alignedRelease(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { alignedRelease(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { alignedRelease(p); }
+
+#pragma warning(pop)
@@ -0,0 +1,321 @@
+#include "mod/Metrics.h"
+#include "ll/api/io/Logger.h"
+#include "ll/api/mod/NativeMod.h"
+#include "mod/Config.h"
+#include "mod/Log.h"
+#include "mod/Tracer.h"
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <format>
+#include <fstream>
+
+namespace bdsmysql {
+
+namespace {
+
+// 一个分片只由所属线程写入：relaxed 读-写即可，不需要原子读改写
+void bump(std::atomic<uint64_t>& cell, uint64_t value) {
+    cell.store(cell.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+} // namespace
+
+double HistogramSnapshot::percentileMs(double quantile) const {
+    if (count == 0) {
+        return 0.0;
+    }
+
+    auto     target = static_cast<uint64_t>(std::max(quantile * static_cast<double>(count), 1.0));
+    uint64_t seen   = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen >= target) {
+            // 取桶的中点，不超过实际最大值
+            uint64_t lower = Metrics::bucketLowerBound(i);
+            uint64_t upper = i + 1 < buckets.size() ? Metrics::bucketLowerBound(i + 1) : lower + 1;
+            return static_cast<double>(std::min(lower + (upper - lower) / 2, maxUs)) / 1000.0;
+        }
+    }
+    return static_cast<double>(maxUs) / 1000.0;
+}
+
+Metrics& Metrics::getInstance() {
+    static Metrics instance;
+    return instance;
+}
+
+Metrics::Metrics() {
+    mHistogramNames.reserve(kMaxMetrics);
+    mCounterNames.reserve(kMaxMetrics);
+}
+
+Metrics::Shard::~Shard() {
+    for (auto& cells : histograms) {
+        delete cells.load(std::memory_order_relaxed);
+    }
+}
+
+size_t Metrics::bucketIndex(uint64_t us) {
+    us = std::min<uint64_t>(us, (uint64_t{1} << (kMaxExponent + 1)) - 1);
+    if (us < (1u << kSubBits)) {
+        return static_cast<size_t>(us);
+    }
+    int exponent = std::bit_width(us) - 1;
+    int shift    = exponent - kSubBits;
+    return static_cast<size_t>(shift) * (1u << kSubBits) + static_cast<size_t>(us >> shift);
+}
+
+uint64_t Metrics::bucketLowerBound(size_t index) {
+    constexpr size_t kSubBuckets = 1u << kSubBits;
+    if (index < 2 * kSubBuckets) {
+        return index;
+    }
+    size_t shift = index / kSubBuckets - 1;
+    return static_cast<uint64_t>(index % kSubBuckets + kSubBuckets) << shift;
+}
+
+MetricId Metrics::registerName(std::vector<std::string>& names, std::string_view name) {
+    std::lock_guard lock(mMutex);
+    auto            it = std::find(names.begin(), names.end(), name);
+    if (it != names.end()) {
+        return static_cast<MetricId>(it - names.begin());
+    }
+    if (names.size() >= kMaxMetrics) {
+        BDS_LOG_WARN("\033[33m[指标] 指标数量已达上限，忽略: {}\033[0m", name);
+        return static_cast<MetricId>(kMaxMetrics);
+    }
+    names.emplace_back(name);
+    return static_cast<MetricId>(names.size() - 1);
+}
+
+MetricId Metrics::histogram(std::string_view name) { return registerName(mHistogramNames, name); }
+
+MetricId Metrics::counter(std::string_view name) { return registerName(mCounterNames, name); }
+
+std::string_view Metrics::histogramName(MetricId id) const {
+    // id 来自 histogram() 的返回值，对应的名称已经写入；不读取 size()，避免与注册并发
+    return id < kMaxMetrics ? std::string_view(mHistogramNames.data()[id]) : std::string_view{};
+}
+
+void Metrics::gauge(std::string_view name, std::function<double()> read) {
+    std::lock_guard lock(mMutex);
+    auto it = std::find_if(mGauges.begin(), mGauges.end(), [&](const auto& gauge) { return gauge.first == name; });
+    if (it != mGauges.end()) {
+        it->second = std::move(read);
+    } else {
+        mGauges.emplace_back(name, std::move(read));
+    }
+}
+
+Metrics::Shard& Metrics::localShard() {
+    thread_local Shard* shard = nullptr;
+    if (!shard) {
+        auto            owned = std::make_unique<Shard>();
+        std::lock_guard lock(mMutex);
+        shard = mShards.emplace_back(std::move(owned)).get();
+    }
+    return *shard;
+}
+
+void Metrics::record(MetricId id, Clock::duration elapsed) {
+    if (id >= kMaxMetrics) {
+        return;
+    }
+
+    auto& slot  = localShard().histograms[id];
+    auto* cells = slot.load(std::memory_order_relaxed);
+    if (!cells) {
+        cells = new HistogramCells;
+        slot.store(cells, std::memory_order_release);
+    }
+
+    auto us = static_cast<uint64_t>(std::max<int64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count(),
+        0
+    ));
+    bump(cells->buckets[bucketIndex(us)], 1);
+    bump(cells->count, 1);
+    bump(cells->sumUs, us);
+    if (us > cells->maxUs.load(std::memory_order_relaxed)) {
+        cells->maxUs.store(us, std::memory_order_relaxed);
+    }
+}
+
+void Metrics::add(MetricId id, uint64_t value) {
+    if (id >= kMaxMetrics) {
+        return;
+    }
+    bump(localShard().counters[id], value);
+}
+
+std::vector<HistogramSnapshot> Metrics::histograms() const {
+    std::lock_guard lock(mMutex);
+
+    std::vector<HistogramSnapshot> result(mHistogramNames.size());
+    for (size_t id = 0; id < result.size(); id++) {
+        auto& snapshot = result[id];
+        snapshot.name  = mHistogramNames[id];
+        snapshot.buckets.assign(kBucketCount, 0);
+
+        for (const auto& shard : mShards) {
+            const auto* cells = shard->histograms[id].load(std::memory_order_acquire);
+            if (!cells) {
+                continue;
+            }
+            for (size_t i = 0; i < kBucketCount; i++) {
+                snapshot.buckets[i] += cells->buckets[i].load(std::memory_order_relaxed);
+            }
+            snapshot.count += cells->count.load(std::memory_order_relaxed);
+            snapshot.sumUs += cells->sumUs.load(std::memory_order_relaxed);
+            snapshot.maxUs  = std::max(snapshot.maxUs, cells->maxUs.load(std::memory_order_relaxed));
+        }
+    }
+    return result;
+}
+
+std::vector<CounterSnapshot> Metrics::counters() const {
+    std::lock_guard lock(mMutex);
+
+    std::vector<CounterSnapshot> result(mCounterNames.size());
+    for (size_t id = 0; id < result.size(); id++) {
+        result[id].name = mCounterNames[id];
+        for (const auto& shard : mShards) {
+            result[id].value += shard->counters[id].load(std::memory_order_relaxed);
+        }
+    }
+    return result;
+}
+
+std::vector<GaugeSnapshot> Metrics::gauges() const {
+    std::lock_guard lock(mMutex);
+
+    std::vector<GaugeSnapshot> result;
+    result.reserve(mGauges.size());
+    for (const auto& [name, read] : mGauges) {
+        result.push_back({name, read()});
+    }
+    return result;
+}
+
+std::string Metrics::exposition() const {
+    auto        latencies = histograms();
+    std::string out;
+
+    out += "# HELP bdsmysql_latency_seconds Latency of database calls, capture/apply stages and transfers.\n";
+    out += "# TYPE bdsmysql_latency_seconds summary\n";
+    for (const auto& h : latencies) {
+        for (double quantile : {0.5, 0.9, 0.99, 0.999}) {
+            out += std::format(
+                "bdsmysql_latency_seconds{{name=\"{}\",quantile=\"{}\"}} {:.6f}\n",
+                h.name,
+                quantile,
+                h.percentileMs(quantile) / 1000.0
+            );
+        }
+        out += std::format("bdsmysql_latency_seconds_sum{{name=\"{}\"}} {:.6f}\n", h.name, h.sumUs / 1e6);
+        out += std::format("bdsmysql_latency_seconds_count{{name=\"{}\"}} {}\n", h.name, h.count);
+    }
+
+    out += "# HELP bdsmysql_latency_max_seconds Largest latency observed since start.\n";
+    out += "# TYPE bdsmysql_latency_max_seconds gauge\n";
+    for (const auto& h : latencies) {
+        out += std::format("bdsmysql_latency_max_seconds{{name=\"{}\"}} {:.6f}\n", h.name, h.maxUs / 1e6);
+    }
+
+    out += "# HELP bdsmysql_gauge Current values (e.g. main-thread milliseconds used per tick).\n";
+    out += "# TYPE bdsmysql_gauge gauge\n";
+    for (const auto& g : gauges()) {
+        out += std::format("bdsmysql_gauge{{name=\"{}\"}} {:.3f}\n", g.name, g.value);
+    }
+
+    out += "# HELP bdsmysql_events_total Event counters.\n";
+    out += "# TYPE bdsmysql_events_total counter\n";
+    for (const auto& c : counters()) {
+        out += std::format("bdsmysql_events_total{{name=\"{}\"}} {}\n", c.name, c.value);
+    }
+    return out;
+}
+
+void Metrics::start() {
+    const auto& config = Config::getInstance().getDatabaseConfig().metrics;
+    if (config.exportIntervalSeconds <= 0) {
+        return;
+    }
+
+    std::lock_guard lock(mExportMutex);
+    if (mRunning) {
+        return;
+    }
+    auto mod    = ll::mod::NativeMod::current();
+    mExportPath = (mod->getModDir() / config.exportFile).string();
+    mRunning    = true;
+    mThread     = std::thread([this] { run(); });
+
+    BDS_LOG_INFO(
+        "\033[32m[指标] 每 {} 秒写入指标文件: {}\033[0m",
+        config.exportIntervalSeconds,
+        mExportPath
+    );
+}
+
+void Metrics::stop() {
+    {
+        std::lock_guard lock(mExportMutex);
+        if (!mRunning) {
+            return;
+        }
+        mRunning = false;
+    }
+    mExportCv.notify_all();
+
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+    // 关服前写入最后一份
+    writeExposition();
+}
+
+void Metrics::run() {
+    const auto& config   = Config::getInstance().getDatabaseConfig().metrics;
+    auto        interval = std::chrono::seconds(config.exportIntervalSeconds);
+
+    std::unique_lock lock(mExportMutex);
+    while (mRunning) {
+        if (mExportCv.wait_for(lock, interval, [this] { return !mRunning; })) {
+            break;
+        }
+        lock.unlock();
+        writeExposition();
+        lock.lock();
+    }
+}
+
+void Metrics::writeExposition() {
+    // 先写临时文件再替换，读取方不会看到写了一半的文件
+    try {
+        std::filesystem::path path(mExportPath);
+        std::filesystem::create_directories(path.parent_path());
+
+        auto temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream file(temp, std::ios::trunc);
+            file << exposition();
+        }
+        std::filesystem::rename(temp, path);
+    } catch (const std::exception& e) {
+        BDS_LOG_WARN("\033[33m[指标] 写入指标文件失败: {}\033[0m", e.what());
+    }
+}
+
+ScopedTimer::~ScopedTimer() {
+    auto  end     = Metrics::Clock::now();
+    auto& metrics = Metrics::getInstance();
+    metrics.record(mId, end - mStart);
+    if (Tracer::enabled()) {
+        Tracer::getInstance().complete(metrics.histogramName(mId), mStart, end);
+    }
+}
+
+} // namespace bdsmysql
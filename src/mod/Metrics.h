@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bdsmysql {
+
+using MetricId = uint32_t;
+
+// 延迟直方图的汇总结果（所有线程合并）
+struct HistogramSnapshot {
+    std::string           name;
+    uint64_t              count = 0;
+    uint64_t              sumUs = 0;
+    uint64_t              maxUs = 0;
+    std::vector<uint64_t> buckets;
+
+    double meanMs() const { return count ? static_cast<double>(sumUs) / count / 1000.0 : 0.0; }
+    double percentileMs(double quantile) const;
+};
+
+struct CounterSnapshot {
+    std::string name;
+    uint64_t    value = 0;
+};
+
+struct GaugeSnapshot {
+    std::string name;
+    double      value = 0;
+};
+
+// 热路径指标：计数器、延迟直方图和仪表。
+// 每个线程写入自己的分片（只有本线程写入，无锁、无原子读改写），读取时合并所有分片。
+// 直方图按对数-线性分桶（每个 2 的幂区间 16 个桶，相对误差约 6%），单位微秒，上限约 71 分钟
+class Metrics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kMaxMetrics  = 128;  // 直方图和计数器各自的上限，超出后注册返回无效 id
+    static constexpr int    kSubBits     = 4;
+    static constexpr int    kMaxExponent = 31;
+    static constexpr size_t kBucketCount = (kMaxExponent - kSubBits + 1) * (1u << kSubBits) + (1u << kSubBits);
+
+    static Metrics& getInstance();
+
+    // 注册指标，同名返回同一 id。通常保存在函数内的静态变量中，只在第一次调用时查找
+    MetricId histogram(std::string_view name);
+    MetricId counter(std::string_view name);
+
+    // 仪表：读取时调用 read 取当前值（在读取线程调用，不能再调用 Metrics）
+    void gauge(std::string_view name, std::function<double()> read);
+
+    void record(MetricId id, Clock::duration elapsed);
+    void add(MetricId id, uint64_t value = 1);
+
+    // 直方图名称，不加锁（名称表预留了全部容量，注册后不会移动）
+    std::string_view histogramName(MetricId id) const;
+
+    std::vector<HistogramSnapshot> histograms() const;
+    std::vector<CounterSnapshot>   counters() const;
+    std::vector<GaugeSnapshot>     gauges() const;
+
+    // 文本格式（与 Prometheus 文本格式兼容）
+    std::string exposition() const;
+
+    // 按配置的间隔把 exposition() 写入文件
+    void start();
+    void stop();
+
+    static size_t   bucketIndex(uint64_t us);
+    static uint64_t bucketLowerBound(size_t index);
+
+private:
+    struct HistogramCells {
+        std::array<std::atomic<uint64_t>, kBucketCount> buckets{};
+        std::atomic<uint64_t>                           count{0};
+        std::atomic<uint64_t>                           sumUs{0};
+        std::atomic<uint64_t>                           maxUs{0};
+    };
+
+    // 一个线程的全部指标。线程退出后分片保留，已记录的数据不会丢失
+    struct Shard {
+        std::array<std::atomic<HistogramCells*>, kMaxMetrics> histograms{};
+        std::array<std::atomic<uint64_t>, kMaxMetrics>        counters{};
+
+        ~Shard();
+    };
+
+    Metrics();
+    ~Metrics() = default;
+
+    Metrics(const Metrics&)            = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    Shard&   localShard();
+    MetricId registerName(std::vector<std::string>& names, std::string_view name);
+    void     run();
+    void     writeExposition();
+
+    mutable std::mutex                                           mMutex;  // 保护名称表、仪表和分片列表
+    std::vector<std::string>                                     mHistogramNames;
+    std::vector<std::string>                                     mCounterNames;
+    std::vector<std::pair<std::string, std::function<double()>>> mGauges;
+    std::vector<std::unique_ptr<Shard>>                          mShards;
+
+    std::thread             mThread;
+    std::mutex              mExportMutex;
+    std::condition_variable mExportCv;
+    bool                    mRunning = false;
+    std::string             mExportPath;
+};
+
+// 作用域计时：析构时把耗时记入直方图，追踪开启时同时记录一个同名的时间段
+class ScopedTimer {
+public:
+    explicit ScopedTimer(MetricId id) : mId(id), mStart(Metrics::Clock::now()) {}
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer&)            = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    MetricId                   mId;
+    Metrics::Clock::time_point mStart;
+};
+
+} // namespace bdsmysql
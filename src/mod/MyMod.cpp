@@ -5,7 +5,15 @@
 #include "ll/api/event/player/PlayerJoinEvent.h"
 #include "ll/api/event/player/PlayerDisconnectEvent.h"
 #include "ll/api/event/server/ServerStoppingEvent.h"
+#include "ll/api/event/entity/ActorHurtEvent.h"
+#include "ll/api/event/player/PlayerAttackEvent.h"
+#include "ll/api/event/player/PlayerDestroyBlockEvent.h"
+#include "ll/api/event/player/PlayerInteractBlockEvent.h"
+#include "ll/api/event/player/PlayerPickUpItemEvent.h"
+#include "ll/api/event/player/PlayerPlaceBlockEvent.h"
+#include "ll/api/event/player/PlayerUseItemEvent.h"
 #include "ll/api/command/CommandHandle.h"
+#include "ll/api/service/Bedrock.h"
 #include "mc/server/commands/CommandOutput.h"
 #include "mc/world/actor/player/Player.h"
 #include "mc/world/actor/Actor.h"
@@ -19,13 +27,32 @@
 #include "mc/world/actor/player/Inventory.h"
 #include "mc/deps/core/utility/optional_ref.h"
 #include "mc/nbt/CompoundTag.h"
+#include "mc/platform/UUID.h"
 #include "mc/network/packet/TransferPacket.h"
 #include "mc/network/packet/UpdateAttributesPacket.h"
 #include "mc/server/commands/MinecraftCommands.h"
 #include "mc/server/commands/CommandOrigin.h"
 #include "mc/world/level/CommandOriginSystem.h"
 #include "mc/server/commands/CurrentCmdVersion.h"
+#include "mod/Log.h"
+#include "mod/AllocStats.h"
+#include "mod/BdsPlayerState.h"
 #include "mod/ServerConfig.h"
+#include "mod/ChangeLogTailer.h"
+#include "mod/CompletionQueue.h"
+#include "mod/DatabaseAsync.h"
+#include "mod/DatabaseExecutor.h"
+#include "mod/JoinAdmission.h"
+#include "mod/Metrics.h"
+#include "mod/PeerChannel.h"
+#include "mod/PlayerPipeline.h"
+#include "mod/QueryRecorder.h"
+#include "mod/SaveQueue.h"
+#include "mod/SlowQueryLog.h"
+#include "mod/SnapshotCache.h"
+#include "mod/TickUsage.h"
+#include "mod/Tracer.h"
+#include "mod/TransferPipeline.h"
 #include <chrono>
 #include <ctime>
 #include <iomanip>
@@ -44,10 +71,10 @@ MyMod& MyMod::getInstance() {
 }
 
 bool MyMod::load() {
-    getSelf().getLogger().debug("\033[33m[BDSmysql] 正在加载插件...\033[0m");
+    BDS_LOG_DEBUG("\033[33m[BDSmysql] 正在加载插件...\033[0m");
 
     if (!Config::getInstance().load()) {
-        getSelf().getLogger().error("\033[31m[BDSmysql] 加载配置文件失败！\033[0m");
+        BDS_LOG_ERROR("\033[31m[BDSmysql] 加载配置文件失败！\033[0m");
         return false;
     }
 
@@ -55,28 +82,66 @@ bool MyMod::load() {
 }
 
 bool MyMod::enable() {
-    getSelf().getLogger().debug("\033[33m[BDSmysql] 正在启用插件...\033[0m");
+    BDS_LOG_DEBUG("\033[33m[BDSmysql] 正在启用插件...\033[0m");
 
     if (!Config::getInstance().load()) {
-        getSelf().getLogger().error("\033[31m[BDSmysql] 加载配置文件失败！\033[0m");
+        BDS_LOG_ERROR("\033[31m[BDSmysql] 加载配置文件失败！\033[0m");
         return false;
     }
 
+    // 异步日志（读取 log.* 配置；在此之前的日志同步输出）
+    AsyncLog::getInstance().start();
+
     if (!ServerConfigManager::getInstance().load()) {
-        getSelf().getLogger().error("\033[31m[BDSmysql] 加载服务器配置文件失败！\033[0m");
+        BDS_LOG_ERROR("\033[31m[BDSmysql] 加载服务器配置文件失败！\033[0m");
         return false;
     }
 
+    // 操作追踪（trace.enabled 为 true 时从启动开始记录）
+    Tracer::setThreadName("main");
+    Tracer::getInstance().start();
+
+    // 慢查询日志（在连接数据库之前启动，建表和启动阶段的查询也会记录）
+    SlowQueryLog::getInstance().start();
+
+    // 查询录制（recorder.enabled 为 true 时从启动开始录制）
+    QueryRecorder::getInstance().start();
+
     if (!Database::getInstance().connect()) {
-        getSelf().getLogger().error("\033[31m[BDSmysql] 连接数据库失败！\033[0m");
+        BDS_LOG_ERROR("\033[31m[BDSmysql] 连接数据库失败！\033[0m");
         return false;
     }
 
     if (!Database::getInstance().initTables()) {
-        getSelf().getLogger().error("\033[31m[BDSmysql] 初始化数据表失败！\033[0m");
+        BDS_LOG_ERROR("\033[31m[BDSmysql] 初始化数据表失败！\033[0m");
         return false;
     }
 
+    // 后台结果每 tick 在时间预算内回到主线程处理
+    CompletionQueue::getInstance().start();
+
+    // 后台线程数 = 连接池大小 - 1，保留一个连接给主线程
+    DatabaseExecutor::getInstance().start(std::max(Config::getInstance().getDatabaseConfig().poolSize - 1, 1));
+
+    // 服务器间快照推送通道（可选，启动失败不影响插件）
+    PeerChannel::getInstance().start();
+
+    // 追踪变更日志，失效其它服务器已更新的缓存快照
+    ChangeLogTailer::getInstance().start();
+
+    // 保存队列（重放上次未能写入数据库的快照）
+    SaveQueue::getInstance().start();
+
+    // 加入准入控制
+    JoinAdmission::getInstance().start();
+
+    // 主线程耗时归因（注册每 tick 占用时间仪表），之后定期写入指标文件
+    TickUsage::getInstance().start();
+    if (Config::getInstance().getDatabaseConfig().metrics.allocStats) {
+        AllocStats::enable();
+    }
+    Metrics::getInstance().start();
+
     auto& eventBus = ll::event::EventBus::getInstance();
 
     eventBus.emplaceListener<ll::event::PlayerJoinEvent>(
@@ -99,390 +164,214 @@ bool MyMod::enable() {
         }
     );
 
+    // 数据加载完成前禁止玩家改变背包或受到伤害
+    registerLoadingGuards();
+
     // 注册 /tpserver 命令
     registerCommands();
 
-    getSelf().getLogger().info("\033[1;32m[BDSmysql] 插件启用成功！\033[0m");
+    BDS_LOG_INFO("\033[1;32m[BDSmysql] 插件启用成功！\033[0m");
     return true;
 }
 
 bool MyMod::disable() {
-    getSelf().getLogger().debug("\033[33m[BDSmysql] 正在禁用插件...\033[0m");
+    BDS_LOG_DEBUG("\033[33m[BDSmysql] 正在禁用插件...\033[0m");
 
+    // 先等待后台任务全部提交，再断开数据库
+    TransferPipeline::getInstance().cancelAll();
+    JoinAdmission::getInstance().cancelAll();
+    for (auto& [uuid, token] : mPlayerTokens) {
+        token.cancel();
+    }
+    mPlayerTokens.clear();
+    PeerChannel::getInstance().stop();
+    ChangeLogTailer::getInstance().stop();
+    SnapshotCache::getInstance().clear();
+    DatabaseExecutor::getInstance().stop();
+    CompletionQueue::getInstance().stop();
+    SaveQueue::getInstance().stop();
+    SlowQueryLog::getInstance().stop();
+    QueryRecorder::getInstance().stop();
     Database::getInstance().disconnect();
-    getSelf().getLogger().info("\033[32m[BDSmysql] 插件禁用成功！\033[0m");
+    Metrics::getInstance().stop();
+    BDS_LOG_INFO("\033[32m[BDSmysql] 插件禁用成功！\033[0m");
+    AsyncLog::getInstance().stop();  // 最后停止，输出队列中剩余的日志
     return true;
 }
 
 void MyMod::onPlayerJoin(Player& player) {
     std::string uuid = player.getUuid().asString();
+    TraceKey    traceKey(uuid);  // 先于计时作用域设置，入口本身的时间段也归入该玩家
+
+    static const auto kSite = TickUsage::site("PlayerJoinEvent");
+    StallScope        scope(kSite);
+
     std::string name = player.getRealName();
     std::string xuid = player.getXuid();
 
     auto now = std::chrono::system_clock::now();
     mPlayerJoinTimes[uuid] = now;
 
-    getSelf().getLogger().info("\033[32m[玩家] 玩家 {} ({}) 加入了服务器\033[0m", name, uuid);
-
-    auto& serverPlayer = static_cast<ServerPlayer&>(player);
-    std::string serverName = Config::getInstance().getDatabaseConfig().serverName;
-
-    // ===== 处理玩家属性数据（生命值、饱食度、经验） =====
-    PlayerSyncData syncData;
-    bool hasSyncData = Database::getInstance().isPlayerExists(uuid) && Database::getInstance().loadPlayerSyncData(uuid, serverName, syncData);
-
-    if (!hasSyncData) {
-        // 玩家没有数据库数据：创建默认记录
-        getSelf().getLogger().info("\033[33m[经验同步] 玩家 {} 没有数据库数据，创建默认记录\033[0m", name);
-        
-        // 收集玩家当前状态并保存
-        syncData.uuid = uuid;
-        syncData.serverName = serverName;
-        syncData.gamemode = static_cast<int>(player.getPlayerGameType());
-
-        auto healthAttr = player.getAttribute(SharedAttributes::HEALTH());
-        syncData.health = static_cast<int>(healthAttr.mCurrentValue);
-        syncData.maxHealth = static_cast<int>(healthAttr.mCurrentMaxValue);
-
-        auto hungerAttr = player.getAttribute(Player::HUNGER());
-        syncData.food = static_cast<int>(hungerAttr.mCurrentValue);
-
-        auto saturationAttr = player.getAttribute(Player::SATURATION());
-        syncData.foodSaturation = static_cast<float>(saturationAttr.mCurrentValue);  // 修复：改为float类型
-
-        auto xpAttr = player.getAttribute(Player::EXPERIENCE());
-        syncData.expLevel = static_cast<int>(xpAttr.mCurrentMaxValue);
-        syncData.expPoints = static_cast<int>(xpAttr.mCurrentValue * 100);
-
-        Database::getInstance().savePlayerSyncData(syncData);
-        getSelf().getLogger().info("\033[32m[数据同步] 已创建玩家 {} 的默认数据记录\033[0m", name);
-    } else {
-        // 玩家有数据库数据：直接加载属性（在主线程中）
-        getSelf().getLogger().info("\033[33m[数据同步] 玩家 {} 有数据库数据，正在加载\033[0m", name);
-        getSelf().getLogger().info("\033[33m[数据同步] 数据库数据 - 生命值: " + std::to_string(syncData.health) + 
-            ", 饱食度: " + std::to_string(syncData.food) + 
-            ", 饱和度: " + std::to_string(syncData.foodSaturation) + 
-            ", 经验等级: " + std::to_string(syncData.expLevel) + 
-            ", 经验点数: " + std::to_string(syncData.expPoints) + "\033[0m");
-
-        // 直接设置玩家属性
-        setPlayerAttributesDelayed(player, syncData);
-        getSelf().getLogger().info("\033[32m[数据同步] 属性加载完成\033[0m");
+    BDS_LOG_INFO("\033[32m[玩家] 玩家 {} ({}) 加入了服务器\033[0m", name, uuid);
+
+    // ===== 跨服传送：优先使用源服务器推送的快照 =====
+    PlayerSnapshot cached;
+    bool           validated = false;
+    bool           hasCached = SnapshotCache::getInstance().take(uuid, cached, validated);
+    scope.stage("snapshotCache");
+
+    // 变更日志轮询已确认过、且没有尚未完成的离线保存或本地日志中的快照时，无需访问数据库
+    if (hasCached && validated && !DatabaseExecutor::getInstance().hasPendingStrand(uuid)
+        && !SaveQueue::getInstance().hasJournaled(uuid)) {
+        static const auto kPushHits = Metrics::getInstance().counter("join.pushedSnapshot");
+        Metrics::getInstance().add(kPushHits);
+        BdsPlayerState state(player);
+        state.applyAttributes(cached.syncData);
+        scope.stage("applyAttributes");
+        state.applyInventory(cached.items);
+        scope.stage("applyInventory");
+        SaveQueue::getInstance().noteVersion(uuid, cached.version);
+        BDS_LOG_INFO("\033[32m[快照推送] 已从推送的快照加载玩家 {} 的数据 (版本 {})\033[0m", name, cached.version);
+        DatabaseExecutor::getInstance().post(
+            uuid,
+            [uuid, name, xuid] { PlayerPipeline::getInstance().updatePlayerRecord(uuid, name, xuid); },
+            JobPriority::Background
+        );
+        return;
     }
 
-    // ===== 处理背包和装备数据 =====
-    // 先检查是否有数据库数据
-    std::vector<PlayerBackpackItem> tempBackpack;
-    std::vector<PlayerEquipmentItem> tempEquipment;
-    bool hasBackpackData = Database::getInstance().loadPlayerBackpack(uuid, serverName, tempBackpack);
-    bool hasEquipmentData = Database::getInstance().loadPlayerEquipment(uuid, serverName, tempEquipment);
-    bool hasInventoryData = hasBackpackData || hasEquipmentData;
-
-    if (!hasInventoryData) {
-        // ===== 玩家没有数据库数据：保存当前背包和装备到数据库 =====
-        getSelf().getLogger().info("\033[33m[数据同步] 玩家 {} 没有背包/装备数据，保存当前数据到数据库\033[0m", name);
-
-        // ===== 保存背包数据（槽位 0-35） =====
-        getSelf().getLogger().info("\033[33m[背包同步] 正在保存玩家 {} 的背包数据（槽位 0-35）...\033[0m", name);
-        std::vector<PlayerBackpackItem> backpackItems;
-        auto& playerInv = player.getInventory();
-        int containerSize = playerInv.getContainerSize();
-
-        int inventorySlots = std::min(containerSize, 36);
-        for (int i = 0; i < inventorySlots; i++) {
-            auto& itemStack = playerInv.getItem(i);
-            
-            PlayerBackpackItem item;
-            item.slot = i;
-            item.itemType = "";  // 空槽位的类型为空字符串
-            item.count = 0;
-            item.damage = 0;
-            item.nbt = "";
-            
-            if (!itemStack.isNull()) {
-                if (itemStack.mItem) {
-                    item.itemType = itemStack.mItem->getSerializedName();
-                }
-                item.count = static_cast<int>(itemStack.mCount);
-                item.damage = itemStack.mAuxValue;
-                if (itemStack.mUserData) {
-                    try {
-                        item.nbt = itemStack.mUserData->toSnbt();
-                    } catch (const std::exception& e) {
-                        getSelf().getLogger().warn("\033[33m[背包同步] 序列化背包物品 (槽位 {}) 的 NBT 数据失败: {}\033[0m", i, e.what());
-                    }
-                }
-            }
-            
-            backpackItems.push_back(item);
-        }
+    // ===== 经准入控制在后台读取数据库，读取完成前玩家处于加载中状态 =====
+    player.sendMessage("§e正在加载数据，请稍候…");
 
-        if (Database::getInstance().savePlayerBackpack(uuid, serverName, backpackItems)) {
-            getSelf().getLogger().info("\033[32m[背包同步] 已保存玩家 {} 的 {} 个背包槽位\033[0m", name, backpackItems.size());
-        }
+    std::optional<PlayerSnapshot> candidate;
+    if (hasCached) {
+        candidate = std::move(cached);
+    }
 
-        // ===== 保存装备数据（槽位 36-40） =====
-        getSelf().getLogger().info("\033[33m[装备同步] 正在保存玩家 {} 的装备数据（槽位 36-40）...\033[0m", name);
-        std::vector<PlayerEquipmentItem> equipmentItems;
-
-        // 使用 ActorInventoryUtils 获取装备数据
-        auto* headItem = ActorInventoryUtils::getItem(player, SharedTypes::Legacy::EquipmentSlot::Head, 0);
-        auto* torsoItem = ActorInventoryUtils::getItem(player, SharedTypes::Legacy::EquipmentSlot::Torso, 0);
-        auto* legsItem = ActorInventoryUtils::getItem(player, SharedTypes::Legacy::EquipmentSlot::Legs, 0);
-        auto* feetItem = ActorInventoryUtils::getItem(player, SharedTypes::Legacy::EquipmentSlot::Feet, 0);
-        auto* offhandItem = ActorInventoryUtils::getItem(player, SharedTypes::Legacy::EquipmentSlot::Offhand, 0);
-
-        // 保存头盔（槽位 36）
-        if (headItem && !headItem->isNull()) {
-            PlayerEquipmentItem item;
-            item.slot = 36;
-            if (headItem->mItem) {
-                item.itemType = headItem->mItem->getSerializedName();
-                getSelf().getLogger().info("\033[33m[装备同步] 保存装备: {} 在槽位 {}\033[0m", item.itemType, 36);
-            }
-            item.count = static_cast<int>(headItem->mCount);
-            item.damage = headItem->mAuxValue;
-            if (headItem->mUserData) {
-                try {
-                    item.nbt = headItem->mUserData->toSnbt();
-                } catch (const std::exception& e) {
-                    getSelf().getLogger().warn("\033[33m[装备同步] 序列化装备 NBT 数据失败: {}\033[0m", e.what());
-                }
-            }
-            equipmentItems.push_back(item);
-        }
+    CancellationToken token;
+    mPlayerTokens[uuid] = token;
+    runPlayerJoin(uuid, name, xuid, std::move(candidate), token);
+    scope.stage("startLoad");
+}
 
-        // 保存胸甲（槽位 37）
-        if (torsoItem && !torsoItem->isNull()) {
-            PlayerEquipmentItem item;
-            item.slot = 37;
-            if (torsoItem->mItem) {
-                item.itemType = torsoItem->mItem->getSerializedName();
-                getSelf().getLogger().info("\033[33m[装备同步] 保存装备: {} 在槽位 {}\033[0m", item.itemType, 37);
-            }
-            item.count = static_cast<int>(torsoItem->mCount);
-            item.damage = torsoItem->mAuxValue;
-            if (torsoItem->mUserData) {
-                try {
-                    item.nbt = torsoItem->mUserData->toSnbt();
-                } catch (const std::exception& e) {
-                    getSelf().getLogger().warn("\033[33m[装备同步] 序列化装备 NBT 数据失败: {}\033[0m", e.what());
-                }
-            }
-            equipmentItems.push_back(item);
-        }
+GameTask MyMod::runPlayerJoin(
+    std::string                   uuid,
+    std::string                   name,
+    std::string                   xuid,
+    std::optional<PlayerSnapshot> candidate,
+    [[maybe_unused]] CancellationToken token  // 由 GameTask 绑定，用于取消
+) {
+    auto& admission  = JoinAdmission::getInstance();
+    auto  admittedAt = std::chrono::steady_clock::now();
 
-        // 保存护腿（槽位 38）
-        if (legsItem && !legsItem->isNull()) {
-            PlayerEquipmentItem item;
-            item.slot = 38;
-            if (legsItem->mItem) {
-                item.itemType = legsItem->mItem->getSerializedName();
-                getSelf().getLogger().info("\033[33m[装备同步] 保存装备: {} 在槽位 {}\033[0m", item.itemType, 38);
-            }
-            item.count = static_cast<int>(legsItem->mCount);
-            item.damage = legsItem->mAuxValue;
-            if (legsItem->mUserData) {
-                try {
-                    item.nbt = legsItem->mUserData->toSnbt();
-                } catch (const std::exception& e) {
-                    getSelf().getLogger().warn("\033[33m[装备同步] 序列化装备 NBT 数据失败: {}\033[0m", e.what());
-                }
-            }
-            equipmentItems.push_back(item);
-        }
+    // 等待读取名额（玩家离线时协程在这里被销毁）
+    auto slot    = co_await admission.acquire(uuid, name);
+    auto started = std::chrono::steady_clock::now();
 
-        // 保存靴子（槽位 39）
-        if (feetItem && !feetItem->isNull()) {
-            PlayerEquipmentItem item;
-            item.slot = 39;
-            if (feetItem->mItem) {
-                item.itemType = feetItem->mItem->getSerializedName();
-                getSelf().getLogger().info("\033[33m[装备同步] 保存装备: {} 在槽位 {}\033[0m", item.itemType, 39);
-            }
-            item.count = static_cast<int>(feetItem->mCount);
-            item.damage = feetItem->mAuxValue;
-            if (feetItem->mUserData) {
-                try {
-                    item.nbt = feetItem->mUserData->toSnbt();
-                } catch (const std::exception& e) {
-                    getSelf().getLogger().warn("\033[33m[装备同步] 序列化装备 NBT 数据失败: {}\033[0m", e.what());
-                }
-            }
-            equipmentItems.push_back(item);
-        }
+    static const auto kLatency = Metrics::getInstance().histogram("join.load");
 
-        // 保存副手（槽位 40）
-        if (offhandItem && !offhandItem->isNull()) {
-            PlayerEquipmentItem item;
-            item.slot = 40;
-            if (offhandItem->mItem) {
-                item.itemType = offhandItem->mItem->getSerializedName();
-                getSelf().getLogger().info("\033[33m[装备同步] 保存装备: {} 在槽位 {}\033[0m", item.itemType, 40);
-            }
-            item.count = static_cast<int>(offhandItem->mCount);
-            item.damage = offhandItem->mAuxValue;
-            if (offhandItem->mUserData) {
-                try {
-                    item.nbt = offhandItem->mUserData->toSnbt();
-                } catch (const std::exception& e) {
-                    getSelf().getLogger().warn("\033[33m[装备同步] 序列化装备 NBT 数据失败: {}\033[0m", e.what());
-                }
-            }
-            equipmentItems.push_back(item);
-        }
+    // 读取失败（如连接断开）时重试一次，仍失败则踢出玩家
+    constexpr int kLoadAttempts = 2;
 
-        if (Database::getInstance().savePlayerEquipment(uuid, serverName, equipmentItems)) {
-            getSelf().getLogger().info("\033[32m[装备同步] 已保存玩家 {} 的 {} 个装备\033[0m", name, equipmentItems.size());
-        }
+    PlayerLoadResult result;
+    bool             loaded = false;
+    for (int attempt = 1; attempt <= kLoadAttempts && !loaded; attempt++) {
+        try {
+            // 推送的快照需要校验版本、本地日志中有该玩家的快照时需要先写入，都在该玩家的 strand 上执行
+            bool fromCache = false;
+            if (candidate || SaveQueue::getInstance().hasJournaled(uuid)) {
+                fromCache = co_await AsyncDatabase::getInstance().run(uuid, JobPriority::Interactive, [=] {
+                    return PlayerPipeline::getInstance().prepare(uuid, name, candidate);
+                });
+            }
 
-        getSelf().getLogger().info("\033[32m[数据同步] 已保存玩家 {} 的背包和装备数据到数据库\033[0m", name);
-    } else {
-        // ===== 玩家有数据库数据：直接加载数据库数据覆盖玩家数据 =====
-        getSelf().getLogger().info("\033[33m[数据同步] 玩家 {} 有背包/装备数据，正在加载\033[0m", name);
-
-        // 先加载数据库数据
-        std::vector<PlayerBackpackItem> backpackItems;
-        std::vector<PlayerEquipmentItem> equipmentItems;
-        
-        Database::getInstance().loadPlayerBackpack(uuid, serverName, backpackItems);
-        Database::getInstance().loadPlayerEquipment(uuid, serverName, equipmentItems);
-
-        getSelf().getLogger().info("\033[33m[背包同步] 已加载 {} 个背包物品\033[0m", backpackItems.size());
-        getSelf().getLogger().info("\033[33m[装备同步] 已加载 {} 个装备物品\033[0m", equipmentItems.size());
-
-        ItemStack emptyStack;
-
-        // 加载背包数据（槽位 0-35），直接覆盖
-        auto& playerInv = player.getInventory();
-        int backpackCount = 0;
-        
-        for (const auto& item : backpackItems) {
-            ItemStack stack;
-            
-            // 如果物品类型为空字符串，说明是空槽位
-            if (item.itemType.empty()) {
-                stack = emptyStack;
+            if (fromCache) {
+                result.fromCache = true;
+                result.snapshot  = std::move(*candidate);
             } else {
-                stack = ItemStack(item.itemType, item.count, item.damage);
-
-                // 应用 NBT 数据（包括附魔）
-                if (!item.nbt.empty()) {
-                    try {
-                        auto nbtResult = CompoundTag::fromSnbt(item.nbt);
-                        if (nbtResult) {
-                            stack.mUserData = std::make_unique<CompoundTag>(std::move(*nbtResult));
-                        }
-                    } catch (const std::exception& e) {
-                        getSelf().getLogger().warn("\033[33m[背包同步] 应用物品 {} (槽位 {}) 的 NBT 数据失败: {}\033[0m", item.itemType, item.slot, e.what());
-                    }
+                // 一致性快照读取：启用事件循环时由 I/O 线程推进，不占用工作线程
+                auto load = co_await AsyncDatabase::getInstance().loadPlayerSnapshot(uuid);
+                if (!load.success) {
+                    throw std::runtime_error("读取玩家快照失败");
                 }
-                backpackCount++;
+                result = PlayerPipeline::fromSnapshot(load);
             }
+            loaded = true;
+        } catch (const std::exception& e) {
+            BDS_LOG_WARN(
+                "\033[33m[加入] 读取玩家 {} 的数据失败 (第 {}/{} 次): {}\033[0m",
+                name,
+                attempt,
+                kLoadAttempts,
+                e.what()
+            );
+        }
+    }
 
-            // 设置背包物品
-            playerInv.setItem(item.slot, stack);
+    if (!loaded) {
+        // 踢出玩家：离开事件在加载中状态下跳过离线保存（不会用未加载的数据覆盖数据库）并清理加载中状态，
+        // 读取名额在协程结束时归还
+        BDS_LOG_ERROR("\033[31m[加入] 无法读取玩家 {} 的数据，已踢出\033[0m", name);
+        if (Player* player = findOnlinePlayer(uuid)) {
+            player->disconnect("§c读取数据失败，请重新进入服务器");
+        } else {
+            admission.cancel(uuid);
         }
+        co_return;
+    }
 
-        getSelf().getLogger().info("\033[32m[背包同步] 已应用 {} 个背包物品\033[0m", backpackCount);
+    auto loadTime = std::chrono::steady_clock::now() - started;
+    result.loadMs = std::chrono::duration<double, std::milli>(loadTime).count();
+    Metrics::getInstance().record(kLatency, loadTime);
 
-        // 加载装备数据（槽位 36-40），直接覆盖
-        int armorCount = 0;
-        std::bitset<5> armorSlotsToSync;
+    slot.complete(result.loadMs);
+    admission.finish(uuid);
 
-        for (const auto& item : equipmentItems) {
-            ItemStack stack;
-            
-            // 如果物品类型为空字符串，说明是空槽位
-            if (item.itemType.empty()) {
-                stack = emptyStack;
-            } else {
-                stack = ItemStack(item.itemType, item.count, item.damage);
-
-                // 应用 NBT 数据（包括附魔）
-                if (!item.nbt.empty()) {
-                    try {
-                        auto nbtResult = CompoundTag::fromSnbt(item.nbt);
-                        if (nbtResult) {
-                            stack.mUserData = std::make_unique<CompoundTag>(std::move(*nbtResult));
-                            getSelf().getLogger().info("\033[33m[装备同步] 已应用物品 {} (槽位 {}) 的 NBT 数据\033[0m", item.itemType, item.slot);
-                        }
-                    } catch (const std::exception& e) {
-                        getSelf().getLogger().warn("\033[33m[装备同步] 应用物品 {} (槽位 {}) 的 NBT 数据失败: {}\033[0m", item.itemType, item.slot, e.what());
-                    }
-                }
-            }
+    // 之后写入本地日志的快照以这个版本号为重放条件；基础记录不影响加入，在后台更新
+    SaveQueue::getInstance().noteVersion(uuid, result.snapshot.version);
+    DatabaseExecutor::getInstance().post(
+        uuid,
+        [uuid, name, xuid] { PlayerPipeline::getInstance().updatePlayerRecord(uuid, name, xuid); },
+        JobPriority::Background
+    );
 
-            // 设置装备和副手（36-40）
-            if (item.slot == 36) {
-                // 头盔
-                serverPlayer.setArmor(SharedTypes::Legacy::ArmorSlot::Head, stack);
-                armorSlotsToSync.set(0);
-                if (!item.itemType.empty()) armorCount++;
-                getSelf().getLogger().info("\033[33m[装备同步] 已设置头盔槽位: {}\033[0m", item.itemType.empty() ? "(空)" : item.itemType);
-            } else if (item.slot == 37) {
-                // 胸甲
-                serverPlayer.setArmor(SharedTypes::Legacy::ArmorSlot::Torso, stack);
-                armorSlotsToSync.set(1);
-                if (!item.itemType.empty()) armorCount++;
-                getSelf().getLogger().info("\033[33m[装备同步] 已设置胸甲槽位: {}\033[0m", item.itemType.empty() ? "(空)" : item.itemType);
-            } else if (item.slot == 38) {
-                // 护腿
-                serverPlayer.setArmor(SharedTypes::Legacy::ArmorSlot::Legs, stack);
-                armorSlotsToSync.set(2);
-                if (!item.itemType.empty()) armorCount++;
-                getSelf().getLogger().info("\033[33m[装备同步] 已设置护腿槽位: {}\033[0m", item.itemType.empty() ? "(空)" : item.itemType);
-            } else if (item.slot == 39) {
-                // 靴子
-                serverPlayer.setArmor(SharedTypes::Legacy::ArmorSlot::Feet, stack);
-                armorSlotsToSync.set(3);
-                if (!item.itemType.empty()) armorCount++;
-                getSelf().getLogger().info("\033[33m[装备同步] 已设置靴子槽位: {}\033[0m", item.itemType.empty() ? "(空)" : item.itemType);
-            } else if (item.slot == 40) {
-                // 副手
-                serverPlayer.setOffhandSlot(stack);
-                if (!item.itemType.empty()) armorCount++;
-                getSelf().getLogger().info("\033[33m[装备同步] 已设置副手槽位: {}\033[0m", item.itemType.empty() ? "(空)" : item.itemType);
-            }
-        }
+    static const auto kWaitLatency = Metrics::getInstance().histogram("join.admissionWait");
+    Metrics::getInstance().record(kWaitLatency, started - admittedAt);
 
-        // 同步装备到客户端
-        if (armorSlotsToSync.any()) {
-            serverPlayer.sendArmor(armorSlotsToSync);
-        }
-        serverPlayer.sendInventory(false);
+    BDS_LOG_INFO(
+        "\033[32m[加入] 玩家 {} 的数据读取完成 (排队: {:.2f}ms, 读取: {:.2f}ms, 并发上限: {:.1f})\033[0m",
+        name,
+        std::chrono::duration<double, std::milli>(started - admittedAt).count(),
+        result.loadMs,
+        admission.getInFlightLimit()
+    );
 
-        getSelf().getLogger().info("\033[32m[装备同步] 已应用 {} 个装备\033[0m", armorCount);
-        getSelf().getLogger().info("\033[32m[数据同步] 已加载玩家 {} 的背包和装备数据\033[0m", name);
+    if (Player* player = findOnlinePlayer(uuid)) {
+        BdsPlayerState state(*player);
+        PlayerPipeline::getInstance().apply(state, state, result);
     }
+}
 
-    // 更新玩家基础数据
-    PlayerData data;
-    data.uuid     = uuid;
-    data.name     = name;
-    data.xuid     = xuid;
-    data.playTime = 0;
-    data.isOnline = true;
-
-    if (Database::getInstance().isPlayerExists(uuid)) {
-        Database::getInstance().loadPlayerData(uuid, data);
-        data.isOnline = true;
-        Database::getInstance().updatePlayerData(data);
-        getSelf().getLogger().info("\033[32m[玩家] 已更新玩家 {} 的数据\033[0m", name);
-    } else {
-        // 新玩家：创建记录
-        Database::getInstance().savePlayerData(data);
-        getSelf().getLogger().info("\033[32m[玩家] 已保存新玩家 {} 的数据\033[0m", name);
+Player* MyMod::findOnlinePlayer(const std::string& uuid) {
+    auto level = ll::service::getLevel();
+    if (!level) {
+        return nullptr;
     }
+    return level->getPlayer(mce::UUID::fromString(uuid));
 }
 
 void MyMod::onPlayerLeft(Player& player) {
     std::string uuid = player.getUuid().asString();
+    TraceKey    traceKey(uuid);
+
+    static const auto kSite = TickUsage::site("PlayerDisconnectEvent");
+    StallScope        scope(kSite);
+
     std::string name = player.getRealName();
 
     auto it = mPlayerJoinTimes.find(uuid);
     if (it == mPlayerJoinTimes.end()) {
-        getSelf().getLogger().warn("\033[33m[玩家] 未找到玩家 {} 的加入时间\033[0m", name);
+        BDS_LOG_WARN("\033[33m[玩家] 未找到玩家 {} 的加入时间\033[0m", name);
         return;
     }
 
@@ -491,197 +380,68 @@ void MyMod::onPlayerLeft(Player& player) {
     auto duration  = std::chrono::duration_cast<std::chrono::seconds>(leaveTime - joinTime).count();
 
     mPlayerJoinTimes.erase(it);
+    TransferPipeline::getInstance().cancel(uuid);
 
-    getSelf().getLogger().info("\033[32m[玩家] 玩家 {} 离开了服务器 (本次游玩时间: {}秒)\033[0m", name, duration);
-
-    // 更新玩家数据
-    PlayerData data;
-    if (Database::getInstance().loadPlayerData(uuid, data)) {
-        data.playTime += static_cast<int>(duration);
-        data.isOnline = false;
-        Database::getInstance().updatePlayerData(data);
-        getSelf().getLogger().info("\033[32m[玩家] 已更新玩家 {} 的数据 (总游玩时间: {}秒)\033[0m", name, data.playTime);
-    }
-
-    // 保存玩家属性数据到数据库（包括生命值、饱食度、经验等）
-    getSelf().getLogger().info("\033[33m[数据同步] 正在保存玩家 {} 的属性数据...\033[0m", name);
-
-    std::string serverName = Config::getInstance().getDatabaseConfig().serverName;
-
-    // 收集玩家属性数据
-    PlayerSyncData syncData;
-    syncData.uuid = uuid;
-    syncData.serverName = serverName;
-
-    // 获取游戏模式
-    syncData.gamemode = static_cast<int>(player.getPlayerGameType());
-
-    // 获取生命值
-    try {
-        auto healthAttr = player.getAttribute(SharedAttributes::HEALTH());
-        syncData.health = static_cast<int>(healthAttr.mCurrentValue);
-        syncData.maxHealth = static_cast<int>(healthAttr.mCurrentMaxValue);
-        getSelf().getLogger().info("\033[33m[数据同步] 获取生命值 - 当前: {}/{}\033[0m", syncData.health, syncData.maxHealth);
-    } catch (const std::exception& e) {
-        getSelf().getLogger().warn("\033[33m[数据同步] 获取生命值失败: {}\033[0m", e.what());
-        syncData.health = 20;
-        syncData.maxHealth = 20;
-    }
-
-    // 获取饱食度
-    try {
-        auto hungerAttr = player.getAttribute(Player::HUNGER());
-        syncData.food = static_cast<int>(hungerAttr.mCurrentValue);
-        getSelf().getLogger().info("\033[33m[数据同步] 获取饱食度 - 当前: {}\033[0m", syncData.food);
-    } catch (const std::exception& e) {
-        getSelf().getLogger().warn("\033[33m[数据同步] 获取饱食度失败: " + std::string(e.what()) + "\033[0m");
-        syncData.food = 20;
-    }
+    BDS_LOG_INFO("\033[32m[玩家] 玩家 {} 离开了服务器 (本次游玩时间: {}秒)\033[0m", name, duration);
 
-    // 获取饱和度
-    try {
-        auto saturationAttr = player.getAttribute(Player::SATURATION());
-        syncData.foodSaturation = static_cast<float>(saturationAttr.mCurrentValue);
-        getSelf().getLogger().info("\033[33m[数据同步] 获取饱和度 - 当前: " + std::to_string(syncData.foodSaturation) + "\033[0m");
-    } catch (const std::exception& e) {
-        getSelf().getLogger().warn("\033[33m[数据同步] 获取饱和度失败: " + std::string(e.what()) + "\033[0m");
-        syncData.foodSaturation = 20.0f;
+    // 投递到该玩家的 strand：保证在玩家下次加入读取数据之前完成（在线时长可以等待，使用后台优先级）
+    DatabaseExecutor::getInstance().post(uuid, [uuid, name, duration] {
+        // 更新玩家数据
+        PlayerData data;
+        if (Database::getInstance().loadPlayerData(uuid, data)) {
+            data.playTime += static_cast<int>(duration);
+            data.isOnline = false;
+            Database::getInstance().updatePlayerData(data);
+            BDS_LOG_INFO(
+                "\033[32m[玩家] 已更新玩家 {} 的数据 (总游玩时间: {}秒)\033[0m",
+                name,
+                data.playTime
+            );
+        }
+    }, JobPriority::Background);
+    scope.stage("playTime");
+
+    // 数据尚未加载：玩家身上不是数据库中的数据，保存会覆盖其它服务器的数据
+    // 取消该玩家尚未完成的协程（加入读取等）
+    if (auto token = mPlayerTokens.find(uuid); token != mPlayerTokens.end()) {
+        token->second.cancel();
+        mPlayerTokens.erase(token);
     }
 
-    // 获取经验值和等级
-    try {
-        auto xpAttr = player.getAttribute(Player::EXPERIENCE());
-        syncData.expLevel = static_cast<int>(xpAttr.mCurrentMaxValue);
-        float xpProgress = xpAttr.mCurrentValue;
-        syncData.expPoints = static_cast<int>(xpProgress * 100);
-        getSelf().getLogger().info("\033[33m[数据同步] 获取经验 - 等级: {}, 进度: {} ({}%)\033[0m", 
-            syncData.expLevel, xpProgress, syncData.expPoints);
-    } catch (const std::exception& e) {
-        getSelf().getLogger().warn("\033[33m[数据同步] 获取经验值失败: {}\033[0m", e.what());
-        syncData.expLevel = 0;
-        syncData.expPoints = 0;
-    }
-    
-    getSelf().getLogger().info("\033[33m[数据同步] 属性数据 - 生命值: " + std::to_string(syncData.health) + "/" + std::to_string(syncData.maxHealth) + 
-        ", 饱食度: " + std::to_string(syncData.food) + 
-        ", 饱和度: " + std::to_string(syncData.foodSaturation) + 
-        ", 经验等级: " + std::to_string(syncData.expLevel) + 
-        ", 经验点数: " + std::to_string(syncData.expPoints) + "\033[0m");
-
-    // 保存属性数据
-    if (Database::getInstance().savePlayerSyncData(syncData)) {
-        getSelf().getLogger().info("\033[32m[数据同步] 已保存玩家 {} 的属性数据\033[0m", name);
-    } else {
-        getSelf().getLogger().error("\033[31m[数据同步] 保存玩家 {} 的属性数据失败\033[0m", name);
+    if (JoinAdmission::getInstance().isLoading(uuid)) {
+        JoinAdmission::getInstance().cancel(uuid);
+        BDS_LOG_WARN("\033[33m[加入] 玩家 {} 在数据加载完成前离开，跳过离线保存\033[0m", name);
+        return;
     }
 
-    // ===== 保存背包数据（槽位 0-35） =====
-    getSelf().getLogger().info("\033[33m[背包同步] 正在保存玩家 {} 的背包数据（槽位 0-35）...\033[0m", name);
-    
-    std::vector<PlayerBackpackItem> backpackItems;
-    try {
-        auto& playerInv = player.getInventory();
-        int containerSize = playerInv.getContainerSize();
-        
-        int inventorySlots = std::min(containerSize, 36);
-        for (int i = 0; i < inventorySlots; i++) {
-            auto& itemStack = playerInv.getItem(i);
-            
-            PlayerBackpackItem item;
-            item.slot = i;
-            item.itemType = "";  // 空槽位的类型为空字符串
-            item.count = 0;
-            item.damage = 0;
-            item.nbt = "";
-            
-            if (!itemStack.isNull()) {
-                if (itemStack.mItem) {
-                    item.itemType = itemStack.mItem->getSerializedName();
-                }
-                item.count = static_cast<int>(itemStack.mCount);
-                item.damage = itemStack.mAuxValue;
-
-                if (itemStack.mUserData) {
-                    try {
-                        item.nbt = itemStack.mUserData->toSnbt();
-                    } catch (const std::exception& e) {
-                        getSelf().getLogger().warn("\033[33m[背包同步] 序列化背包物品 (槽位 {}) 的 NBT 数据失败: {}\033[0m", i, e.what());
-                    }
-                }
-            }
-            
-            backpackItems.push_back(item);
-        }
-
-        if (Database::getInstance().savePlayerBackpack(uuid, serverName, backpackItems)) {
-            getSelf().getLogger().info("\033[32m[背包同步] 已保存 {} 个背包槽位\033[0m", backpackItems.size());
-        } else {
-            getSelf().getLogger().error("\033[31m[背包同步] 保存背包数据失败\033[0m");
-        }
-    } catch (const std::exception& e) {
-        getSelf().getLogger().error("\033[31m[背包同步] 保存背包数据失败: {}\033[0m", e.what());
+    // 通过传送离开：快照已在发送传送数据包前提交，再次保存会覆盖目标服务器的新数据
+    if (TransferPipeline::getInstance().consumeHandedOff(uuid)) {
+        BDS_LOG_INFO("\033[32m[传送] 玩家 {} 的快照已在传送前提交，跳过离线保存\033[0m", name);
+        return;
     }
 
-    // ===== 保存装备数据（槽位 36-40） =====
-    getSelf().getLogger().info("\033[33m[装备同步] 正在保存玩家 {} 的装备数据（槽位 36-40）...\033[0m", name);
-    
-    std::vector<PlayerEquipmentItem> equipmentItems;
-    try {
-        // 使用 ActorInventoryUtils 获取装备数据
-        auto* headItem = ActorInventoryUtils::getItem(player, SharedTypes::Legacy::EquipmentSlot::Head, 0);
-        auto* torsoItem = ActorInventoryUtils::getItem(player, SharedTypes::Legacy::EquipmentSlot::Torso, 0);
-        auto* legsItem = ActorInventoryUtils::getItem(player, SharedTypes::Legacy::EquipmentSlot::Legs, 0);
-        auto* feetItem = ActorInventoryUtils::getItem(player, SharedTypes::Legacy::EquipmentSlot::Feet, 0);
-        auto* offhandItem = ActorInventoryUtils::getItem(player, SharedTypes::Legacy::EquipmentSlot::Offhand, 0);
-        
-        // 保存所有装备槽位（包括空槽位）
-        std::array<const ItemStack*, 5> equipmentSlots = {headItem, torsoItem, legsItem, feetItem, offhandItem};
-        
-        for (int i = 0; i < 5; i++) {
-            int slot = 36 + i;  // 36-40
-            const ItemStack* itemPtr = equipmentSlots[i];
-            
-            PlayerEquipmentItem item;
-            item.slot = slot;
-            item.itemType = "";  // 空槽位的类型为空字符串
-            item.count = 0;
-            item.damage = 0;
-            item.nbt = "";
-            
-            if (itemPtr && !itemPtr->isNull()) {
-                if (itemPtr->mItem) {
-                    item.itemType = itemPtr->mItem->getSerializedName();
-                    getSelf().getLogger().info("\033[33m[装备同步] 找到装备: {} 在槽位 {}\033[0m", item.itemType, slot);
-                }
-                item.count = static_cast<int>(itemPtr->mCount);
-                item.damage = itemPtr->mAuxValue;
-
-                if (itemPtr->mUserData) {
-                    try {
-                        item.nbt = itemPtr->mUserData->toSnbt();
-                    } catch (const std::exception& e) {
-                        getSelf().getLogger().warn("\033[33m[装备同步] 序列化装备 (槽位 {}) 的 NBT 数据失败: {}\033[0m", slot, e.what());
-                    }
-                }
-            }
-
-            equipmentItems.push_back(item);
-        }
-
-        if (Database::getInstance().savePlayerEquipment(uuid, serverName, equipmentItems)) {
-            getSelf().getLogger().info("\033[32m[装备同步] 已保存 {} 个装备物品\033[0m", equipmentItems.size());
-        } else {
-            getSelf().getLogger().error("\033[31m[装备同步] 保存装备数据失败\033[0m");
-        }
-    } catch (const std::exception& e) {
-        getSelf().getLogger().error("\033[31m[装备同步] 保存装备数据失败: {}\033[0m", e.what());
-    }
+    // 在主线程采集快照（属性、背包 0-35、装备 36-40），经保存队列在同一 strand 上写入
+    BdsPlayerState state(player);
+    PlayerPipeline::getInstance().save(state, SaveReason::Leave);
+    scope.stage("save");
 }
 
 void MyMod::onServerStopping() {
+    static const auto kSite = TickUsage::site("ServerStoppingEvent");
+    StallScope        scope(kSite);
+
     // 遍历所有在线玩家，保存他们的数据
     int savedCount = 0;
     for (const auto& [uuid, joinTime] : mPlayerJoinTimes) {
+        // 快照经保存队列写入（关服保存在队列已满时等待，不会被丢弃），在 disable 停止线程池前完成
+        Player* player = findOnlinePlayer(uuid);
+        if (player && !JoinAdmission::getInstance().isLoading(uuid)
+            && !TransferPipeline::getInstance().consumeHandedOff(uuid)) {
+            BdsPlayerState state(*player);
+            PlayerPipeline::getInstance().save(state, SaveReason::Shutdown);
+            scope.stage("save");
+        }
+
         PlayerData data;
         if (Database::getInstance().loadPlayerData(uuid, data)) {
             auto leaveTime = std::chrono::system_clock::now();
@@ -691,12 +451,50 @@ void MyMod::onServerStopping() {
             Database::getInstance().updatePlayerData(data);
             savedCount++;
         }
+        scope.stage("playTime");
     }
 
     // 清空在线玩家列表
     mPlayerJoinTimes.clear();
 
-    getSelf().getLogger().info("\033[32m[BDSmysql] 已保存 {} 个玩家的数据\033[0m", savedCount);
+    BDS_LOG_INFO("\033[32m[BDSmysql] 已保存 {} 个玩家的数据\033[0m", savedCount);
+}
+
+void MyMod::registerLoadingGuards() {
+    auto& eventBus = ll::event::EventBus::getInstance();
+
+    // 加载中的玩家数据尚未应用；传送中的玩家快照已采集，之后的变化不会被保存
+    auto loading = [](Player& player) {
+        static const auto kSite = TickUsage::site("loadingGuard");
+        StallScope        scope(kSite);
+        std::string       uuid = player.getUuid().asString();
+        return JoinAdmission::getInstance().isLoading(uuid) || TransferPipeline::getInstance().isFrozen(uuid);
+    };
+
+    eventBus.emplaceListener<ll::event::PlayerPickUpItemEvent>([loading](ll::event::PlayerPickUpItemEvent& event) {
+        if (loading(event.self())) event.cancel();
+    });
+    eventBus.emplaceListener<ll::event::PlayerDestroyBlockEvent>([loading](ll::event::PlayerDestroyBlockEvent& event) {
+        if (loading(event.self())) event.cancel();
+    });
+    eventBus.emplaceListener<ll::event::PlayerPlacingBlockEvent>([loading](ll::event::PlayerPlacingBlockEvent& event) {
+        if (loading(event.self())) event.cancel();
+    });
+    eventBus.emplaceListener<ll::event::PlayerInteractBlockEvent>([loading](ll::event::PlayerInteractBlockEvent& event) {
+        if (loading(event.self())) event.cancel();
+    });
+    eventBus.emplaceListener<ll::event::PlayerUseItemEvent>([loading](ll::event::PlayerUseItemEvent& event) {
+        if (loading(event.self())) event.cancel();
+    });
+    eventBus.emplaceListener<ll::event::PlayerAttackEvent>([loading](ll::event::PlayerAttackEvent& event) {
+        if (loading(event.self())) event.cancel();
+    });
+
+    // 加载中的玩家死亡会掉落尚未被覆盖的本地物品，传送中的玩家死亡会掉落已提交的物品，都会造成复制
+    eventBus.emplaceListener<ll::event::ActorHurtEvent>([loading](ll::event::ActorHurtEvent& event) {
+        auto& actor = event.self();
+        if (actor.isType(ActorType::Player) && loading(static_cast<Player&>(actor))) event.cancel();
+    });
 }
 
 void MyMod::registerCommands() {
@@ -710,6 +508,9 @@ void MyMod::registerCommands() {
     // 无参数：显示服务器选择 UI
     cmd.overload()
         .execute([](CommandOrigin const& origin, CommandOutput& output) {
+            static const auto kSite = TickUsage::site("tpserverCommand");
+            StallScope        scope(kSite);
+
             Player* player = nullptr;
             if (origin.getEntity() && origin.getEntity()->isType(ActorType::Player)) {
                 player = static_cast<Player*>(origin.getEntity());
@@ -727,6 +528,9 @@ void MyMod::registerCommands() {
     cmd.overload<ServerName>()
         .required("name")
         .execute([](CommandOrigin const& origin, CommandOutput& output, ServerName const& serverName) {
+            static const auto kSite = TickUsage::site("tpserverCommand");
+            StallScope        scope(kSite);
+
             // 获取目标服务器配置
             auto& servers = ServerConfigManager::getInstance().getServers();
             auto targetIt = std::find_if(servers.begin(), servers.end(),
@@ -750,198 +554,148 @@ void MyMod::registerCommands() {
                 return;
             }
 
-            // 获取当前玩家
-            std::string uuid = player->getUuid().asString();
-            std::string name = player->getRealName();
-
-            auto& mod = MyMod::getInstance();
-
-            mod.getSelf().getLogger().info("\033[33m[传送] 玩家 {} ({}) 请求传送到服务器: {}\033[0m", name, uuid, targetServer.name);
-
-            // 保存当前玩家数据
-            try {
-                auto& playerInv = player->getInventory();
-                int containerSize = playerInv.getContainerSize();
-
-                // 收集玩家当前状态
-                PlayerSyncData syncData;
-                syncData.uuid = uuid;
-                syncData.serverName = Config::getInstance().getDatabaseConfig().serverName;
-
-                // 获取游戏模式
-                syncData.gamemode = static_cast<int>(player->getPlayerGameType());
-
-                // 获取生命值
-                auto healthAttr = player->getAttribute(SharedAttributes::HEALTH());
-                syncData.health = static_cast<int>(healthAttr.mCurrentValue);
-                syncData.maxHealth = static_cast<int>(healthAttr.mCurrentMaxValue);
-
-                // 获取饱食度
-                auto hungerAttr = player->getAttribute(Player::HUNGER());
-                syncData.food = static_cast<int>(hungerAttr.mCurrentValue);
-
-                // 获取饱和度
-                auto saturationAttr = player->getAttribute(Player::SATURATION());
-                syncData.foodSaturation = static_cast<float>(saturationAttr.mCurrentValue);  // 修复：改为float类型
-
-                // 获取经验
-                try {
-                    auto xpAttr = player->getAttribute(Player::EXPERIENCE());
-                    syncData.expLevel = static_cast<int>(xpAttr.mCurrentMaxValue);
-                    float xpProgress = xpAttr.mCurrentValue;
-                    syncData.expPoints = static_cast<int>(xpProgress * 100);
-                } catch (const std::exception& e) {
-                    syncData.expLevel = 0;
-                    syncData.expPoints = 0;
-                }
-
-                // 保存属性数据
-                Database::getInstance().savePlayerSyncData(syncData);
-
-                // 保存背包数据
-                std::vector<PlayerInventoryItem> inventory;
-
-                // 背包槽位（0-35）
-                int inventorySlots = std::min(containerSize, 36);
-                for (int i = 0; i < inventorySlots; i++) {
-                    auto& itemStack = playerInv.getItem(i);
-                    if (!itemStack.isNull()) {
-                        PlayerInventoryItem item;
-                        item.slot = i;
-                        if (itemStack.mItem) {
-                            item.itemType = itemStack.mItem->getSerializedName();
-                        }
-                        item.count = static_cast<int>(itemStack.mCount);
-                        item.damage = itemStack.mAuxValue;
+            scope.stage("lookup");
 
-                        if (itemStack.mUserData) {
-                            try {
-                                item.nbt = itemStack.mUserData->toSnbt();
-                            } catch (...) {}
-                        }
+            // 采集快照并异步提交，提交确认后再发送传送数据包
+            if (TransferPipeline::getInstance().begin(*player, targetServer)) {
+                output.success("\033[33m正在保存数据并传送到服务器：{}\033[0m", targetServer.name);
+            }
+        });
 
-                        inventory.push_back(item);
-                    }
+    // 管理命令：/bdsmysql stats 查看各数据库操作和加入/传送阶段的延迟分位数
+    auto& admin = CommandRegistrar::getInstance().getOrCreateCommand(
+        "bdsmysql",
+        "BDSmysql 管理命令",
+        CommandPermissionLevel::GameDirectors);
+
+    admin.overload()
+        .text("stats")
+        .execute([](CommandOrigin const&, CommandOutput& output) {
+            static const auto kSite = TickUsage::site("statsCommand");
+            StallScope        scope(kSite);
+
+            auto& metrics = Metrics::getInstance();
+            output.success("§e[BDSmysql] 延迟统计（启动以来）");
+            for (const auto& h : metrics.histograms()) {
+                if (h.count == 0) {
+                    continue;
                 }
+                output.success(
+                    "§b{}§r 次数 {} 平均 {:.2f}ms p50 {:.2f}ms p99 {:.2f}ms 最大 {:.2f}ms",
+                    h.name,
+                    h.count,
+                    h.meanMs(),
+                    h.percentileMs(0.5),
+                    h.percentileMs(0.99),
+                    h.maxUs / 1000.0
+                );
+            }
+            for (const auto& c : metrics.counters()) {
+                output.success("§b{}§r {}", c.name, c.value);
+            }
+            for (const auto& g : metrics.gauges()) {
+                output.success("§b{}§r {:.3f}", g.name, g.value);
+            }
+        });
 
-                // 装备栏（36-39）
-                auto* headItem = ActorInventoryUtils::getItem(*player, SharedTypes::Legacy::EquipmentSlot::Head, 0);
-                auto* torsoItem = ActorInventoryUtils::getItem(*player, SharedTypes::Legacy::EquipmentSlot::Torso, 0);
-                auto* legsItem = ActorInventoryUtils::getItem(*player, SharedTypes::Legacy::EquipmentSlot::Legs, 0);
-                auto* feetItem = ActorInventoryUtils::getItem(*player, SharedTypes::Legacy::EquipmentSlot::Feet, 0);
-                
-                if (headItem && !headItem->isNull()) {
-                    PlayerInventoryItem item;
-                    item.slot = 36;
-                    if (headItem->mItem) {
-                        item.itemType = headItem->mItem->getSerializedName();
-                    }
-                    item.count = static_cast<int>(headItem->mCount);
-                    item.damage = headItem->mAuxValue;
-
-                    if (headItem->mUserData) {
-                        try {
-                            item.nbt = headItem->mUserData->toSnbt();
-                        } catch (...) {}
-                    }
-
-                    inventory.push_back(item);
-                }
-                
-                if (torsoItem && !torsoItem->isNull()) {
-                    PlayerInventoryItem item;
-                    item.slot = 37;
-                    if (torsoItem->mItem) {
-                        item.itemType = torsoItem->mItem->getSerializedName();
-                    }
-                    item.count = static_cast<int>(torsoItem->mCount);
-                    item.damage = torsoItem->mAuxValue;
-
-                    if (torsoItem->mUserData) {
-                        try {
-                            item.nbt = torsoItem->mUserData->toSnbt();
-                        } catch (...) {}
-                    }
-
-                    inventory.push_back(item);
-                }
-                
-                if (legsItem && !legsItem->isNull()) {
-                    PlayerInventoryItem item;
-                    item.slot = 38;
-                    if (legsItem->mItem) {
-                        item.itemType = legsItem->mItem->getSerializedName();
-                    }
-                    item.count = static_cast<int>(legsItem->mCount);
-                    item.damage = legsItem->mAuxValue;
-
-                    if (legsItem->mUserData) {
-                        try {
-                            item.nbt = legsItem->mUserData->toSnbt();
-                        } catch (...) {}
-                    }
-
-                    inventory.push_back(item);
-                }
-                
-                if (feetItem && !feetItem->isNull()) {
-                    PlayerInventoryItem item;
-                    item.slot = 39;
-                    if (feetItem->mItem) {
-                        item.itemType = feetItem->mItem->getSerializedName();
-                    }
-                    item.count = static_cast<int>(feetItem->mCount);
-                    item.damage = feetItem->mAuxValue;
-
-                    if (feetItem->mUserData) {
-                        try {
-                            item.nbt = feetItem->mUserData->toSnbt();
-                        } catch (...) {}
-                    }
-
-                    inventory.push_back(item);
-                }
+    // /bdsmysql slowlog：按累计耗时列出慢查询形态及 EXPLAIN 结果
+    admin.overload()
+        .text("slowlog")
+        .execute([](CommandOrigin const&, CommandOutput& output) {
+            static const auto kSite = TickUsage::site("slowlogCommand");
+            StallScope        scope(kSite);
 
-                // 副手（40）
-                auto* offhandItem = ActorInventoryUtils::getItem(*player, SharedTypes::Legacy::EquipmentSlot::Offhand, 0);
-                if (offhandItem && !offhandItem->isNull()) {
-                    PlayerInventoryItem item;
-                    item.slot = 40;
-                    if (offhandItem->mItem) {
-                        item.itemType = offhandItem->mItem->getSerializedName();
-                    }
-                    item.count = static_cast<int>(offhandItem->mCount);
-                    item.damage = offhandItem->mAuxValue;
-
-                    if (offhandItem->mUserData) {
-                        try {
-                            item.nbt = offhandItem->mUserData->toSnbt();
-                        } catch (...) {}
-                    }
-
-                    inventory.push_back(item);
-                }
+            constexpr size_t kMaxShown = 10;
 
-                Database::getInstance().savePlayerInventory(uuid, Config::getInstance().getDatabaseConfig().serverName, inventory);
-                mod.getSelf().getLogger().info("\033[32m[传送] 已保存玩家 {} 的数据\033[0m", name);
-            } catch (const std::exception& e) {
-                mod.getSelf().getLogger().error("\033[31m[传送] 保存玩家数据失败: {}\033[0m", e.what());
-                output.error("\033[31m传送失败：保存数据时出错\033[0m");
+            auto shapes = SlowQueryLog::getInstance().summary();
+            if (shapes.empty()) {
+                output.success("§e[BDSmysql] 没有记录到慢查询");
                 return;
             }
+            output.success("§e[BDSmysql] 慢查询（共 {} 种语句，按累计耗时排列）", shapes.size());
+            for (size_t i = 0; i < shapes.size() && i < kMaxShown; i++) {
+                const auto& shape = shapes[i];
+                output.success(
+                    "§b{}§r 次数 {} 平均 {:.2f}ms 最大 {:.2f}ms 最多 {} 行",
+                    shape.shape,
+                    shape.count,
+                    static_cast<double>(shape.totalUs) / shape.count / 1000.0,
+                    shape.maxUs / 1000.0,
+                    shape.maxRows
+                );
+                if (!shape.explain.empty()) {
+                    output.success("  {}EXPLAIN: {}", shape.fullScan ? "§c" : "§7", shape.explain);
+                }
+            }
+        });
 
-            // 发送传送数据包
-            try {
-                TransferPacket packet(targetServer.address, targetServer.port);
-                player->sendNetworkPacket(packet);
-                mod.getSelf().getLogger().info("\033[32m[传送] 传送数据包已发送\033[0m");
-            } catch (const std::exception& e) {
-                mod.getSelf().getLogger().error("\033[31m[传送] 发送传送数据包失败: {}\033[0m", e.what());
-                output.error("\033[31m传送失败：{}\033[0m", e.what());
-                return;
+    // /bdsmysql trace <on|off|dump> [uuid]：开关操作追踪，导出 Chrome trace 文件（chrome://tracing 或 Perfetto 打开）
+    admin.overload<TraceCommand>()
+        .text("trace")
+        .required("action")
+        .optional("uuid")
+        .execute([](CommandOrigin const&, CommandOutput& output, TraceCommand const& params) {
+            static const auto kSite = TickUsage::site("traceCommand");
+            StallScope        scope(kSite);
+
+            auto& tracer = Tracer::getInstance();
+            switch (params.action) {
+            case TraceAction::on:
+                tracer.setEnabled(true);
+                output.success("§e[BDSmysql] 操作追踪已开启");
+                break;
+            case TraceAction::off:
+                tracer.setEnabled(false);
+                output.success("§e[BDSmysql] 操作追踪已关闭（缓冲区保留，仍可导出）");
+                break;
+            case TraceAction::dump:
+                // 序列化和写文件在后台线程执行，结果（文件路径或失败原因）写入日志
+                DatabaseExecutor::getInstance().post(
+                    [key = params.uuid] {
+                        if (!Tracer::getInstance().dump(key)) {
+                            BDS_LOG_WARN("\033[33m[追踪] 追踪缓冲区为空或写入失败\033[0m");
+                        }
+                    },
+                    JobPriority::Background
+                );
+                output.success("§e[BDSmysql] 正在后台导出追踪文件，完成后路径见服务器日志");
+                break;
             }
+        });
 
-            output.success("\033[32m正在传送到服务器：{} ({}:{})\033[0m", targetServer.name, targetServer.address, targetServer.port);
+    // /bdsmysql record <start|stop>：录制数据库语句到 recordings/，用 bdsmysql-replay 离线重放
+    admin.overload<RecordCommand>()
+        .text("record")
+        .required("action")
+        .execute([](CommandOrigin const&, CommandOutput& output, RecordCommand const& params) {
+            static const auto kSite = TickUsage::site("recordCommand");
+            StallScope        scope(kSite);
+
+            auto& recorder = QueryRecorder::getInstance();
+            switch (params.action) {
+            case RecordAction::start:
+                if (auto path = recorder.begin()) {
+                    output.success("§e[BDSmysql] 正在录制数据库语句: {}", *path);
+                } else {
+                    output.error("无法创建录制文件，请查看日志");
+                }
+                break;
+            case RecordAction::stop: {
+                auto stats = recorder.end();
+                if (stats.path.empty()) {
+                    output.error("当前没有进行录制");
+                    break;
+                }
+                output.success(
+                    "§e[BDSmysql] 录制已停止：{} 条语句，{:.1f} MB，丢弃 {} 条",
+                    stats.queries,
+                    static_cast<double>(stats.bytes) / (1024.0 * 1024.0),
+                    stats.dropped
+                );
+                output.success("§7{}", stats.path);
+                break;
+            }
+            }
         });
 }
 
@@ -967,6 +721,9 @@ void MyMod::showServerListForm(Player& player) {
 
     // 发送表单给玩家
     form.sendTo(player, [&servers](Player& p, int index, ll::form::FormCancelReason reason) {
+        static const auto kSite = TickUsage::site("serverListForm");
+        StallScope        scope(kSite);
+
         // 如果有 reason，说明玩家关闭了表单或表单被取消
         if (reason.has_value()) {
             return;
@@ -981,251 +738,13 @@ void MyMod::showServerListForm(Player& player) {
         std::string uuid = p.getUuid().asString();
         std::string name = p.getRealName();
 
-        auto& mod = MyMod::getInstance();
-        mod.getSelf().getLogger().info("\033[33m[传送] 玩家 {} ({}) 通过 UI 请求传送到服务器: {}\033[0m", name, uuid, targetServer.name);
-
-        // 保存玩家数据
-        try {
-            auto& playerInv = p.getInventory();
-            int containerSize = playerInv.getContainerSize();
-
-            PlayerSyncData syncData;
-            syncData.uuid = uuid;
-            syncData.serverName = Config::getInstance().getDatabaseConfig().serverName;
-            syncData.gamemode = static_cast<int>(p.getPlayerGameType());
-
-            auto healthAttr = p.getAttribute(SharedAttributes::HEALTH());
-            syncData.health = static_cast<int>(healthAttr.mCurrentValue);
-            syncData.maxHealth = static_cast<int>(healthAttr.mCurrentMaxValue);
-
-            auto hungerAttr = p.getAttribute(Player::HUNGER());
-            syncData.food = static_cast<int>(hungerAttr.mCurrentValue);
-
-            auto saturationAttr = p.getAttribute(Player::SATURATION());
-            syncData.foodSaturation = static_cast<float>(saturationAttr.mCurrentValue);  // 修复：改为float类型
-
-            try {
-                auto xpAttr = p.getAttribute(Player::EXPERIENCE());
-                syncData.expLevel = static_cast<int>(xpAttr.mCurrentMaxValue);
-                float xpProgress = xpAttr.mCurrentValue;
-                syncData.expPoints = static_cast<int>(xpProgress * 100);
-            } catch (...) {
-                syncData.expLevel = 0;
-                syncData.expPoints = 0;
-            }
-
-            Database::getInstance().savePlayerSyncData(syncData);
-
-            std::vector<PlayerInventoryItem> inventory;
-
-            int inventorySlots = std::min(containerSize, 36);
-            for (int j = 0; j < inventorySlots; j++) {
-                auto& itemStack = playerInv.getItem(j);
-                if (!itemStack.isNull()) {
-                    PlayerInventoryItem item;
-                    item.slot = j;
-                    if (itemStack.mItem) {
-                        item.itemType = itemStack.mItem->getSerializedName();
-                    }
-                    item.count = static_cast<int>(itemStack.mCount);
-                    item.damage = itemStack.mAuxValue;
-
-                    if (itemStack.mUserData) {
-                        try {
-                            item.nbt = itemStack.mUserData->toSnbt();
-                        } catch (...) {}
-                    }
-
-                    inventory.push_back(item);
-                }
-            }
-
-            auto* headItem = ActorInventoryUtils::getItem(p, SharedTypes::Legacy::EquipmentSlot::Head, 0);
-            auto* torsoItem = ActorInventoryUtils::getItem(p, SharedTypes::Legacy::EquipmentSlot::Torso, 0);
-            auto* legsItem = ActorInventoryUtils::getItem(p, SharedTypes::Legacy::EquipmentSlot::Legs, 0);
-            auto* feetItem = ActorInventoryUtils::getItem(p, SharedTypes::Legacy::EquipmentSlot::Feet, 0);
-            
-            if (headItem && !headItem->isNull()) {
-                PlayerInventoryItem item;
-                item.slot = 36;
-                if (headItem->mItem) {
-                    item.itemType = headItem->mItem->getSerializedName();
-                }
-                item.count = static_cast<int>(headItem->mCount);
-                item.damage = headItem->mAuxValue;
-
-                if (headItem->mUserData) {
-                    try {
-                        item.nbt = headItem->mUserData->toSnbt();
-                    } catch (...) {}
-                }
-
-                inventory.push_back(item);
-            }
-            
-            if (torsoItem && !torsoItem->isNull()) {
-                PlayerInventoryItem item;
-                item.slot = 37;
-                if (torsoItem->mItem) {
-                    item.itemType = torsoItem->mItem->getSerializedName();
-                }
-                item.count = static_cast<int>(torsoItem->mCount);
-                item.damage = torsoItem->mAuxValue;
-
-                if (torsoItem->mUserData) {
-                    try {
-                        item.nbt = torsoItem->mUserData->toSnbt();
-                    } catch (...) {}
-                }
-
-                inventory.push_back(item);
-            }
-            
-            if (legsItem && !legsItem->isNull()) {
-                PlayerInventoryItem item;
-                item.slot = 38;
-                if (legsItem->mItem) {
-                    item.itemType = legsItem->mItem->getSerializedName();
-                }
-                item.count = static_cast<int>(legsItem->mCount);
-                item.damage = legsItem->mAuxValue;
-
-                if (legsItem->mUserData) {
-                    try {
-                        item.nbt = legsItem->mUserData->toSnbt();
-                    } catch (...) {}
-                }
-
-                inventory.push_back(item);
-            }
-            
-            if (feetItem && !feetItem->isNull()) {
-                PlayerInventoryItem item;
-                item.slot = 39;
-                if (feetItem->mItem) {
-                    item.itemType = feetItem->mItem->getSerializedName();
-                }
-                item.count = static_cast<int>(feetItem->mCount);
-                item.damage = feetItem->mAuxValue;
-
-                if (feetItem->mUserData) {
-                    try {
-                        item.nbt = feetItem->mUserData->toSnbt();
-                    } catch (...) {}
-                }
-
-                inventory.push_back(item);
-            }
-
-            auto* offhandItem = ActorInventoryUtils::getItem(p, SharedTypes::Legacy::EquipmentSlot::Offhand, 0);
-            if (offhandItem && !offhandItem->isNull()) {
-                PlayerInventoryItem item;
-                item.slot = 40;
-                if (offhandItem->mItem) {
-                    item.itemType = offhandItem->mItem->getSerializedName();
-                }
-                item.count = static_cast<int>(offhandItem->mCount);
-                item.damage = offhandItem->mAuxValue;
-
-                if (offhandItem->mUserData) {
-                    try {
-                        item.nbt = offhandItem->mUserData->toSnbt();
-                    } catch (...) {}
-                }
+        BDS_LOG_INFO("\033[33m[传送] 玩家 {} ({}) 通过 UI 请求传送到服务器: {}\033[0m", name, uuid, targetServer.name);
 
-                inventory.push_back(item);
-            }
-
-            Database::getInstance().savePlayerInventory(uuid, Config::getInstance().getDatabaseConfig().serverName, inventory);
-            mod.getSelf().getLogger().info("\033[32m[传送] 已保存玩家 {} 的数据\033[0m", name);
-        } catch (const std::exception& e) {
-            mod.getSelf().getLogger().error("\033[31m[传送] 保存玩家数据失败: {}\033[0m", e.what());
-            p.sendMessage("§c传送失败：保存数据时出错");
-            return;
-        }
-
-        // 发送传送数据包
-        try {
-            TransferPacket packet(targetServer.address, targetServer.port);
-            p.sendNetworkPacket(packet);
-            mod.getSelf().getLogger().info("\033[32m[传送] 传送数据包已发送\033[0m");
-        } catch (const std::exception& e) {
-            mod.getSelf().getLogger().error("\033[31m[传送] 发送传送数据包失败: {}\033[0m", e.what());
-            p.sendMessage("§c传送失败：" + std::string(e.what()));
-            return;
-        }
-
-        p.sendMessage("§a正在传送到服务器：§b" + targetServer.name + "§r §7(" + targetServer.address + ":" + std::to_string(targetServer.port) + ")");
+        // 采集快照并异步提交，提交确认后再发送传送数据包
+        TransferPipeline::getInstance().begin(p, targetServer);
     });
 }
 
-void MyMod::setPlayerAttributesDelayed(Player& player, const PlayerSyncData& syncData) {
-    std::string playerName = player.getRealName();
-    getSelf().getLogger().info("\033[33m[数据同步] [{}] 开始设置玩家属性\033[0m", playerName);
-    getSelf().getLogger().info("\033[33m[数据同步] [{}] 目标值 - 生命值: {}/{}, 饱食度: {}, 饱和度: {}, 经验等级: {}, 经验点数: {}\033[0m", 
-        playerName, syncData.health, syncData.maxHealth, syncData.food, syncData.foodSaturation, 
-        syncData.expLevel, syncData.expPoints);
-    
-    // 获取属性并记录当前值
-    auto healthAttr = player.getAttribute(SharedAttributes::HEALTH());
-    auto hungerAttr = player.getAttribute(Player::HUNGER());
-    auto saturationAttr = player.getAttribute(Player::SATURATION());
-    auto xpAttr = player.getAttribute(Player::EXPERIENCE());
-    
-    getSelf().getLogger().info("\033[33m[数据同步] [{}] 设置前 - 生命值: {:.1f}/{:.1f}, 饱食度: {:.1f}, 饱和度: {:.1f}, 经验等级: {:.0f}, 经验进度: {:.1f}%\033[0m",
-        playerName, 
-        healthAttr.mCurrentValue, healthAttr.mCurrentMaxValue,
-        hungerAttr.mCurrentValue,
-        saturationAttr.mCurrentValue,
-        xpAttr.mCurrentMaxValue,
-        xpAttr.mCurrentValue * 100.0f);
-    
-    // 设置生命值
-    healthAttr.mCurrentMaxValue = static_cast<float>(syncData.maxHealth);
-    healthAttr.mCurrentValue = static_cast<float>(syncData.health);
-    
-    // 设置饱食度
-    hungerAttr.mCurrentValue = static_cast<float>(syncData.food);
-    
-    // 设置饱和度
-    saturationAttr.mCurrentValue = syncData.foodSaturation;
-    
-    // 设置经验等级和进度
-    xpAttr.mCurrentMaxValue = static_cast<float>(syncData.expLevel);
-    xpAttr.mCurrentValue = static_cast<float>(syncData.expPoints) / 100.0f;
-    
-    getSelf().getLogger().info("\033[33m[数据同步] [{}] 设置后 - 生命值: {:.1f}/{:.1f}, 饱食度: {:.1f}, 饱和度: {:.1f}, 经验等级: {:.0f}, 经验进度: {:.1f}%\033[0m",
-        playerName, 
-        healthAttr.mCurrentValue, healthAttr.mCurrentMaxValue,
-        hungerAttr.mCurrentValue,
-        saturationAttr.mCurrentValue,
-        xpAttr.mCurrentMaxValue,
-        xpAttr.mCurrentValue * 100.0f);
-    
-    // 延迟一小段时间，确保属性值已设置
-    std::this_thread::sleep_for(std::chrono::milliseconds(50));
-    
-    // 验证属性值是否保持
-    getSelf().getLogger().info("\033[33m[数据同步] [{}] 验证 - 生命值: {:.1f}/{:.1f}, 饱食度: {:.1f}, 饱和度: {:.1f}, 经验等级: {:.0f}, 经验进度: {:.1f}%\033[0m",
-        playerName, 
-        healthAttr.mCurrentValue, healthAttr.mCurrentMaxValue,
-        hungerAttr.mCurrentValue,
-        saturationAttr.mCurrentValue,
-        xpAttr.mCurrentMaxValue,
-        xpAttr.mCurrentValue * 100.0f);
-    
-    // 尝试同步到客户端
-    try {
-        auto& serverPlayer = static_cast<ServerPlayer&>(player);
-        serverPlayer.sendInventory(false);
-        getSelf().getLogger().info("\033[32m[数据同步] [{}] 已调用 sendInventory() 同步到客户端\033[0m", playerName);
-    } catch (const std::exception& e) {
-        getSelf().getLogger().warn("\033[33m[数据同步] [{}] sendInventory() 调用失败: {}\033[0m", playerName, e.what());
-    }
-    
-    getSelf().getLogger().info("\033[32m[数据同步] [{}] 属性设置和同步完成\033[0m", playerName);
-}
-
 } // namespace bdsmysql
 
 LL_REGISTER_MOD(bdsmysql::MyMod, bdsmysql::MyMod::getInstance());
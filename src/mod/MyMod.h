@@ -19,8 +19,11 @@
 #include "mc/deps/shared_types/legacy/item/EquipmentSlot.h"
 #include "mc/util/ActorInventoryUtils.h"
 #include "mod/Database.h"
+#include "mod/DatabaseAsync.h"
+#include "mod/JoinAdmission.h"
 #include "mod/Config.h"
 #include "mod/ServerConfig.h"
+#include <optional>
 #include <unordered_map>
 #include <string>
 #include <bitset>
@@ -34,6 +37,19 @@ struct ServerName {
 
 struct List {};
 
+enum class TraceAction { on, off, dump };
+
+struct TraceCommand {
+    TraceAction action;
+    std::string uuid;  // dump 时只导出该玩家的事件，留空导出全部
+};
+
+enum class RecordAction { start, stop };
+
+struct RecordCommand {
+    RecordAction action;
+};
+
 class MyMod {
 
 public:
@@ -63,8 +79,20 @@ class MyMod {
 
     // Map to track player join times for playtime calculation
     std::unordered_map<std::string, std::chrono::system_clock::time_point> mPlayerJoinTimes;
+    // 在线玩家的取消令牌（离线时取消该玩家尚未完成的协程）
+    std::unordered_map<std::string, CancellationToken> mPlayerTokens;
     
-    void setPlayerAttributesDelayed(Player& player, const PlayerSyncData& syncData);
+    void registerLoadingGuards();
+
+    // 加入流程协程：等待准入 -> 后台读取 -> 主线程应用，玩家离线时取消
+    GameTask runPlayerJoin(
+        std::string                   uuid,
+        std::string                   name,
+        std::string                   xuid,
+        std::optional<PlayerSnapshot> candidate,
+        CancellationToken             token
+    );
+    static Player* findOnlinePlayer(const std::string& uuid);
 };
 
 } // namespace bdsmysql
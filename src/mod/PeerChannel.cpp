@@ -0,0 +1,322 @@
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "mod/PeerChannel.h"
+#include "mod/Config.h"
+#include "mod/Log.h"
+#include "mod/SnapshotCache.h"
+#include "mod/SnapshotJson.h"
+#include "mod/Tracer.h"
+#include <string>
+
+namespace bdsmysql {
+
+namespace {
+
+#ifdef _WIN32
+using SocketHandle                          = SOCKET;
+constexpr SocketHandle kInvalidSocket       = INVALID_SOCKET;
+void                   closeSocket(SocketHandle s) { closesocket(s); }
+int                    pollSockets(pollfd* fds, unsigned long n, int timeoutMs) { return WSAPoll(fds, n, timeoutMs); }
+#else
+using SocketHandle                    = int;
+constexpr SocketHandle kInvalidSocket = -1;
+void                   closeSocket(SocketHandle s) { close(s); }
+int                    pollSockets(pollfd* fds, unsigned long n, int timeoutMs) { return poll(fds, n, timeoutMs); }
+#endif
+
+constexpr uint32_t kMaxFrameSize = 4 * 1024 * 1024;  // 单个快照上限 4MB
+constexpr char     kAck          = 1;
+constexpr char     kNack         = 0;
+
+void setBlocking(SocketHandle s, bool blocking) {
+#ifdef _WIN32
+    u_long mode = blocking ? 0 : 1;
+    ioctlsocket(s, FIONBIO, &mode);
+#else
+    int flags = fcntl(s, F_GETFL, 0);
+    fcntl(s, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK));
+#endif
+}
+
+void setTimeouts(SocketHandle s, int timeoutMs) {
+#ifdef _WIN32
+    DWORD tv = static_cast<DWORD>(timeoutMs);
+#else
+    timeval tv{timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+#endif
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&tv), sizeof(tv));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&tv), sizeof(tv));
+
+    int noDelay = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+}
+
+bool sendAll(SocketHandle s, const char* data, size_t size) {
+    while (size > 0) {
+        int sent = send(s, data, static_cast<int>(size), 0);
+        if (sent <= 0) {
+            return false;
+        }
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool recvAll(SocketHandle s, char* data, size_t size) {
+    while (size > 0) {
+        int received = recv(s, data, static_cast<int>(size), 0);
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+bool sendFrame(SocketHandle s, const std::string& payload) {
+    uint32_t size      = static_cast<uint32_t>(payload.size());
+    char     header[4] = {
+        static_cast<char>((size >> 24) & 0xFF),
+        static_cast<char>((size >> 16) & 0xFF),
+        static_cast<char>((size >> 8) & 0xFF),
+        static_cast<char>(size & 0xFF),
+    };
+    return sendAll(s, header, sizeof(header)) && sendAll(s, payload.data(), payload.size());
+}
+
+bool recvFrame(SocketHandle s, std::string& payload) {
+    unsigned char header[4];
+    if (!recvAll(s, reinterpret_cast<char*>(header), sizeof(header))) {
+        return false;
+    }
+    uint32_t size = (uint32_t(header[0]) << 24) | (uint32_t(header[1]) << 16) | (uint32_t(header[2]) << 8) | header[3];
+    if (size > kMaxFrameSize) {
+        return false;
+    }
+    payload.resize(size);
+    return recvAll(s, payload.data(), size);
+}
+
+// 带超时的连接（目标不可达时不能长时间阻塞传送）
+SocketHandle connectWithTimeout(const std::string& host, int port, int timeoutMs) {
+    addrinfo hints{};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo*   results = nullptr;
+    std::string service = std::to_string(port);
+    if (getaddrinfo(host.c_str(), service.c_str(), &hints, &results) != 0 || !results) {
+        return kInvalidSocket;
+    }
+
+    SocketHandle s = kInvalidSocket;
+    for (addrinfo* addr = results; addr; addr = addr->ai_next) {
+        s = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+        if (s == kInvalidSocket) {
+            continue;
+        }
+
+        setBlocking(s, false);
+        connect(s, addr->ai_addr, static_cast<int>(addr->ai_addrlen));
+
+        pollfd pfd{};
+        pfd.fd     = s;
+        pfd.events = POLLOUT;
+        int error  = 0;
+#ifdef _WIN32
+        int errorLen = sizeof(error);
+#else
+        socklen_t errorLen = sizeof(error);
+#endif
+        if (pollSockets(&pfd, 1, timeoutMs) == 1
+            && getsockopt(s, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &errorLen) == 0 && error == 0) {
+            setBlocking(s, true);
+            setTimeouts(s, timeoutMs);
+            break;
+        }
+
+        closeSocket(s);
+        s = kInvalidSocket;
+    }
+
+    freeaddrinfo(results);
+    return s;
+}
+
+} // namespace
+
+PeerChannel& PeerChannel::getInstance() {
+    static PeerChannel instance;
+    return instance;
+}
+
+bool PeerChannel::start() {
+    const auto& config = Config::getInstance().getDatabaseConfig().peer;
+
+    if (!config.enabled || mRunning) {
+        return true;
+    }
+    if (config.token.empty()) {
+        BDS_LOG_WARN("\033[33m[快照推送] 未配置 token，推送通道不会启动\033[0m");
+        return false;
+    }
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        BDS_LOG_ERROR("\033[31m[快照推送] 初始化 Winsock 失败\033[0m");
+        return false;
+    }
+#endif
+
+    SocketHandle listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listener == kInvalidSocket) {
+        BDS_LOG_ERROR("\033[31m[快照推送] 创建监听套接字失败\033[0m");
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons(static_cast<uint16_t>(config.port));
+    if (inet_pton(AF_INET, config.bindHost.c_str(), &addr.sin_addr) != 1
+        || bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listener, 16) != 0) {
+        BDS_LOG_ERROR("\033[31m[快照推送] 监听 {}:{} 失败\033[0m", config.bindHost, config.port);
+        closeSocket(listener);
+        return false;
+    }
+
+    mListenSocket = static_cast<intptr_t>(listener);
+    mRunning      = true;
+    mListenThread = std::thread([this] { acceptLoop(); });
+
+    BDS_LOG_INFO("\033[32m[快照推送] 正在监听 {}:{}\033[0m", config.bindHost, config.port);
+    return true;
+}
+
+void PeerChannel::stop() {
+    if (!mRunning.exchange(false)) {
+        return;
+    }
+
+    if (mListenThread.joinable()) {
+        mListenThread.join();
+    }
+    closeSocket(static_cast<SocketHandle>(mListenSocket));
+    mListenSocket = -1;
+
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void PeerChannel::acceptLoop() {
+    auto listener = static_cast<SocketHandle>(mListenSocket);
+
+    while (mRunning) {
+        // 定期醒来检查 mRunning，保证 stop() 能及时返回
+        pollfd pfd{};
+        pfd.fd     = listener;
+        pfd.events = POLLIN;
+        if (pollSockets(&pfd, 1, 200) <= 0) {
+            continue;
+        }
+
+        SocketHandle client = accept(listener, nullptr, nullptr);
+        if (client == kInvalidSocket) {
+            continue;
+        }
+
+        // 每个连接只承载一个快照，处理很快，直接在监听线程完成
+        handleConnection(static_cast<intptr_t>(client));
+        closeSocket(client);
+    }
+}
+
+void PeerChannel::handleConnection(intptr_t clientHandle) {
+    auto        client = static_cast<SocketHandle>(clientHandle);
+    const auto& config = Config::getInstance().getDatabaseConfig().peer;
+
+    setTimeouts(client, config.timeoutMs);
+
+    std::string payload;
+    if (!recvFrame(client, payload)) {
+        return;
+    }
+
+    bool accepted = false;
+    try {
+        auto parseStart = Tracer::Clock::now();
+        auto message    = nlohmann::json::parse(payload);
+        if (message.value("token", "") != config.token) {
+            BDS_LOG_WARN("\033[33m[快照推送] 拒绝 token 不匹配的推送\033[0m");
+        } else {
+            auto snapshot = message.at("snapshot").get<PlayerSnapshot>();
+
+            // 解析完成后才知道所属玩家，时间段在这里补记
+            TraceKey traceKey(snapshot.syncData.uuid);
+            if (Tracer::enabled()) {
+                Tracer::getInstance().complete("peer.parse", parseStart, Tracer::Clock::now());
+            }
+
+            BDS_LOG_INFO(
+                "\033[32m[快照推送] 已接收玩家 {} 的快照 (版本 {}, 来自 {})\033[0m",
+                snapshot.syncData.uuid,
+                snapshot.version,
+                snapshot.syncData.serverName
+            );
+            SnapshotCache::getInstance().put(std::move(snapshot));
+            accepted = true;
+        }
+    } catch (const std::exception& e) {
+        BDS_LOG_WARN("\033[33m[快照推送] 解析推送数据失败: {}\033[0m", e.what());
+    }
+
+    char reply = accepted ? kAck : kNack;
+    sendAll(client, &reply, 1);
+}
+
+bool PeerChannel::pushSnapshot(const ServerConfig& target, const PlayerSnapshot& snapshot) {
+    const auto& config = Config::getInstance().getDatabaseConfig().peer;
+    if (!mRunning || target.peerPort <= 0) {
+        return false;
+    }
+
+    TraceSpan   span("peer.push");
+    std::string payload;
+    {
+        TraceSpan      serializeSpan("peer.serialize");
+        nlohmann::json message;
+        message["token"]    = config.token;
+        message["snapshot"] = snapshot;
+        payload             = message.dump();
+    }
+
+    SocketHandle s = connectWithTimeout(target.address, target.peerPort, config.timeoutMs);
+    if (s == kInvalidSocket) {
+        return false;
+    }
+
+    char reply = kNack;
+    bool ok    = sendFrame(s, payload) && recvAll(s, &reply, 1) && reply == kAck;
+    closeSocket(s);
+    return ok;
+}
+
+} // namespace bdsmysql
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "mod/Database.h"
+#include "mod/ServerConfig.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace bdsmysql {
+
+// 服务器间快照推送通道（TCP，长度前缀 + JSON）
+// 源服务器在快照提交后把它推送到目标服务器的 SnapshotCache，目标服务器加入时可免去 MySQL 读取
+class PeerChannel {
+public:
+    static PeerChannel& getInstance();
+
+    bool start();  // 按配置监听推送端口
+    void stop();
+    bool isRunning() const { return mRunning; }
+
+    // 推送已提交的快照并等待确认（阻塞，仅在后台线程调用）
+    bool pushSnapshot(const ServerConfig& target, const PlayerSnapshot& snapshot);
+
+private:
+    PeerChannel()  = default;
+    ~PeerChannel() = default;
+
+    PeerChannel(const PeerChannel&)            = delete;
+    PeerChannel& operator=(const PeerChannel&) = delete;
+
+    void acceptLoop();
+    void handleConnection(intptr_t client);
+
+    std::thread       mListenThread;
+    intptr_t          mListenSocket = -1;
+    std::atomic<bool> mRunning      = false;
+};
+
+} // namespace bdsmysql
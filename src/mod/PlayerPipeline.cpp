@@ -0,0 +1,213 @@
+#include "mod/PlayerPipeline.h"
+#include "mod/AllocStats.h"
+#include "mod/DatabaseExecutor.h"
+#include "mod/Log.h"
+#include "mod/Metrics.h"
+#include "mod/Tracer.h"
+#include <memory>
+#include <stdexcept>
+
+namespace bdsmysql {
+
+PlayerPipeline& PlayerPipeline::getInstance() {
+    static PlayerPipeline instance;
+    return instance;
+}
+
+PlayerLoadResult PlayerPipeline::load(
+    const std::string&                   uuid,
+    const std::string&                   name,
+    const std::string&                   xuid,
+    const std::optional<PlayerSnapshot>& cached
+) {
+    AllocScope allocScope(AllocStage::JoinLoad);
+
+    PlayerLoadResult result;
+    if (prepare(uuid, name, cached)) {
+        result.fromCache = true;
+        result.snapshot  = *cached;
+    } else {
+        SnapshotLoad load;
+        if (!Database::getInstance().loadPlayerSnapshot(uuid, load)) {
+            throw std::runtime_error("读取玩家快照失败");
+        }
+        result = fromSnapshot(load);
+    }
+
+    // 之后写入本地日志的快照以这个版本号为重放条件
+    SaveQueue::getInstance().noteVersion(uuid, result.snapshot.version);
+
+    // 更新玩家基础数据
+    updatePlayerRecord(uuid, name, xuid);
+    return result;
+}
+
+bool PlayerPipeline::prepare(
+    const std::string&                   uuid,
+    const std::string&                   name,
+    const std::optional<PlayerSnapshot>& cached
+) {
+    // 上次离开时未能写入的快照先写入数据库（版本号未变化时），再读取
+    SaveQueue::getInstance().flushJournal(uuid);
+
+    if (!cached) {
+        return false;
+    }
+
+    // 推送的快照必须与数据库中的最新版本一致，否则回退到 MySQL
+    uint64_t version = 0;
+    if (Database::getInstance().loadSnapshotVersion(uuid, version) && version == cached->version) {
+        return true;
+    }
+    BDS_LOG_INFO(
+        "\033[33m[快照推送] 玩家 {} 的缓存快照已过期 (缓存版本 {}, 数据库版本 {})，从数据库加载\033[0m",
+        name,
+        cached->version,
+        version
+    );
+    return false;
+}
+
+PlayerLoadResult PlayerPipeline::fromSnapshot(SnapshotLoad& load) {
+    PlayerLoadResult result;
+    result.hasSyncData      = load.hasSyncData;
+    result.hasInventoryData = !load.snapshot.items.empty();
+    result.snapshot         = std::move(load.snapshot);
+    return result;
+}
+
+void PlayerPipeline::apply(PlayerStateSource& source, PlayerStateSink& sink, PlayerLoadResult& result) {
+    std::string uuid = source.uuid();
+    TraceKey    traceKey(uuid);
+
+    static const auto kLatency = Metrics::getInstance().histogram("join.apply");
+    ScopedTimer       timer(kLatency);
+    AllocScope        allocScope(AllocStage::JoinApply);
+
+    std::string name     = source.name();
+    auto&       snapshot = result.snapshot;
+
+    if (result.fromCache) {
+        sink.applyAttributes(snapshot.syncData);
+        sink.applyInventory(snapshot.items);
+        BDS_LOG_INFO("\033[32m[快照推送] 已从推送的快照加载玩家 {} 的数据 (版本 {})\033[0m", name, snapshot.version);
+        return;
+    }
+
+    // 数据库中缺少的部分用玩家当前状态补齐（在应用数据库数据之前采集）
+    std::shared_ptr<PlayerSnapshot> current;
+    if (!result.hasSyncData || !result.hasInventoryData) {
+        current = std::make_shared<PlayerSnapshot>(source.capture());
+    }
+
+    // ===== 处理玩家属性数据（生命值、饱食度、经验） =====
+    if (!result.hasSyncData) {
+        // 玩家没有数据库数据：创建默认记录
+        BDS_LOG_INFO("\033[33m[经验同步] 玩家 {} 没有数据库数据，创建默认记录\033[0m", name);
+    } else {
+        auto& syncData = snapshot.syncData;
+        BDS_LOG_INFO("\033[33m[数据同步] 玩家 {} 有数据库数据，正在加载\033[0m", name);
+        BDS_LOG_DEBUG(
+            "\033[33m[数据同步] 数据库数据 - 生命值: {}, 饱食度: {}, 饱和度: {}, 经验等级: {}, 经验点数: {}\033[0m",
+            syncData.health,
+            syncData.food,
+            syncData.foodSaturation,
+            syncData.expLevel,
+            syncData.expPoints
+        );
+
+        sink.applyAttributes(syncData);
+        BDS_LOG_INFO("\033[32m[数据同步] 属性加载完成\033[0m");
+    }
+
+    // ===== 处理背包和装备数据 =====
+    if (!result.hasInventoryData) {
+        // 玩家没有数据库数据：保存当前背包和装备到数据库
+        BDS_LOG_INFO("\033[33m[数据同步] 玩家 {} 没有背包/装备数据，保存当前数据到数据库\033[0m", name);
+    } else {
+        // 玩家有数据库数据：直接加载数据库数据覆盖玩家数据
+        auto& items = snapshot.items;
+        BDS_LOG_INFO("\033[33m[背包同步] 已加载 {} 个背包物品\033[0m", items.countSlots(0, ItemList::kLastBackpackSlot));
+        BDS_LOG_INFO(
+            "\033[33m[装备同步] 已加载 {} 个装备物品\033[0m",
+            items.countSlots(ItemList::kFirstEquipmentSlot, ItemList::kLastEquipmentSlot)
+        );
+
+        sink.applyInventory(snapshot.items);
+
+        BDS_LOG_INFO("\033[32m[数据同步] 已加载玩家 {} 的背包和装备数据\033[0m", name);
+    }
+
+    if (!current) {
+        return;
+    }
+
+    // 补齐的数据在该玩家的 strand 上写入
+    bool saveSyncData  = !result.hasSyncData;
+    bool saveInventory = !result.hasInventoryData;
+    DatabaseExecutor::getInstance().post(uuid, [current, name, saveSyncData, saveInventory] {
+        AllocScope allocScope(AllocStage::SaveCommit);
+
+        auto& uuid       = current->syncData.uuid;
+        auto& serverName = current->syncData.serverName;
+
+        if (saveSyncData && Database::getInstance().savePlayerSyncData(current->syncData)) {
+            BDS_LOG_INFO("\033[32m[数据同步] 已创建玩家 {} 的默认数据记录\033[0m", name);
+        }
+        if (saveInventory) {
+            auto& items = current->items;
+            if (Database::getInstance().savePlayerBackpack(uuid, serverName, items)) {
+                BDS_LOG_INFO(
+                    "\033[32m[背包同步] 已保存玩家 {} 的 {} 个背包槽位\033[0m",
+                    name,
+                    items.countSlots(0, ItemList::kLastBackpackSlot)
+                );
+            }
+            if (Database::getInstance().savePlayerEquipment(uuid, serverName, items)) {
+                BDS_LOG_INFO(
+                    "\033[32m[装备同步] 已保存玩家 {} 的 {} 个装备\033[0m",
+                    name,
+                    items.countSlots(ItemList::kFirstEquipmentSlot, ItemList::kLastEquipmentSlot)
+                );
+            }
+        }
+
+        // 补齐写入递增了版本号
+        uint64_t version = 0;
+        if (Database::getInstance().loadSnapshotVersion(uuid, version)) {
+            SaveQueue::getInstance().noteVersion(uuid, version);
+        }
+    }, JobPriority::LeaveSave);
+}
+
+bool PlayerPipeline::save(PlayerStateSource& source, SaveReason reason, SaveQueue::Callback callback) {
+    AllocScope allocScope(AllocStage::Capture);
+    try {
+        return SaveQueue::getInstance().enqueue(source.capture(), reason, std::move(callback));
+    } catch (const std::exception& e) {
+        BDS_LOG_ERROR("\033[31m[数据同步] 采集玩家 {} 的数据失败: {}\033[0m", source.name(), e.what());
+        return false;
+    }
+}
+
+void PlayerPipeline::updatePlayerRecord(const std::string& uuid, const std::string& name, const std::string& xuid) {
+    PlayerData data;
+    data.uuid     = uuid;
+    data.name     = name;
+    data.xuid     = xuid;
+    data.playTime = 0;
+    data.isOnline = true;
+
+    if (Database::getInstance().isPlayerExists(uuid)) {
+        Database::getInstance().loadPlayerData(uuid, data);
+        data.isOnline = true;
+        Database::getInstance().updatePlayerData(data);
+        BDS_LOG_INFO("\033[32m[玩家] 已更新玩家 {} 的数据\033[0m", name);
+    } else {
+        // 新玩家：创建记录
+        Database::getInstance().savePlayerData(data);
+        BDS_LOG_INFO("\033[32m[玩家] 已保存新玩家 {} 的数据\033[0m", name);
+    }
+}
+
+} // namespace bdsmysql
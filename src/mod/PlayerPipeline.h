@@ -0,0 +1,53 @@
+#pragma once
+
+#include "mod/Database.h"
+#include "mod/JoinAdmission.h"
+#include "mod/PlayerState.h"
+#include "mod/SaveQueue.h"
+#include <optional>
+#include <string>
+
+namespace bdsmysql {
+
+// 加入/离开流程中与游戏无关的部分：后台读取、主线程应用和离线保存。
+// 只通过 PlayerStateSource/Sink 访问玩家：服务器中传入 BdsPlayerState，
+// 主机端基准测试传入 MemoryPlayerState（见 bench/PipelineBench.cpp）
+class PlayerPipeline {
+public:
+    static PlayerPipeline& getInstance();
+
+    // 后台线程（该玩家的 strand）：同步读取加入所需的数据（cached 为其它服务器推送、尚待版本校验的快照），
+    // 并更新玩家基础记录。读取失败时抛出异常。服务器中的加入流程见 MyMod::runPlayerJoin
+    PlayerLoadResult load(
+        const std::string&                   uuid,
+        const std::string&                   name,
+        const std::string&                   xuid,
+        const std::optional<PlayerSnapshot>& cached
+    );
+
+    // 后台线程（该玩家的 strand）：读取前写入本地日志中该玩家的快照，并校验推送的快照
+    /// @return True if the cached snapshot is still the latest version.
+    bool prepare(const std::string& uuid, const std::string& name, const std::optional<PlayerSnapshot>& cached);
+
+    // 由数据库读取的快照生成加入结果
+    static PlayerLoadResult fromSnapshot(SnapshotLoad& load);
+
+    // 主线程：把读取结果应用到玩家，数据库中缺少的部分用玩家当前状态补齐（在该玩家的 strand 上写入）
+    void apply(PlayerStateSource& source, PlayerStateSink& sink, PlayerLoadResult& result);
+
+    // 主线程：采集快照并交给保存队列
+    /// @return False if the snapshot was not queued (capture failed, dropped or written to the journal).
+    bool save(PlayerStateSource& source, SaveReason reason, SaveQueue::Callback callback = {});
+
+    // 后台线程：创建或更新 player_data 中的记录
+    void updatePlayerRecord(const std::string& uuid, const std::string& name, const std::string& xuid);
+
+private:
+    PlayerPipeline()  = default;
+    ~PlayerPipeline() = default;
+
+    PlayerPipeline(const PlayerPipeline&)            = delete;
+    PlayerPipeline& operator=(const PlayerPipeline&) = delete;
+};
+
+} // namespace bdsmysql
@@ -0,0 +1,48 @@
+#include "mod/PlayerState.h"
+#include "mod/Config.h"
+#include <algorithm>
+#include <utility>
+
+namespace bdsmysql {
+
+MemoryPlayerState::MemoryPlayerState(std::string uuid, std::string name, PlayerSnapshot state)
+: mUuid(std::move(uuid)),
+  mName(std::move(name)),
+  mState(std::move(state)) {
+    mState.syncData.uuid = mUuid;
+}
+
+PlayerSnapshot MemoryPlayerState::capture() {
+    PlayerSnapshot snapshot;
+    snapshot.syncData            = mState.syncData;
+    snapshot.syncData.serverName = Config::getInstance().getDatabaseConfig().serverName;
+    snapshot.items               = mState.items;
+    return snapshot;
+}
+
+void MemoryPlayerState::applyAttributes(const PlayerSyncData& data) {
+    mState.syncData      = data;
+    mState.syncData.uuid = mUuid;
+    mApplyCount++;
+}
+
+void MemoryPlayerState::applyInventory(const ItemList& items) {
+    // 保留列表中没有出现的槽位，与游戏中按槽位覆盖的行为一致
+    ItemList merged;
+    merged.reserve(mState.items.size() + items.size(), 0);
+    for (const auto& record : mState.items) {
+        bool replaced = std::any_of(items.begin(), items.end(), [&](const ItemRecord& item) {
+            return item.slot == record.slot;
+        });
+        if (!replaced) {
+            merged.add(record.slot, record.itemType(), record.count, record.damage, mState.items.nbt(record));
+        }
+    }
+    for (const auto& item : items) {
+        merged.add(item.slot, item.itemType(), item.count, item.damage, items.nbt(item));
+    }
+    mState.items = std::move(merged);
+    mApplyCount++;
+}
+
+} // namespace bdsmysql
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "mod/Database.h"
+#include <string>
+
+namespace bdsmysql {
+
+// 读取游戏中玩家的状态。加入/离开流程只通过该接口采集玩家数据，
+// 服务器中由 BdsPlayerState 实现，主机端测试和基准测试使用 MemoryPlayerState
+class PlayerStateSource {
+public:
+    virtual ~PlayerStateSource() = default;
+
+    virtual std::string uuid() const = 0;
+    virtual std::string name() const = 0;
+
+    // 采集完整快照（属性 + 背包 0-35 + 装备 36-40，空槽位也写入），在主线程调用
+    virtual PlayerSnapshot capture() = 0;
+};
+
+// 把数据库或推送的数据写回游戏中的玩家，在主线程调用
+class PlayerStateSink {
+public:
+    virtual ~PlayerStateSink() = default;
+
+    virtual void applyAttributes(const PlayerSyncData& data) = 0;
+    // 按槽位覆盖列表中出现的槽位，并同步到客户端
+    virtual void applyInventory(const ItemList& items) = 0;
+};
+
+// 内存中的玩家：不依赖 BDS，用于在服务器之外运行加入/离开流程
+class MemoryPlayerState : public PlayerStateSource, public PlayerStateSink {
+public:
+    MemoryPlayerState(std::string uuid, std::string name, PlayerSnapshot state);
+
+    std::string    uuid() const override { return mUuid; }
+    std::string    name() const override { return mName; }
+    PlayerSnapshot capture() override;
+
+    void applyAttributes(const PlayerSyncData& data) override;
+    void applyInventory(const ItemList& items) override;
+
+    const PlayerSnapshot& state() const { return mState; }
+    int                   getApplyCount() const { return mApplyCount; }
+
+private:
+    std::string    mUuid;
+    std::string    mName;
+    PlayerSnapshot mState;
+    int            mApplyCount = 0;  // applyAttributes 和 applyInventory 的调用次数
+};
+
+} // namespace bdsmysql
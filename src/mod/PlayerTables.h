@@ -0,0 +1,122 @@
+#pragma once
+
+#include "mod/Database.h"
+#include "mod/TableSchema.h"
+
+// 数据表定义：建表语句、查询列和写入参数都由这里的列声明生成，修改表结构只需改这一处。
+// 已有的表不会被修改，新增列需要在 Database::initTables 中调用 ensureColumn
+namespace bdsmysql::tables {
+
+using schema::Key;
+using schema::NullIfEmpty;
+using schema::Owner;
+using schema::Select;
+using schema::Write;
+
+inline constexpr auto kPlayerData = schema::table<PlayerData>(
+    "player_data",
+    "INDEX `idx_uuid` (`uuid`),\n    INDEX `idx_name` (`name`)",
+    schema::field("id", "INT AUTO_INCREMENT PRIMARY KEY", &PlayerData::id, Select),
+    schema::field("uuid", "VARCHAR(36) NOT NULL UNIQUE", &PlayerData::uuid, Select | Key),
+    schema::field("name", "VARCHAR(16) NOT NULL", &PlayerData::name, Select),
+    schema::field("xuid", "VARCHAR(32) DEFAULT NULL", &PlayerData::xuid, Select),
+    schema::field("join_date", "DATETIME NOT NULL", &PlayerData::joinDate, Select),
+    schema::field("last_seen", "DATETIME NOT NULL", &PlayerData::lastSeen, Select),
+    schema::field("play_time", "INT DEFAULT 0", &PlayerData::playTime, Select),
+    schema::field("is_online", "TINYINT(1) DEFAULT 0", &PlayerData::isOnline, Select)
+);
+
+// 共享数据：所有服务器共享同一份数据，server_name 只记录最后写入的服务器
+inline constexpr auto kPlayerSyncData = schema::table<PlayerSyncData>(
+    "player_sync_data",
+    "INDEX `idx_uuid` (`uuid`)",
+    schema::field("id", "INT AUTO_INCREMENT PRIMARY KEY", &PlayerSyncData::id, Select),
+    schema::field("uuid", "VARCHAR(36) NOT NULL UNIQUE", &PlayerSyncData::uuid, Select | Write | Key),
+    schema::field("server_name", "VARCHAR(32) DEFAULT NULL", &PlayerSyncData::serverName),
+    schema::field("health", "INT DEFAULT 20", &PlayerSyncData::health),
+    schema::field("max_health", "INT DEFAULT 20", &PlayerSyncData::maxHealth),
+    schema::field("food", "INT DEFAULT 20", &PlayerSyncData::food),
+    schema::field("food_saturation", "FLOAT DEFAULT 20.0", &PlayerSyncData::foodSaturation),
+    schema::field("exp_level", "INT DEFAULT 0", &PlayerSyncData::expLevel),
+    schema::field("exp_points", "INT DEFAULT 0", &PlayerSyncData::expPoints),
+    schema::field("gamemode", "INT DEFAULT 0", &PlayerSyncData::gamemode),
+    schema::column("x", "FLOAT DEFAULT 0"),  // 坐标和维度不再使用，保留列
+    schema::column("y", "FLOAT DEFAULT 64"),
+    schema::column("z", "FLOAT DEFAULT 0"),
+    schema::column("dimension", "INT DEFAULT 0"),
+    schema::field(
+        "last_sync_time",
+        "DATETIME DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP",
+        &PlayerSyncData::lastSyncTime,
+        Select
+    ),
+    schema::column("snapshot_version", "BIGINT UNSIGNED NOT NULL DEFAULT 0")
+);
+
+// 物品表的一行。文本列是视图：读取时指向结果缓冲区，写入时指向 ItemNames 和 ItemList 的存储
+struct ItemColumns {
+    int              slot = 0;
+    std::string_view itemType;
+    int              count  = 0;
+    int              damage = 0;
+    std::string_view nbt;
+};
+
+// 背包、装备和旧背包表的列相同，只有槽位范围不同
+constexpr auto itemTable(std::string_view name, std::string_view constraints) {
+    using Item = ItemColumns;
+    return schema::table<Item>(
+        name,
+        constraints,
+        schema::column("id", "INT AUTO_INCREMENT PRIMARY KEY"),
+        schema::column("uuid", "VARCHAR(36) NOT NULL", Owner | Key),
+        schema::column("server_name", "VARCHAR(32) DEFAULT NULL", Owner),
+        schema::field("slot", "INT NOT NULL", &Item::slot, Select | Write | Key),
+        schema::field("item_type", "VARCHAR(64) DEFAULT NULL", &Item::itemType),
+        schema::field("count", "INT DEFAULT 0", &Item::count),
+        schema::field("damage", "INT DEFAULT 0", &Item::damage),
+        schema::field("nbt", "TEXT DEFAULT NULL", &Item::nbt, Select | Write | NullIfEmpty)
+    );
+}
+
+inline constexpr auto kPlayerInventory = itemTable(
+    "player_inventory",
+    "UNIQUE KEY `unique_slot` (`uuid`, `slot`),\n    INDEX `idx_uuid` (`uuid`)"
+);
+
+inline constexpr auto kPlayerBackpack = itemTable(
+    "player_backpack",
+    "UNIQUE KEY `unique_slot` (`uuid`, `slot`),\n    INDEX `idx_uuid` (`uuid`),\n    CHECK (`slot` >= 0 AND `slot` <= 35)"
+);
+
+inline constexpr auto kPlayerEquipment = itemTable(
+    "player_equipment",
+    "UNIQUE KEY `unique_slot` (`uuid`, `slot`),\n    INDEX `idx_uuid` (`uuid`),\n    CHECK (`slot` >= 36 AND `slot` <= 40)"
+);
+
+// 只追加：其它服务器按序号增量读取，用于失效本地缓存
+inline constexpr auto kPlayerChangeLog = schema::table<ChangeLogEntry>(
+    "player_change_log",
+    "INDEX `idx_created_at` (`created_at`)",
+    schema::field("seq", "BIGINT UNSIGNED AUTO_INCREMENT PRIMARY KEY", &ChangeLogEntry::seq, Select),
+    schema::field("uuid", "VARCHAR(36) NOT NULL", &ChangeLogEntry::uuid, Select),
+    schema::field("table_name", "VARCHAR(32) NOT NULL", &ChangeLogEntry::tableName, Select),
+    schema::field("version", "BIGINT UNSIGNED NOT NULL DEFAULT 0", &ChangeLogEntry::version, Select),
+    schema::field("server_name", "VARCHAR(32) DEFAULT NULL", &ChangeLogEntry::serverName, Select),
+    schema::column("created_at", "TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP")
+);
+
+// 插件元数据（键值对）。schema_fingerprint 为上次建表时的表结构指纹，与当前代码一致时启动跳过建表
+struct MetaEntry {
+    std::string_view name;
+    std::string_view value;
+};
+
+inline constexpr auto kSchemaMeta = schema::table<MetaEntry>(
+    "bdsmysql_meta",
+    "",
+    schema::field("name", "VARCHAR(64) NOT NULL PRIMARY KEY", &MetaEntry::name, Select | Write | Key),
+    schema::field("value", "VARCHAR(255) NOT NULL", &MetaEntry::value, Select | Write)
+);
+
+} // namespace bdsmysql::tables
@@ -0,0 +1,537 @@
+#include "mod/QueryRecorder.h"
+#include "ll/api/io/Logger.h"
+#include "ll/api/mod/NativeMod.h"
+#include "mod/Config.h"
+#include "mod/Log.h"
+#include "mod/SlowQueryLog.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+#include <iterator>
+#include <random>
+#include <sstream>
+
+namespace bdsmysql {
+
+namespace {
+
+using recording::ParamType;
+using recording::RecordType;
+using recording::ShapeKind;
+
+static_assert(std::endian::native == std::endian::little, "录制文件按小端写入");
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+void putFixed64(std::string& out, uint64_t value) {
+    char bytes[8];
+    std::memcpy(bytes, &value, sizeof(bytes));
+    out.append(bytes, sizeof(bytes));
+}
+
+void putBytes(std::string& out, std::string_view bytes) {
+    putVarint(out, bytes.size());
+    out.append(bytes);
+}
+
+uint64_t toMicros(std::chrono::steady_clock::duration duration) {
+    return static_cast<uint64_t>(
+        std::max<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), 0)
+    );
+}
+
+uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z          = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// 等长的伪随机十六进制文本：同一个盐下相同的输入得到相同的输出，保留键的重复和长度分布
+void appendAnonymized(std::string& out, std::string_view text, uint64_t salt) {
+    uint64_t state = 0xCBF29CE484222325ull ^ salt;
+    for (unsigned char c : text) {
+        state = (state ^ c) * 0x100000001B3ull;
+    }
+
+    constexpr char kDigits[] = "0123456789abcdef";
+    uint64_t       word      = 0;
+    for (size_t i = 0; i < text.size(); i++) {
+        if (i % 16 == 0) {
+            word = splitmix64(state);
+        }
+        out += kDigits[(word >> ((i % 16) * 4)) & 0xF];
+    }
+}
+
+template <class T>
+T readBuffer(const MYSQL_BIND& bind) {
+    T value;
+    std::memcpy(&value, bind.buffer, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+std::atomic<bool> QueryRecorder::sRecording{false};
+
+QueryRecorder& QueryRecorder::getInstance() {
+    static QueryRecorder instance;
+    return instance;
+}
+
+void QueryRecorder::start() {
+    if (Config::getInstance().getDatabaseConfig().recorder.enabled) {
+        begin();
+    }
+}
+
+void QueryRecorder::stop() { end(); }
+
+std::optional<std::string> QueryRecorder::begin() {
+    std::lock_guard control(mControlMutex);
+    {
+        std::lock_guard lock(mMutex);
+        if (mActive) {
+            return mStats.path;
+        }
+    }
+
+    // 上一次录制因文件达到上限而自行停止时，写入线程已经退出
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+    if (mFile.is_open()) {
+        mFile.close();
+    }
+
+    const auto& config = Config::getInstance().getDatabaseConfig().recorder;
+    std::string path;
+    try {
+        auto now  = std::time(nullptr);
+        auto time = *std::localtime(&now);
+
+        std::ostringstream fileName;
+        fileName << "queries-" << std::put_time(&time, "%Y%m%d-%H%M%S") << ".bqr";
+
+        auto directory = ll::mod::NativeMod::current()->getModDir() / config.directory;
+        std::filesystem::create_directories(directory);
+        path = (directory / fileName.str()).string();
+    } catch (const std::exception& e) {
+        BDS_LOG_ERROR("\033[31m[查询录制] 创建录制目录失败: {}\033[0m", e.what());
+        return std::nullopt;
+    }
+
+    mFile.open(path, std::ios::binary | std::ios::trunc);
+    if (!mFile) {
+        BDS_LOG_ERROR("\033[31m[查询录制] 无法创建录制文件: {}\033[0m", path);
+        return std::nullopt;
+    }
+
+    auto sinceEpoch = std::chrono::system_clock::now().time_since_epoch();
+    auto unixMs     = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(sinceEpoch).count());
+
+    std::string header(recording::kMagic, sizeof(recording::kMagic));
+    putFixed64(header, unixMs);
+    mFile.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    // 每次录制使用新的盐，不同录制文件之间的匿名文本无法对应
+    uint64_t seed = (static_cast<uint64_t>(std::random_device{}()) << 32) ^ unixMs;
+    mAnonymize.store(config.anonymize, std::memory_order_relaxed);
+    mSalt.store(splitmix64(seed), std::memory_order_relaxed);
+    mBytes.store(header.size(), std::memory_order_relaxed);
+    mMaxBytes = static_cast<uint64_t>(std::max(config.maxFileMB, 1)) * 1024 * 1024;
+
+    {
+        std::lock_guard lock(mMutex);
+        mPending.clear();
+        mShapeIds.clear();
+        mLanes.clear();
+        mCapacity     = static_cast<size_t>(std::max(config.queueCapacity, 1024));
+        mStart        = Clock::now();
+        mStats        = {};
+        mStats.active = true;
+        mStats.path   = path;
+        mActive       = true;
+    }
+    mThread = std::thread([this] { run(); });
+    sRecording.store(true, std::memory_order_release);
+
+    BDS_LOG_INFO(
+        "\033[32m[查询录制] 开始录制到 {}（{}）\033[0m",
+        path,
+        config.anonymize ? "字符串参数已匿名化" : "保留原始参数"
+    );
+    return path;
+}
+
+RecorderStats QueryRecorder::end() {
+    std::lock_guard control(mControlMutex);
+    sRecording.store(false, std::memory_order_release);
+    {
+        std::lock_guard lock(mMutex);
+        mActive = false;
+    }
+    mCv.notify_all();
+
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+    if (!mFile.is_open()) {
+        return stats();
+    }
+    mFile.close();
+
+    auto result = stats();
+    BDS_LOG_INFO(
+        "\033[32m[查询录制] 已停止：{} 条语句，{:.1f} MB，丢弃 {} 条 ({})\033[0m",
+        result.queries,
+        static_cast<double>(result.bytes) / (1024.0 * 1024.0),
+        result.dropped,
+        result.path
+    );
+    return result;
+}
+
+RecorderStats QueryRecorder::stats() const {
+    std::lock_guard lock(mMutex);
+    RecorderStats   result = mStats;
+    result.active          = mActive;
+    result.bytes           = mBytes.load(std::memory_order_relaxed);
+    return result;
+}
+
+void QueryRecorder::appendString(std::string& out, std::string_view text) const {
+    out += static_cast<char>(ParamType::String);
+    if (!mAnonymize.load(std::memory_order_relaxed)) {
+        putBytes(out, text);
+        return;
+    }
+    putVarint(out, text.size());
+    appendAnonymized(out, text, mSalt.load(std::memory_order_relaxed));
+}
+
+void QueryRecorder::recordText(
+    const void*       conn,
+    std::string_view  sql,
+    Clock::time_point start,
+    Clock::duration   elapsed,
+    uint64_t          rows,
+    bool              failed
+) {
+    std::vector<SqlLiteral> literals;
+    std::string             shape = SlowQueryLog::shapeOf(sql, nullptr, &literals);
+
+    std::string params;
+    putVarint(params, literals.size());
+    for (const auto& literal : literals) {
+        if (literal.quoted) {
+            appendString(params, literal.text);
+        } else {
+            params += static_cast<char>(ParamType::Number);
+            putBytes(params, literal.text);
+        }
+    }
+    commit(conn, std::move(shape), ShapeKind::Text, start, elapsed, rows, failed, params);
+}
+
+void QueryRecorder::recordStatement(
+    const void*       conn,
+    std::string_view  sql,
+    const MYSQL_BIND* binds,
+    unsigned long     bindCount,
+    Clock::time_point start,
+    Clock::duration   elapsed,
+    uint64_t          rows,
+    bool              failed
+) {
+    std::string params;
+    putVarint(params, bindCount);
+    for (unsigned long i = 0; i < bindCount; i++) {
+        const auto& bind = binds[i];
+        if (bind.buffer_type == MYSQL_TYPE_NULL || !bind.buffer || (bind.is_null && *bind.is_null)) {
+            params += static_cast<char>(ParamType::Null);
+            continue;
+        }
+
+        auto putInt = [&](int64_t value, uint64_t unsignedValue) {
+            if (bind.is_unsigned) {
+                params += static_cast<char>(ParamType::UInt);
+                putVarint(params, unsignedValue);
+            } else {
+                params += static_cast<char>(ParamType::Int);
+                putVarint(params, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+            }
+        };
+        auto putDouble = [&](double value) {
+            params += static_cast<char>(ParamType::Double);
+            putFixed64(params, std::bit_cast<uint64_t>(value));
+        };
+
+        switch (bind.buffer_type) {
+        case MYSQL_TYPE_TINY:
+            putInt(readBuffer<int8_t>(bind), readBuffer<uint8_t>(bind));
+            break;
+        case MYSQL_TYPE_SHORT:
+            putInt(readBuffer<int16_t>(bind), readBuffer<uint16_t>(bind));
+            break;
+        case MYSQL_TYPE_LONG:
+            putInt(readBuffer<int32_t>(bind), readBuffer<uint32_t>(bind));
+            break;
+        case MYSQL_TYPE_LONGLONG:
+            putInt(readBuffer<int64_t>(bind), readBuffer<uint64_t>(bind));
+            break;
+        case MYSQL_TYPE_FLOAT:
+            putDouble(readBuffer<float>(bind));
+            break;
+        case MYSQL_TYPE_DOUBLE:
+            putDouble(readBuffer<double>(bind));
+            break;
+        case MYSQL_TYPE_STRING:
+        case MYSQL_TYPE_VAR_STRING:
+        case MYSQL_TYPE_VARCHAR:
+        case MYSQL_TYPE_BLOB:
+        case MYSQL_TYPE_TINY_BLOB:
+        case MYSQL_TYPE_MEDIUM_BLOB:
+        case MYSQL_TYPE_LONG_BLOB:
+        case MYSQL_TYPE_DECIMAL:
+        case MYSQL_TYPE_NEWDECIMAL: {
+            size_t length = bind.length ? *bind.length : bind.buffer_length;
+            appendString(params, {static_cast<const char*>(bind.buffer), length});
+            break;
+        }
+        default:
+            // Database 不绑定日期等其它类型；录制为 NULL，重放时参数个数保持一致
+            params += static_cast<char>(ParamType::Null);
+            break;
+        }
+    }
+    commit(conn, std::string(sql), ShapeKind::Prepared, start, elapsed, rows, failed, params);
+}
+
+void QueryRecorder::commit(
+    const void*          conn,
+    std::string          shape,
+    recording::ShapeKind kind,
+    Clock::time_point    start,
+    Clock::duration      elapsed,
+    uint64_t             rows,
+    bool                 failed,
+    const std::string&   params
+) {
+    std::string record;
+    {
+        std::lock_guard lock(mMutex);
+        if (!mActive) {
+            return;
+        }
+        if (mPending.size() >= mCapacity) {
+            mStats.dropped++;
+            return;
+        }
+
+        // 新形态先写形态记录，与查询记录放在同一块中，保证读取时形态总在引用它的查询之前
+        std::string key = static_cast<char>(kind) + shape;
+        auto [it, inserted] = mShapeIds.try_emplace(std::move(key), static_cast<uint32_t>(mShapeIds.size()));
+        if (inserted) {
+            record += static_cast<char>(RecordType::Shape);
+            putVarint(record, it->second);
+            record += static_cast<char>(kind);
+            putBytes(record, shape);
+        }
+        uint32_t lane = mLanes.try_emplace(conn, static_cast<uint32_t>(mLanes.size())).first->second;
+
+        record.reserve(record.size() + params.size() + 32);
+        record += static_cast<char>(RecordType::Query);
+        putVarint(record, it->second);
+        putVarint(record, lane);
+        putVarint(record, start > mStart ? toMicros(start - mStart) : 0);
+        putVarint(record, toMicros(elapsed));
+        putVarint(record, rows);
+        record += static_cast<char>(failed ? recording::kFlagFailed : 0);
+        record += params;
+
+        mPending.push_back(std::move(record));
+        mStats.queries++;
+        if (mPending.size() != 1) {
+            return;
+        }
+    }
+    mCv.notify_one();
+}
+
+void QueryRecorder::run() {
+    std::deque<std::string> batch;
+    std::unique_lock        lock(mMutex);
+    while (true) {
+        mCv.wait(lock, [this] { return !mActive || !mPending.empty(); });
+        if (mPending.empty()) {
+            break;  // 已停止且队列已写完
+        }
+
+        batch.swap(mPending);
+        lock.unlock();
+
+        uint64_t written = 0;
+        for (const auto& record : batch) {
+            mFile.write(record.data(), static_cast<std::streamsize>(record.size()));
+            written += record.size();
+        }
+        batch.clear();
+        uint64_t bytes  = mBytes.fetch_add(written, std::memory_order_relaxed) + written;
+        bool     failed = !mFile;
+
+        lock.lock();
+        if ((bytes >= mMaxBytes || failed) && mActive) {
+            // 达到上限或写入失败：自行停止录制，剩余的记录照常写完
+            mActive = false;
+            sRecording.store(false, std::memory_order_release);
+            if (failed) {
+                BDS_LOG_ERROR("\033[31m[查询录制] 写入录制文件失败，已停止录制: {}\033[0m", mStats.path);
+            } else {
+                BDS_LOG_WARN("\033[33m[查询录制] 录制文件达到 {} MB 上限，已停止录制\033[0m", mMaxBytes / (1024 * 1024));
+            }
+        }
+    }
+    mFile.flush();
+}
+
+bool RecordingReader::open(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    mData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (mData.size() < sizeof(recording::kMagic) + 8
+        || std::memcmp(mData.data(), recording::kMagic, sizeof(recording::kMagic)) != 0) {
+        return false;
+    }
+    std::memcpy(&mStartUnixMs, mData.data() + sizeof(recording::kMagic), sizeof(mStartUnixMs));
+    mPos       = sizeof(recording::kMagic) + 8;
+    mTruncated = false;
+    mShapes.clear();
+    return true;
+}
+
+bool RecordingReader::readVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && mPos < mData.size(); shift += 7) {
+        auto byte  = static_cast<uint8_t>(mData[mPos++]);
+        value     |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RecordingReader::readBytes(std::string& out) {
+    uint64_t length = 0;
+    if (!readVarint(length) || length > mData.size() - mPos) {
+        return false;
+    }
+    out.assign(mData, mPos, static_cast<size_t>(length));
+    mPos += static_cast<size_t>(length);
+    return true;
+}
+
+bool RecordingReader::next(RecordedQuery& query) {
+    while (true) {
+        if (mPos >= mData.size()) {
+            return false;
+        }
+        auto type = static_cast<RecordType>(mData[mPos++]);
+
+        if (type == RecordType::Shape) {
+            uint64_t      id = 0;
+            RecordedShape shape;
+            if (!readVarint(id) || id != mShapes.size() || mPos >= mData.size()) {
+                break;
+            }
+            shape.kind = static_cast<ShapeKind>(mData[mPos++]);
+            if (!readBytes(shape.text)) {
+                break;
+            }
+            mShapes.push_back(std::move(shape));
+            continue;
+        }
+        if (type != RecordType::Query) {
+            break;
+        }
+
+        uint64_t shapeId = 0, lane = 0, paramCount = 0;
+        if (!readVarint(shapeId) || shapeId >= mShapes.size() || !readVarint(lane) || !readVarint(query.startUs)
+            || !readVarint(query.durationUs) || !readVarint(query.rows) || mPos >= mData.size()) {
+            break;
+        }
+        query.shapeId = static_cast<uint32_t>(shapeId);
+        query.lane    = static_cast<uint32_t>(lane);
+        query.failed  = (static_cast<uint8_t>(mData[mPos++]) & recording::kFlagFailed) != 0;
+        if (!readVarint(paramCount) || paramCount > mData.size() - mPos) {
+            break;
+        }
+
+        query.params.resize(static_cast<size_t>(paramCount));
+        bool complete = true;
+        for (auto& param : query.params) {
+            if (mPos >= mData.size()) {
+                complete = false;
+                break;
+            }
+            param      = {};
+            param.type = static_cast<ParamType>(mData[mPos++]);
+
+            uint64_t value = 0;
+            switch (param.type) {
+            case ParamType::Null:
+                break;
+            case ParamType::Int:
+                complete       = readVarint(value);
+                param.intValue = static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+                break;
+            case ParamType::UInt:
+                complete       = readVarint(value);
+                param.intValue = static_cast<int64_t>(value);
+                break;
+            case ParamType::Double:
+                complete = mData.size() - mPos >= 8;
+                if (complete) {
+                    std::memcpy(&value, mData.data() + mPos, 8);
+                    param.doubleValue  = std::bit_cast<double>(value);
+                    mPos              += 8;
+                }
+                break;
+            case ParamType::String:
+            case ParamType::Number:
+                complete = readBytes(param.text);
+                break;
+            default:
+                complete = false;
+                break;
+            }
+            if (!complete) {
+                break;
+            }
+        }
+        if (!complete) {
+            break;
+        }
+        return true;
+    }
+
+    // 写入中断（进程退出、磁盘写满）留下的不完整记录：之后的内容不再读取
+    mTruncated = true;
+    mPos       = mData.size();
+    return false;
+}
+
+} // namespace bdsmysql
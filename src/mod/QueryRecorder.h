@@ -0,0 +1,171 @@
+#pragma once
+
+#include <mysql.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace bdsmysql {
+
+// 录制文件格式（整数除注明外均为 LEB128 变长编码）：
+//   文件头   "BDSQREC1" | 录制开始的 Unix 时间（毫秒，8 字节小端）
+//   形态记录 0x01 | 形态 id（从 0 连续编号） | 类型 | 长度 | 语句文本
+//   查询记录 0x02 | 形态 id | 连接编号 | 开始时间（距录制开始，微秒） | 耗时（微秒） | 影响行数 | 标志 | 参数个数 | 参数...
+//   参数     类型 | 取值（有符号整数为 zigzag，double 为 8 字节小端，字符串和数字字面量为 长度 + 内容）
+// 文本语句的形态是字面量替换为 ? 后的语句，字面量按出现顺序作为参数；预处理语句的形态就是准备时的原文
+namespace recording {
+
+inline constexpr char kMagic[8] = {'B', 'D', 'S', 'Q', 'R', 'E', 'C', '1'};
+
+enum class RecordType : uint8_t { Shape = 1, Query = 2 };
+enum class ShapeKind : uint8_t { Text = 0, Prepared = 1 };
+enum class ParamType : uint8_t { Null = 0, Int = 1, UInt = 2, Double = 3, String = 4, Number = 5 };
+
+inline constexpr uint8_t kFlagFailed = 1;  // 录制时语句执行失败
+
+} // namespace recording
+
+struct RecordedShape {
+    recording::ShapeKind kind = recording::ShapeKind::Text;
+    std::string          text;
+};
+
+struct RecordedParam {
+    recording::ParamType type        = recording::ParamType::Null;
+    int64_t              intValue    = 0;  // Int；UInt 按位保存
+    double               doubleValue = 0;
+    std::string          text;  // String（引号内的原文或匿名化后的文本）、Number（数字字面量原文）
+};
+
+struct RecordedQuery {
+    uint32_t                   shapeId    = 0;
+    uint32_t                   lane       = 0;  // 录制时的连接编号：同一连接上的语句（包括事务）按顺序执行
+    uint64_t                   startUs    = 0;
+    uint64_t                   durationUs = 0;
+    uint64_t                   rows       = 0;
+    bool                       failed     = false;
+    std::vector<RecordedParam> params;
+};
+
+struct RecorderStats {
+    bool        active  = false;
+    std::string path;
+    uint64_t    queries = 0;
+    uint64_t    dropped = 0;
+    uint64_t    bytes   = 0;
+};
+
+// 查询录制：SlowQueryProbe 和事件循环把每条语句交给录制器，编码后由后台线程追加到录制文件。
+// 未录制时每条语句只多一次原子读
+class QueryRecorder {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static QueryRecorder& getInstance();
+
+    static bool recording() { return sRecording.load(std::memory_order_relaxed); }
+
+    void start();  // recorder.enabled 为 true 时开始录制
+    void stop();   // 停止录制并写完剩余的记录
+
+    // 开始录制到 <directory>/queries-YYYYmmdd-HHMMSS.bqr，返回文件路径；已在录制时返回当前文件
+    std::optional<std::string> begin();
+    RecorderStats              end();
+    RecorderStats              stats() const;
+
+    void recordText(
+        const void*       conn,
+        std::string_view  sql,
+        Clock::time_point start,
+        Clock::duration   elapsed,
+        uint64_t          rows,
+        bool              failed
+    );
+    void recordStatement(
+        const void*       conn,
+        std::string_view  sql,
+        const MYSQL_BIND* binds,
+        unsigned long     bindCount,
+        Clock::time_point start,
+        Clock::duration   elapsed,
+        uint64_t          rows,
+        bool              failed
+    );
+
+private:
+    QueryRecorder()  = default;
+    ~QueryRecorder() = default;
+
+    QueryRecorder(const QueryRecorder&)            = delete;
+    QueryRecorder& operator=(const QueryRecorder&) = delete;
+
+    void commit(
+        const void*          conn,
+        std::string          shape,
+        recording::ShapeKind kind,
+        Clock::time_point    start,
+        Clock::duration      elapsed,
+        uint64_t             rows,
+        bool                 failed,
+        const std::string&   params
+    );
+    void appendString(std::string& out, std::string_view text) const;
+    void run();
+
+    static std::atomic<bool> sRecording;
+
+    std::mutex mControlMutex;  // 串行化 begin/end
+
+    mutable std::mutex                        mMutex;  // 保护以下成员
+    std::condition_variable                   mCv;
+    std::deque<std::string>                   mPending;
+    std::unordered_map<std::string, uint32_t> mShapeIds;  // 类型 + 形态 -> id
+    std::unordered_map<const void*, uint32_t> mLanes;
+    bool                                      mActive   = false;
+    size_t                                    mCapacity = 0;
+    Clock::time_point                         mStart;
+    RecorderStats                             mStats;
+
+    std::atomic<bool>     mAnonymize{true};
+    std::atomic<uint64_t> mSalt{0};
+    std::atomic<uint64_t> mBytes{0};
+    uint64_t              mMaxBytes = 0;
+
+    std::ofstream mFile;  // 只由写入线程访问（begin/end 在线程启动前和结束后访问）
+    std::thread   mThread;
+};
+
+// 读取录制文件（整个文件读入内存）
+class RecordingReader {
+public:
+    bool open(const std::string& path);  // 文件不存在或文件头不匹配时返回 false
+
+    // 读取下一条查询，途中的形态记录登记到 shapes()；文件结束或数据不完整时返回 false
+    bool next(RecordedQuery& query);
+
+    const std::vector<RecordedShape>& shapes() const { return mShapes; }
+    uint64_t                          startUnixMs() const { return mStartUnixMs; }
+    bool                              truncated() const { return mTruncated; }  // 末尾有不完整或无法识别的记录
+
+private:
+    bool readVarint(uint64_t& value);
+    bool readBytes(std::string& out);
+
+    std::string                mData;
+    size_t                     mPos         = 0;
+    uint64_t                   mStartUnixMs = 0;
+    bool                       mTruncated   = false;
+    std::vector<RecordedShape> mShapes;
+};
+
+} // namespace bdsmysql
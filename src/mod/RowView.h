@@ -0,0 +1,118 @@
+#pragma once
+
+#include <mysql.h>
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace bdsmysql {
+
+// 结果行的只读视图：列值是指向 MYSQL_RES 缓冲区的 string_view，不复制、不分配。
+// 视图只在所属结果释放前有效
+class RowView {
+public:
+    RowView() = default;
+    RowView(MYSQL_ROW row, const unsigned long* lengths, unsigned int fields)
+    : mRow(row),
+      mLengths(lengths),
+      mFields(fields) {}
+
+    unsigned int size() const { return mFields; }
+    bool         isNull(unsigned int i) const { return i >= mFields || mRow[i] == nullptr; }
+
+    // NULL 列返回空串
+    std::string_view text(unsigned int i) const {
+        return isNull(i) ? std::string_view{} : std::string_view(mRow[i], mLengths[i]);
+    }
+
+    // 用 from_chars 解析数值列，NULL 或格式错误时返回 fallback
+    template <class T>
+    T number(unsigned int i, T fallback = T{}) const {
+        std::string_view value = text(i);
+        T                result{};
+        auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (value.empty() || ec != std::errc{}) {
+            return fallback;
+        }
+        return result;
+    }
+
+    // string_view 也可以这样取值：赋给 std::string 时才复制
+    std::string_view operator[](unsigned int i) const { return text(i); }
+
+private:
+    MYSQL_ROW            mRow     = nullptr;
+    const unsigned long* mLengths = nullptr;
+    unsigned int         mFields  = 0;
+};
+
+// 逐行遍历 MYSQL_RES：
+//   RowCursor cursor(result);
+//   for (RowView row; cursor.next(row);) { ... }
+class RowCursor {
+public:
+    explicit RowCursor(MYSQL_RES* result) : mResult(result), mFields(mysql_num_fields(result)) {}
+
+    size_t rowCount() const { return static_cast<size_t>(mysql_num_rows(mResult)); }
+
+    // 没有更多行时返回 false
+    bool next(RowView& row) {
+        MYSQL_ROW values = mysql_fetch_row(mResult);
+        if (!values) {
+            return false;
+        }
+        row = RowView(values, mysql_fetch_lengths(mResult), mFields);
+        return true;
+    }
+
+private:
+    MYSQL_RES*   mResult;
+    unsigned int mFields;
+};
+
+// 持有 MYSQL_RES 的查询结果，可以跨线程移动。
+// 行数据保留在 libmysqlclient 一次分配的结果缓冲区中，rows 中的视图直接指向它
+class OwnedResult {
+public:
+    OwnedResult() = default;
+    explicit OwnedResult(MYSQL_RES* result) : mResult(result) {
+        if (!mResult) {
+            return;
+        }
+        unsigned int fields = mysql_num_fields(result);
+        size_t       count  = static_cast<size_t>(mysql_num_rows(result));
+        mLengths.resize(count * fields);
+        mRows.reserve(count);
+
+        // mysql_fetch_lengths 每行覆盖同一数组，需要保存长度
+        MYSQL_ROW row;
+        for (size_t r = 0; (row = mysql_fetch_row(result)); r++) {
+            unsigned long* lengths = mysql_fetch_lengths(result);
+            std::copy(lengths, lengths + fields, mLengths.begin() + static_cast<ptrdiff_t>(r * fields));
+            mRows.emplace_back(row, mLengths.data() + r * fields, fields);
+        }
+    }
+
+    size_t         size() const { return mRows.size(); }
+    bool           empty() const { return mRows.empty(); }
+    const RowView& front() const { return mRows.front(); }
+    auto           begin() const { return mRows.begin(); }
+    auto           end() const { return mRows.end(); }
+
+private:
+    struct Deleter {
+        void operator()(MYSQL_RES* result) const { mysql_free_result(result); }
+    };
+
+    std::unique_ptr<MYSQL_RES, Deleter> mResult;
+    std::vector<unsigned long>          mLengths;
+    std::vector<RowView>                mRows;
+};
+
+} // namespace bdsmysql
@@ -0,0 +1,574 @@
+#include "mod/SaveQueue.h"
+#include "ll/api/mod/NativeMod.h"
+#include "mod/AllocStats.h"
+#include "mod/Config.h"
+#include "mod/DatabaseExecutor.h"
+#include "mod/Log.h"
+#include "mod/Metrics.h"
+#include "mod/SnapshotJson.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace bdsmysql {
+
+namespace {
+
+const char* reasonName(SaveReason reason) {
+    switch (reason) {
+    case SaveReason::Leave:
+        return "leave";
+    case SaveReason::Transfer:
+        return "transfer";
+    case SaveReason::Shutdown:
+        return "shutdown";
+    case SaveReason::Journal:
+        return "journal";
+    }
+    return "unknown";
+}
+
+JobPriority priorityOf(SaveReason reason) {
+    switch (reason) {
+    case SaveReason::Transfer:
+        return JobPriority::Transfer;
+    case SaveReason::Journal:
+        return JobPriority::Background;
+    default:
+        return JobPriority::LeaveSave;
+    }
+}
+
+BackpressurePolicy parsePolicy(const std::string& name) {
+    if (name == "dropOldest") return BackpressurePolicy::DropOldest;
+    if (name != "spill") {
+        // 离线和传送保存在主线程入队，等待会卡住 tick；旧配置中的 block 按 spill 处理
+        BDS_LOG_WARN("\033[33m[保存队列] 不支持的策略 {}，使用 spill\033[0m", name);
+    }
+    return BackpressurePolicy::Spill;
+}
+
+} // namespace
+
+SaveQueue& SaveQueue::getInstance() {
+    static SaveQueue instance;
+    return instance;
+}
+
+void SaveQueue::start() {
+    auto& config = Config::getInstance().getDatabaseConfig().saveQueue;
+    {
+        std::lock_guard lock(mMutex);
+        mPolicy         = parsePolicy(config.policy);
+        mCapacity       = static_cast<size_t>(std::max(config.capacity, 1));
+        mWarnDepth      = static_cast<size_t>(std::max(config.warnDepth, 1));
+        mBlockTimeoutMs = std::max(config.blockTimeoutMs, 0);
+        mRunning        = true;
+    }
+
+    mJournalPath = (ll::mod::NativeMod::current()->getModDir() / "journal" / "save_journal.jsonl").string();
+
+    BDS_LOG_INFO("\033[32m[保存队列] 已启动 (容量: {}, 策略: {})\033[0m", mCapacity, config.policy);
+
+    // 队列状态在 /bdsmysql stats 和 metrics.txt 中显示
+    auto& metrics = Metrics::getInstance();
+    metrics.gauge("saveQueue.depth", [this] { return static_cast<double>(getStats().depth); });
+    metrics.gauge("saveQueue.inFlight", [this] { return static_cast<double>(getStats().inFlight); });
+    metrics.gauge("saveQueue.coalesced", [this] { return static_cast<double>(getStats().coalesced); });
+    metrics.gauge("saveQueue.dropped", [this] { return static_cast<double>(getStats().dropped); });
+    metrics.gauge("saveQueue.spilled", [this] { return static_cast<double>(getStats().spilled); });
+    metrics.gauge("saveQueue.conflicts", [this] { return static_cast<double>(getStats().conflicts); });
+    metrics.gauge("saveQueue.journalEntries", [this] { return static_cast<double>(getStats().journalEntries); });
+
+    // 上次运行未能写入数据库的快照
+    if (std::filesystem::exists(mJournalPath)) {
+        replayJournal();
+    }
+}
+
+void SaveQueue::stop() {
+    SaveQueueStats stats;
+    {
+        std::lock_guard lock(mMutex);
+        mRunning = false;
+        stats    = mStats;
+    }
+    mCv.notify_all();
+
+    BDS_LOG_INFO(
+        "\033[33m[保存队列] 已停止 (入队: {}, 合并: {}, 提交: {}, 失败: {}, 移出队列: {}, 写入日志: {}, 版本冲突: {}, 等待: {} 次/{:.2f}ms, 最大深度: {})\033[0m",
+        stats.enqueued,
+        stats.coalesced,
+        stats.committed,
+        stats.failed,
+        stats.dropped,
+        stats.spilled,
+        stats.conflicts,
+        stats.blocked,
+        stats.blockedMs,
+        stats.maxDepth
+    );
+}
+
+bool SaveQueue::enqueue(PlayerSnapshot snapshot, SaveReason reason, Callback callback) {
+    return push(std::move(snapshot), reason, std::move(callback), std::nullopt, 0, nullptr);
+}
+
+void SaveQueue::noteVersion(const std::string& uuid, uint64_t version) {
+    std::lock_guard lock(mMutex);
+    mVersions[uuid] = version;
+}
+
+bool SaveQueue::hasJournaled(const std::string& uuid) const {
+    std::lock_guard lock(mMutex);
+    return mJournaled.contains(uuid);
+}
+
+std::optional<uint64_t> SaveQueue::baseVersionOf(const std::string& uuid) const {
+    auto it = mVersions.find(uuid);
+    if (it == mVersions.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+bool SaveQueue::push(
+    PlayerSnapshot          snapshot,
+    SaveReason              reason,
+    Callback                callback,
+    std::optional<uint64_t> expectedVersion,
+    uint64_t                journalSeq,
+    bool*                   stale
+) {
+    std::string uuid = snapshot.syncData.uuid;
+
+    Entry                   dropped;
+    std::optional<uint64_t> droppedBase;
+    bool                    evicted = false;
+    bool                    spill   = false;
+    uint64_t                seq     = 0;
+    std::optional<uint64_t> baseVersion;
+
+    {
+        std::unique_lock lock(mMutex);
+        // 日志重放：与入队在同一把锁下判断，之后入队的保存不会被更旧的日志快照合并覆盖
+        if (journalSeq != 0) {
+            auto latest = mLatestSeq.find(uuid);
+            if (latest != mLatestSeq.end() && latest->second > journalSeq) {
+                if (stale) {
+                    *stale = true;
+                }
+                return false;
+            }
+        }
+
+        seq              = mNextSeq++;
+        mLatestSeq[uuid] = seq;
+        mStats.enqueued++;
+
+        auto coalesce = [&]() {
+            auto it = mPending.find(uuid);
+            if (it == mPending.end()) {
+                return false;
+            }
+            // 尚未开始写入：用更新的快照替换，等待者一起在这次提交完成时得到通知
+            it->second.snapshot        = std::move(snapshot);
+            it->second.seq             = seq;
+            it->second.reason          = reason;
+            it->second.expectedVersion = expectedVersion;
+            if (callback) {
+                it->second.callbacks.push_back(std::move(callback));
+            }
+            mStats.coalesced++;
+            return true;
+        };
+
+        if (coalesce()) {
+            return true;
+        }
+
+        if (mPending.size() >= mCapacity) {
+            // 关服保存不能丢弃，只有它等待；日志重放不能阻塞工作线程
+            auto policy = mPolicy;
+            if (reason == SaveReason::Shutdown) policy = BackpressurePolicy::Block;
+            if (reason == SaveReason::Journal) policy = BackpressurePolicy::Spill;
+
+            if (policy == BackpressurePolicy::Block) {
+                auto waitStart = Clock::now();
+                mStats.blocked++;
+                mCv.wait_for(lock, std::chrono::milliseconds(mBlockTimeoutMs), [&] {
+                    return !mRunning || mPending.size() < mCapacity;
+                });
+                mStats.blockedMs += std::chrono::duration<double, std::milli>(Clock::now() - waitStart).count();
+
+                // 等待期间同一玩家可能已有新的保存入队
+                if (coalesce()) {
+                    return true;
+                }
+                spill = mPending.size() >= mCapacity;
+            } else if (policy == BackpressurePolicy::DropOldest) {
+                evicted = evictOldest(dropped);
+                if (evicted) {
+                    mStats.dropped++;
+                    droppedBase = dropped.expectedVersion ? dropped.expectedVersion
+                                                          : baseVersionOf(dropped.snapshot.syncData.uuid);
+                } else {
+                    spill = true;
+                }
+            } else {
+                spill = true;
+            }
+        }
+
+        if (spill) {
+            mStats.spilled++;
+            baseVersion = expectedVersion ? expectedVersion : baseVersionOf(uuid);
+        } else {
+            Entry entry;
+            entry.id              = mNextId++;
+            entry.seq             = seq;
+            entry.reason          = reason;
+            entry.snapshot        = std::move(snapshot);
+            entry.expectedVersion = expectedVersion;
+            if (callback) {
+                entry.callbacks.push_back(std::move(callback));
+            }
+            mOrder.emplace_back(uuid, entry.id);
+            mPending.emplace(uuid, std::move(entry));
+            noteDepth();
+        }
+    }
+
+    if (evicted) {
+        // 让出队列位置，但快照不能丢：与 spill 一样写入本地日志，之后重放
+        BDS_LOG_WARN(
+            "\033[33m[保存队列] 队列已满，玩家 {} 最早排队的保存已移入本地日志\033[0m",
+            dropped.snapshot.syncData.uuid
+        );
+        appendJournal(dropped.seq, dropped.reason, dropped.snapshot, droppedBase);
+        notifyFailure(dropped.callbacks, dropped.snapshot);
+    }
+
+    if (spill) {
+        BDS_LOG_WARN("\033[33m[保存队列] 队列已满，玩家 {} 的快照已写入本地日志 ({})\033[0m", uuid, reasonName(reason));
+        appendJournal(seq, reason, snapshot, baseVersion);
+        if (callback) {
+            notifyFailure({callback}, snapshot);
+        }
+        return false;
+    }
+
+    // 投递到该玩家的 strand：与同一玩家的其它数据库操作保持顺序
+    DatabaseExecutor::getInstance().post(uuid, [uuid] { SaveQueue::getInstance().drain(uuid); }, priorityOf(reason));
+    return true;
+}
+
+void SaveQueue::drain(const std::string& uuid) {
+    AllocScope allocScope(AllocStage::SaveCommit);
+
+    Entry                   entry;
+    std::optional<uint64_t> baseVersion;
+    {
+        std::lock_guard lock(mMutex);
+        auto            it = mPending.find(uuid);
+        if (it == mPending.end()) {
+            return;  // 已被丢弃
+        }
+        entry = std::move(it->second);
+        mPending.erase(it);
+        mStats.inFlight++;
+        // 同一玩家的写入在 strand 上依次执行，此时已包含上一次提交的版本号
+        baseVersion = entry.expectedVersion ? entry.expectedVersion : baseVersionOf(uuid);
+    }
+    mCv.notify_all();
+
+    // 属性、背包和装备在同一事务中保存
+    auto startTime = Clock::now();
+    bool conflict  = false;
+    bool success   = Database::getInstance().savePlayerSnapshot(entry.snapshot, entry.expectedVersion, &conflict);
+    auto endTime   = Clock::now();
+
+    bool superseded = false;
+    {
+        std::lock_guard lock(mMutex);
+        mStats.inFlight--;
+        if (success) {
+            mStats.committed++;
+            mVersions[uuid] = entry.snapshot.version;
+        } else if (conflict) {
+            mStats.conflicts++;
+        } else {
+            mStats.failed++;
+            // 失败期间已有更新的快照排队，无需保留这一份
+            superseded = mPending.contains(uuid);
+        }
+    }
+
+    if (success) {
+        BDS_LOG_INFO(
+            "\033[32m[数据同步] 已保存玩家 {} 的属性、{} 个背包槽位和 {} 个装备槽位 ({}, {:.2f}ms)\033[0m",
+            uuid,
+            entry.snapshot.items.countSlots(0, ItemList::kLastBackpackSlot),
+            entry.snapshot.items.countSlots(ItemList::kFirstEquipmentSlot, ItemList::kLastEquipmentSlot),
+            reasonName(entry.reason),
+            std::chrono::duration<double, std::milli>(endTime - startTime).count()
+        );
+    } else if (conflict) {
+        BDS_LOG_WARN("\033[33m[保存队列] 玩家 {} 在其它服务器已有更新的保存，放弃本地日志中的快照\033[0m", uuid);
+    } else {
+        BDS_LOG_ERROR("\033[31m[数据同步] 保存玩家 {} 的数据失败 ({})\033[0m", uuid, reasonName(entry.reason));
+        if (!superseded) {
+            appendJournal(entry.seq, entry.reason, entry.snapshot, baseVersion);
+        }
+    }
+
+    SaveResult result{success, entry.snapshot, startTime, endTime};
+    for (auto& callback : entry.callbacks) {
+        callback(result);
+    }
+
+    if (success) {
+        scheduleJournalReplay();
+    }
+}
+
+bool SaveQueue::evictOldest(Entry& evicted) {
+    while (!mOrder.empty()) {
+        auto [uuid, id] = std::move(mOrder.front());
+        mOrder.pop_front();
+
+        auto it = mPending.find(uuid);
+        if (it == mPending.end() || it->second.id != id) {
+            continue;  // 已开始写入
+        }
+        evicted = std::move(it->second);
+        mPending.erase(it);
+        return true;
+    }
+    return false;
+}
+
+void SaveQueue::noteDepth() {
+    size_t depth    = mPending.size();
+    mStats.depth    = depth;
+    mStats.maxDepth = std::max(mStats.maxDepth, depth);
+
+    // mOrder 中的过期项在出队时才会清理，避免长期只增不减
+    if (mOrder.size() > mCapacity * 2) {
+        std::erase_if(mOrder, [this](const auto& item) {
+            auto it = mPending.find(item.first);
+            return it == mPending.end() || it->second.id != item.second;
+        });
+    }
+
+    if (depth >= mWarnDepth && !mDepthWarned) {
+        mDepthWarned = true;
+        BDS_LOG_WARN(
+            "\033[33m[保存队列] 排队深度达到 {} (容量: {})，数据库写入跟不上\033[0m",
+            depth,
+            mCapacity
+        );
+    } else if (depth < mWarnDepth / 2) {
+        mDepthWarned = false;
+    }
+}
+
+void SaveQueue::notifyFailure(const std::vector<Callback>& callbacks, const PlayerSnapshot& snapshot) {
+    auto       now = Clock::now();
+    SaveResult result{false, snapshot, now, now};
+    for (auto& callback : callbacks) {
+        if (callback) {
+            callback(result);
+        }
+    }
+}
+
+SaveQueueStats SaveQueue::getStats() const {
+    std::lock_guard lock(mMutex);
+    SaveQueueStats  stats = mStats;
+    stats.depth           = mPending.size();
+    return stats;
+}
+
+void SaveQueue::appendJournal(
+    uint64_t                seq,
+    SaveReason              reason,
+    const PlayerSnapshot&   snapshot,
+    std::optional<uint64_t> baseVersion
+) {
+    try {
+        nlohmann::json line;
+        line["seq"]    = seq;
+        line["reason"] = reasonName(reason);
+        if (baseVersion) {
+            line["baseVersion"] = *baseVersion;
+        }
+        line["snapshot"] = snapshot;
+
+        std::lock_guard lock(mJournalMutex);
+        std::filesystem::create_directories(std::filesystem::path(mJournalPath).parent_path());
+        std::ofstream file(mJournalPath, std::ios::app);
+        file << line.dump() << '\n';
+        file.flush();
+        if (!file) {
+            throw std::runtime_error("写入失败");
+        }
+    } catch (const std::exception& e) {
+        BDS_LOG_ERROR("\033[31m[保存队列] 写入本地日志失败，玩家 {} 的数据已丢失: {}\033[0m", snapshot.syncData.uuid, e.what());
+        return;
+    }
+
+    std::lock_guard lock(mMutex);
+    mStats.journalEntries++;
+    mJournaled.insert(snapshot.syncData.uuid);
+}
+
+std::vector<SaveQueue::JournalEntry> SaveQueue::takeJournal(const std::string* uuid) {
+    std::vector<JournalEntry> entries;
+    size_t                    taken   = 0;
+    uint64_t                  lastSeq = 0;
+    {
+        std::lock_guard lock(mJournalMutex);
+        std::ifstream   file(mJournalPath);
+        if (!file) {
+            return entries;
+        }
+
+        std::vector<std::string> kept;
+        for (std::string line; std::getline(file, line);) {
+            if (line.empty()) {
+                continue;
+            }
+            try {
+                auto         json = nlohmann::json::parse(line);
+                JournalEntry entry;
+                entry.seq      = json.at("seq").get<uint64_t>();
+                entry.reason   = json.value("reason", std::string("leave"));
+                entry.snapshot = json.at("snapshot").get<PlayerSnapshot>();
+                if (json.contains("baseVersion")) {
+                    entry.baseVersion = json.at("baseVersion").get<uint64_t>();
+                }
+                lastSeq = std::max(lastSeq, entry.seq);
+                if (uuid && entry.snapshot.syncData.uuid != *uuid) {
+                    kept.push_back(std::move(line));
+                    continue;
+                }
+                entries.push_back(std::move(entry));
+            } catch (const std::exception& e) {
+                BDS_LOG_ERROR("\033[31m[保存队列] 解析本地日志条目失败: {}\033[0m", e.what());
+            }
+            taken++;
+        }
+        file.close();
+
+        // 取出的条目从文件中移除，重放时再次写入日志的条目会追加到新文件
+        std::error_code ec;
+        std::filesystem::remove(mJournalPath, ec);
+        if (!kept.empty()) {
+            std::ofstream out(mJournalPath, std::ios::trunc);
+            for (const auto& line : kept) {
+                out << line << '\n';
+            }
+        }
+    }
+
+    std::lock_guard lock(mMutex);
+    // 上次运行留下的条目：本次运行的序号从其后开始，入队先后的比较才有意义
+    mNextSeq = std::max(mNextSeq, lastSeq + 1);
+    mStats.journalEntries -= std::min<size_t>(mStats.journalEntries, taken);
+    if (uuid) {
+        mJournaled.erase(*uuid);
+    } else {
+        mJournaled.clear();
+    }
+    return entries;
+}
+
+bool SaveQueue::isStale(const JournalEntry& entry) const {
+    // 本次运行中同一玩家已有更新的快照入队，这一份已过期
+    auto it = mLatestSeq.find(entry.snapshot.syncData.uuid);
+    return it != mLatestSeq.end() && it->second > entry.seq;
+}
+
+void SaveQueue::replayJournal() {
+    auto entries = takeJournal();
+
+    size_t replayed = 0;
+    size_t stale    = 0;
+    for (auto& entry : entries) {
+        std::string uuid     = entry.snapshot.syncData.uuid;
+        bool        outdated = false;
+        push(std::move(entry.snapshot), SaveReason::Journal, {}, entry.baseVersion, entry.seq, &outdated);
+        if (outdated) {
+            stale++;
+            continue;
+        }
+        BDS_LOG_INFO("\033[33m[保存队列] 重放本地日志中玩家 {} 的快照 ({})\033[0m", uuid, entry.reason);
+        replayed++;
+    }
+
+    if (replayed > 0 || stale > 0) {
+        BDS_LOG_INFO("\033[32m[保存队列] 本地日志重放完成 (重放: {}, 过期: {})\033[0m", replayed, stale);
+    }
+}
+
+void SaveQueue::flushJournal(const std::string& uuid) {
+    if (!hasJournaled(uuid)) {
+        return;
+    }
+
+    // 同一玩家只需写入序号最大的一份
+    auto entries = takeJournal(&uuid);
+    auto latest  = std::max_element(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.seq < b.seq;
+    });
+    if (latest == entries.end()) {
+        return;
+    }
+    {
+        std::lock_guard lock(mMutex);
+        if (isStale(*latest)) {
+            return;
+        }
+    }
+
+    auto& snapshot = latest->snapshot;
+    bool  conflict = false;
+    if (Database::getInstance().savePlayerSnapshot(snapshot, latest->baseVersion, &conflict)) {
+        {
+            std::lock_guard lock(mMutex);
+            mStats.committed++;
+            mVersions[uuid] = snapshot.version;
+        }
+        BDS_LOG_INFO("\033[32m[保存队列] 玩家 {} 加入前已写入本地日志中的快照 ({})\033[0m", uuid, latest->reason);
+    } else if (conflict) {
+        {
+            std::lock_guard lock(mMutex);
+            mStats.conflicts++;
+        }
+        BDS_LOG_WARN("\033[33m[保存队列] 玩家 {} 在其它服务器已有更新的保存，放弃本地日志中的快照\033[0m", uuid);
+    } else {
+        appendJournal(latest->seq, SaveReason::Journal, snapshot, latest->baseVersion);
+    }
+}
+
+void SaveQueue::scheduleJournalReplay() {
+    {
+        std::lock_guard lock(mMutex);
+        if (mStats.journalEntries == 0 || !mRunning) {
+            return;
+        }
+    }
+    if (mJournalReplayScheduled.exchange(true)) {
+        return;
+    }
+
+    // 数据库已恢复写入，重放之前写入日志的快照
+    DatabaseExecutor::getInstance().post([] {
+        auto& queue = SaveQueue::getInstance();
+        queue.replayJournal();
+        queue.mJournalReplayScheduled = false;
+    }, JobPriority::Background);
+}
+
+} // namespace bdsmysql
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "mod/Database.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace bdsmysql {
+
+enum class SaveReason { Leave, Transfer, Shutdown, Journal };
+
+// 队列已满时的处理策略
+enum class BackpressurePolicy {
+    Block,       // 等待队列腾出空间，超时后写入本地日志（只用于关服保存，不能阻塞 tick）
+    DropOldest,  // 把最早排队的保存移入本地日志，新的保存入队
+    Spill        // 直接写入本地日志，稍后重放
+};
+
+struct SaveResult {
+    using Clock = std::chrono::steady_clock;
+
+    bool                  success = false;
+    const PlayerSnapshot& snapshot;  // 实际提交的快照（可能是合并后更新的那一份）
+    Clock::time_point     startTime;
+    Clock::time_point     endTime;
+};
+
+struct SaveQueueStats {
+    size_t   depth          = 0;  // 排队中的玩家数
+    size_t   inFlight       = 0;  // 正在写入数据库的保存
+    size_t   maxDepth       = 0;
+    size_t   journalEntries = 0;  // 本地日志中待重放的条目
+    uint64_t enqueued       = 0;
+    uint64_t coalesced      = 0;  // 被同一玩家更新的快照覆盖的次数
+    uint64_t committed      = 0;
+    uint64_t failed         = 0;
+    uint64_t dropped        = 0;  // 队列已满时移入本地日志的最早排队的保存
+    uint64_t spilled        = 0;
+    uint64_t conflicts      = 0;  // 重放本地日志时因其它服务器已写入而放弃的快照
+    uint64_t blocked        = 0;  // 因队列已满而等待的次数
+    double   blockedMs      = 0;  // 累计等待时间
+};
+
+// 玩家快照保存队列：
+// 同一玩家尚未开始写入的多次保存合并为一项（只保存最新的快照），
+// 队列有上限，已满时按配置的策略施加背压；写入失败的快照记入本地日志，下次写入成功后重放。
+// 日志记录快照所基于的数据库版本号，重放时只在版本号未变化时写入，不会覆盖其它服务器之后的保存
+class SaveQueue {
+public:
+    using Clock    = std::chrono::steady_clock;
+    using Callback = std::function<void(const SaveResult&)>;  // 在后台线程调用（丢弃时在调用方线程）
+
+    static SaveQueue& getInstance();
+
+    void start();  // 读取配置并重放上次遗留的本地日志，需在 DatabaseExecutor 启动后调用
+    void stop();
+
+    /// @return False if the snapshot was written to the journal instead of being queued.
+    bool enqueue(PlayerSnapshot snapshot, SaveReason reason, Callback callback = {});
+
+    // 记录玩家当前状态所基于的数据库版本号（加入读取时），写入本地日志时作为重放的条件
+    void noteVersion(const std::string& uuid, uint64_t version);
+
+    bool hasJournaled(const std::string& uuid) const;
+    // 在该玩家的 strand 上同步写入本地日志中该玩家的快照，加入读取前调用
+    void flushJournal(const std::string& uuid);
+
+    SaveQueueStats getStats() const;
+
+private:
+    struct Entry {
+        uint64_t              id  = 0;  // 队列项编号，用于识别 mOrder 中的过期项
+        uint64_t              seq = 0;  // 最近一次合并进来的快照序号
+        SaveReason              reason;
+        PlayerSnapshot          snapshot;
+        std::vector<Callback>   callbacks;
+        std::optional<uint64_t> expectedVersion;  // 日志重放：只在数据库版本号仍为该值时写入
+    };
+
+    struct JournalEntry {
+        uint64_t                seq = 0;
+        std::string             reason;
+        std::optional<uint64_t> baseVersion;  // 旧版本的日志没有记录
+        PlayerSnapshot          snapshot;
+    };
+
+    SaveQueue()  = default;
+    ~SaveQueue() = default;
+
+    SaveQueue(const SaveQueue&)            = delete;
+    SaveQueue& operator=(const SaveQueue&) = delete;
+
+    // journalSeq 非 0 时是日志重放：本次运行中该玩家已有更新的快照入队则不入队，并设置 *stale
+    bool push(
+        PlayerSnapshot          snapshot,
+        SaveReason              reason,
+        Callback                callback,
+        std::optional<uint64_t> expectedVersion,
+        uint64_t                journalSeq,
+        bool*                   stale
+    );
+    void drain(const std::string& uuid);
+    bool evictOldest(Entry& evicted);
+    void noteDepth();
+
+    void appendJournal(
+        uint64_t                seq,
+        SaveReason              reason,
+        const PlayerSnapshot&   snapshot,
+        std::optional<uint64_t> baseVersion
+    );
+    // 取出本地日志中的条目（传入 uuid 时只取出该玩家的条目，其余写回文件）
+    std::vector<JournalEntry> takeJournal(const std::string* uuid = nullptr);
+    std::optional<uint64_t>   baseVersionOf(const std::string& uuid) const;  // 需持有 mMutex
+    bool                      isStale(const JournalEntry& entry) const;      // 需持有 mMutex
+    void                      replayJournal();
+    void scheduleJournalReplay();
+
+    static void notifyFailure(const std::vector<Callback>& callbacks, const PlayerSnapshot& snapshot);
+
+    BackpressurePolicy mPolicy         = BackpressurePolicy::Spill;
+    size_t             mCapacity       = 256;
+    size_t             mWarnDepth      = 64;
+    int                mBlockTimeoutMs = 200;
+    bool               mRunning        = false;
+    bool               mDepthWarned    = false;
+
+    std::unordered_map<std::string, Entry>         mPending;
+    std::deque<std::pair<std::string, uint64_t>>   mOrder;      // 按入队顺序排列的 (uuid, 队列项编号)
+    std::unordered_map<std::string, uint64_t>      mLatestSeq;  // 每个玩家最近入队的快照序号
+    std::unordered_map<std::string, uint64_t>      mVersions;   // 每个玩家当前状态所基于的数据库版本号
+    std::unordered_set<std::string>                mJournaled;  // 本地日志中有条目的玩家
+    uint64_t                                       mNextId  = 1;
+    uint64_t                                       mNextSeq = 1;
+    SaveQueueStats                                 mStats;
+    mutable std::mutex                             mMutex;
+    std::condition_variable                        mCv;
+
+    std::string       mJournalPath;
+    std::mutex        mJournalMutex;
+    std::atomic<bool> mJournalReplayScheduled{false};
+};
+
+} // namespace bdsmysql
@@ -2,6 +2,7 @@
 #include "ll/api/mod/NativeMod.h"
 #include "ll/api/io/FileUtils.h"
 #include "ll/api/io/Logger.h"
+#include "mod/Log.h"
 #include <fstream>
 #include <filesystem>
 
@@ -20,13 +21,13 @@ bool ServerConfigManager::load() {
     
     if (std::filesystem::exists(modDir)) {
         mConfigPath = modDir.string();
-        mod->getLogger().info("Loading server config from: {}", mConfigPath);
+        BDS_LOG_INFO("Loading server config from: {}", mConfigPath);
     } else {
         // 不存在，创建默认配置
         mConfigPath = modDir.string();
         createDefaultConfig();
         save();
-        mod->getLogger().info("Created default server config file at: {}", mConfigPath);
+        BDS_LOG_INFO("Created default server config file at: {}", mConfigPath);
         return true;
     }
 
@@ -38,13 +39,13 @@ bool ServerConfigManager::load() {
         // 加载服务器列表
         if (j.contains("servers")) {
             mServers = j["servers"].get<std::vector<ServerConfig>>();
-            mod->getLogger().info("Loaded {} servers from config", mServers.size());
+            BDS_LOG_INFO("Loaded {} servers from config", mServers.size());
         }
         
-        mod->getLogger().info("Server config loaded successfully");
+        BDS_LOG_INFO("Server config loaded successfully");
         return true;
     } catch (const std::exception& e) {
-        mod->getLogger().error("Failed to load server config: {}", e.what());
+        BDS_LOG_ERROR("Failed to load server config: {}", e.what());
         return false;
     }
 }
@@ -61,8 +62,7 @@ bool ServerConfigManager::save() {
         file << j.dump(4);
         return true;
     } catch (const std::exception& e) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("Failed to save server config: {}", e.what());
+        BDS_LOG_ERROR("Failed to save server config: {}", e.what());
         return false;
     }
 }
@@ -85,8 +85,7 @@ void ServerConfigManager::createDefaultConfig() {
         std::ofstream  file(mConfigPath);
         file << j.dump(4);
     } catch (const std::exception& e) {
-        auto mod = ll::mod::NativeMod::current();
-        mod->getLogger().error("Failed to create default server config file: {}", e.what());
+        BDS_LOG_ERROR("Failed to create default server config file: {}", e.what());
     }
 }
 
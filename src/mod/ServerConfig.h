@@ -9,9 +9,10 @@ namespace bdsmysql {
 struct ServerConfig {
     std::string name;
     std::string address;
-    int         port;
+    int         port     = 19132;
+    int         peerPort = 0;  // 目标服务器的快照推送端口，0 表示不推送
 
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(ServerConfig, name, address, port)
+    NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(ServerConfig, name, address, port, peerPort)
 };
 
 class ServerConfigManager {
@@ -0,0 +1,422 @@
+#include "mod/SlowQueryLog.h"
+#include "ll/api/io/Logger.h"
+#include "ll/api/mod/NativeMod.h"
+#include "mod/Config.h"
+#include "mod/Database.h"
+#include "mod/Log.h"
+#include "mod/QueryRecorder.h"
+#include "mod/RowView.h"
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace bdsmysql {
+
+namespace {
+
+bool isIdentifierChar(char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$'; }
+
+// 只有这几类语句可以 EXPLAIN 且有访问路径可看（INSERT 的 upsert 没有）
+bool isExplainable(std::string_view shape) {
+    auto startsWith = [&](std::string_view keyword) {
+        return shape.size() >= keyword.size()
+            && std::equal(keyword.begin(), keyword.end(), shape.begin(), [](char a, char b) {
+                   return a == std::toupper(static_cast<unsigned char>(b));
+               });
+    };
+    return startsWith("SELECT") || startsWith("UPDATE") || startsWith("DELETE");
+}
+
+uint32_t bindSize(const MYSQL_BIND& bind) {
+    if (bind.length) {
+        return static_cast<uint32_t>(*bind.length);
+    }
+    switch (bind.buffer_type) {
+    case MYSQL_TYPE_TINY:
+        return 1;
+    case MYSQL_TYPE_SHORT:
+        return 2;
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_FLOAT:
+        return 4;
+    case MYSQL_TYPE_LONGLONG:
+    case MYSQL_TYPE_DOUBLE:
+        return 8;
+    default:
+        return static_cast<uint32_t>(bind.buffer_length);
+    }
+}
+
+std::string formatBindSizes(const std::vector<uint32_t>& sizes) {
+    std::string text = "[";
+    for (size_t i = 0; i < sizes.size(); i++) {
+        text += std::format("{}{}", i ? "," : "", sizes[i]);
+    }
+    return text + "]";
+}
+
+std::string formatTime(std::chrono::system_clock::time_point time) {
+    auto               seconds = std::chrono::system_clock::to_time_t(time);
+    auto               local   = *std::localtime(&seconds);
+    std::ostringstream text;
+    text << std::put_time(&local, "%Y-%m-%d %H:%M:%S");
+    return text.str();
+}
+
+} // namespace
+
+SlowQueryLog& SlowQueryLog::getInstance() {
+    static SlowQueryLog instance;
+    return instance;
+}
+
+std::string
+SlowQueryLog::shapeOf(std::string_view sql, std::vector<uint32_t>* literalSizes, std::vector<SqlLiteral>* literals) {
+    // 录制需要能还原出完整语句，不截断
+    size_t maxLength = literals ? sql.size() : 1024;
+
+    std::string shape;
+    shape.reserve(std::min(sql.size(), maxLength));
+    for (size_t i = 0; i < sql.size() && shape.size() < maxLength;) {
+        char c = sql[i];
+
+        if (c == '\'' || c == '"') {
+            // 字符串字面量（支持反斜杠转义和连续两个引号）
+            size_t start = ++i;
+            while (i < sql.size()) {
+                if (sql[i] == '\\') {
+                    i += 2;
+                } else if (sql[i] == c && i + 1 < sql.size() && sql[i + 1] == c) {
+                    i += 2;
+                } else if (sql[i] == c) {
+                    break;
+                } else {
+                    i++;
+                }
+            }
+            if (literalSizes) {
+                literalSizes->push_back(static_cast<uint32_t>(std::min(i, sql.size()) - start));
+            }
+            if (literals) {
+                literals->push_back({true, sql.substr(start, std::min(i, sql.size()) - start)});
+            }
+            shape += '?';
+            i++;
+        } else if (c == '`') {
+            // 标识符原样保留
+            size_t end = sql.find('`', i + 1);
+            end        = end == std::string_view::npos ? sql.size() : end + 1;
+            shape.append(sql.substr(i, end - i));
+            i = end;
+        } else if (std::isdigit(static_cast<unsigned char>(c)) && (shape.empty() || !isIdentifierChar(shape.back()))) {
+            size_t start = i;
+            while (i < sql.size() && (isIdentifierChar(sql[i]) || sql[i] == '.')) {
+                i++;
+            }
+            if (literals) {
+                literals->push_back({false, sql.substr(start, i - start)});
+            }
+            shape += '?';
+        } else if (std::isspace(static_cast<unsigned char>(c))) {
+            while (i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i]))) {
+                i++;
+            }
+            if (!shape.empty()) {
+                shape += ' ';
+            }
+        } else {
+            shape += c;
+            i++;
+        }
+    }
+    while (!shape.empty() && shape.back() == ' ') {
+        shape.pop_back();
+    }
+    return shape;
+}
+
+void SlowQueryLog::start() {
+    const auto& config = Config::getInstance().getDatabaseConfig().slowQuery;
+    if (config.thresholdMs <= 0) {
+        return;
+    }
+
+    std::lock_guard lock(mMutex);
+    if (mRunning) {
+        return;
+    }
+    auto mod      = ll::mod::NativeMod::current();
+    mPath         = (mod->getModDir() / config.logFile).string();
+    mMaxFileBytes = static_cast<uintmax_t>(std::max(config.maxFileKB, 64)) * 1024;
+    mMaxFiles     = std::max(config.maxFiles, 1);
+    mExplain      = config.explain;
+    mRunning      = true;
+    mThread       = std::thread([this] { run(); });
+    mThresholdUs.store(static_cast<int64_t>(config.thresholdMs) * 1000, std::memory_order_relaxed);
+
+    BDS_LOG_INFO("\033[32m[慢查询] 超过 {}ms 的语句写入: {}\033[0m", config.thresholdMs, mPath);
+}
+
+void SlowQueryLog::stop() {
+    {
+        std::lock_guard lock(mMutex);
+        if (!mRunning) {
+            return;
+        }
+        mRunning = false;
+    }
+    mThresholdUs.store(INT64_MAX, std::memory_order_relaxed);
+    mCv.notify_all();
+
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+}
+
+void SlowQueryLog::record(std::string_view sql, std::vector<uint32_t> bindSizes, uint64_t rows, Clock::duration elapsed) {
+    // 文本语句没有绑定参数，以字符串字面量的长度代替
+    Entry entry;
+    entry.shape     = shapeOf(sql, bindSizes.empty() ? &bindSizes : nullptr);
+    entry.time      = std::chrono::system_clock::now();
+    entry.bindSizes = std::move(bindSizes);
+    entry.rows      = rows;
+    entry.us        = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+    // 每种形态第一次出现时同时输出到控制台，之后只写入日志文件
+    std::string firstSeen;
+    {
+        std::lock_guard lock(mMutex);
+        if (!mRunning) {
+            return;
+        }
+
+        auto it = mShapes.find(entry.shape);
+        if (it == mShapes.end() && mShapes.size() < kMaxShapes) {
+            it               = mShapes.try_emplace(entry.shape).first;
+            it->second.shape = entry.shape;
+            firstSeen        = entry.shape;
+        }
+        if (it != mShapes.end()) {
+            auto& shape = it->second;
+            shape.count++;
+            shape.totalUs += entry.us;
+            shape.maxUs    = std::max(shape.maxUs, entry.us);
+            shape.maxRows  = std::max(shape.maxRows, rows);
+        }
+
+        // 每种新形态只执行一次 EXPLAIN，使用本次的原始语句（字面量原样保留）
+        if (!firstSeen.empty() && mExplain && isExplainable(entry.shape)) {
+            entry.explainSql = sql;
+        }
+
+        if (mPending.size() >= kMaxPending) {
+            mDropped++;
+            return;
+        }
+        mPending.push_back(std::move(entry));
+    }
+    mCv.notify_one();
+
+    if (!firstSeen.empty()) {
+        BDS_LOG_WARN(
+            "\033[33m[慢查询] {:.2f}ms (行数 {}): {}\033[0m",
+            std::chrono::duration<double, std::milli>(elapsed).count(),
+            rows,
+            firstSeen
+        );
+    }
+}
+
+std::vector<SlowQueryShape> SlowQueryLog::summary() const {
+    std::vector<SlowQueryShape> shapes;
+    {
+        std::lock_guard lock(mMutex);
+        shapes.reserve(mShapes.size());
+        for (const auto& [key, shape] : mShapes) {
+            shapes.push_back(shape);
+        }
+    }
+    std::sort(shapes.begin(), shapes.end(), [](const SlowQueryShape& a, const SlowQueryShape& b) {
+        return a.totalUs > b.totalUs;
+    });
+    return shapes;
+}
+
+void SlowQueryLog::run() {
+    std::unique_lock lock(mMutex);
+    while (true) {
+        mCv.wait(lock, [this] { return !mRunning || !mPending.empty(); });
+        if (mPending.empty()) {
+            break;  // 正在停止且已全部写入
+        }
+
+        auto     batch   = std::move(mPending);
+        uint64_t dropped = std::exchange(mDropped, 0);
+        mPending.clear();
+        lock.unlock();
+
+        for (const auto& entry : batch) {
+            write(std::format(
+                "{} | {:.2f}ms | rows={} | binds={} | {}",
+                formatTime(entry.time),
+                static_cast<double>(entry.us) / 1000.0,
+                entry.rows,
+                formatBindSizes(entry.bindSizes),
+                entry.shape
+            ));
+            if (!entry.explainSql.empty()) {
+                explain(entry);
+            }
+        }
+        if (dropped > 0) {
+            write(std::format("{} | 写入不及，丢弃了 {} 条慢查询记录", formatTime(std::chrono::system_clock::now()), dropped));
+        }
+
+        lock.lock();
+    }
+}
+
+void SlowQueryLog::write(const std::string& line) {
+    try {
+        std::filesystem::path path(mPath);
+        std::filesystem::create_directories(path.parent_path());
+
+        std::error_code ec;
+        auto            size = std::filesystem::file_size(path, ec);
+        if (!ec && size + line.size() + 1 > mMaxFileBytes) {
+            rotate();
+        }
+
+        std::ofstream file(path, std::ios::app);
+        file << line << '\n';
+    } catch (const std::exception& e) {
+        BDS_LOG_WARN("\033[33m[慢查询] 写入慢查询日志失败: {}\033[0m", e.what());
+    }
+}
+
+// slow-query.log -> slow-query.log.1 -> ... -> slow-query.log.<maxFiles-1>，最旧的一份删除
+void SlowQueryLog::rotate() {
+    std::error_code ec;
+    auto            numbered = [&](int index) { return std::filesystem::path(mPath + "." + std::to_string(index)); };
+
+    if (mMaxFiles <= 1) {
+        std::filesystem::remove(mPath, ec);
+        return;
+    }
+    std::filesystem::remove(numbered(mMaxFiles - 1), ec);
+    for (int index = mMaxFiles - 2; index >= 1; index--) {
+        std::filesystem::rename(numbered(index), numbered(index + 1), ec);
+    }
+    std::filesystem::rename(mPath, numbered(1), ec);
+}
+
+void SlowQueryLog::explain(const Entry& entry) {
+    auto conn = Database::getInstance().acquireConnection();
+    if (!conn) {
+        return;
+    }
+
+    std::string query = "EXPLAIN " + entry.explainSql;
+    if (mysql_real_query(conn, query.c_str(), static_cast<unsigned long>(query.size()))) {
+        write(std::format("{} | EXPLAIN 失败: {} | {}", formatTime(entry.time), mysql_error(conn), entry.shape));
+        return;
+    }
+    MYSQL_RES* result = mysql_store_result(conn);
+    if (!result) {
+        return;
+    }
+
+    // 按列名取需要的列（不同 MySQL 版本的 EXPLAIN 列数不同）
+    unsigned int              fieldCount = mysql_num_fields(result);
+    MYSQL_FIELD*              fields     = mysql_fetch_fields(result);
+    std::vector<unsigned int> columns;
+    for (const char* name : {"table", "type", "key", "rows", "Extra"}) {
+        unsigned int index = fieldCount;
+        for (unsigned int i = 0; i < fieldCount; i++) {
+            if (std::string_view(fields[i].name) == name) {
+                index = i;
+            }
+        }
+        columns.push_back(index);
+    }
+
+    std::string summary;
+    bool        fullScan = false;
+    RowCursor   cursor(result);
+    RowView     row;
+    while (cursor.next(row)) {
+        auto column = [&](size_t i) { return row.isNull(columns[i]) ? std::string_view("NULL") : row.text(columns[i]); };
+        summary += std::format(
+            "{}table={} type={} key={} rows={}{}{}",
+            summary.empty() ? "" : "; ",
+            column(0),
+            column(1),
+            column(2),
+            column(3),
+            row.isNull(columns[4]) ? "" : " extra=",
+            row.isNull(columns[4]) ? "" : row.text(columns[4])
+        );
+        fullScan = fullScan || column(1) == "ALL";
+    }
+    mysql_free_result(result);
+
+    {
+        std::lock_guard lock(mMutex);
+        if (auto it = mShapes.find(entry.shape); it != mShapes.end()) {
+            it->second.explain  = summary;
+            it->second.fullScan = fullScan;
+        }
+    }
+
+    write(std::format("{} | EXPLAIN | {} | {}", formatTime(entry.time), summary, entry.shape));
+    if (fullScan) {
+        BDS_LOG_WARN("\033[33m[慢查询] 语句未使用索引（全表扫描）: {} ({})\033[0m", entry.shape, summary);
+    }
+}
+
+SlowQueryProbe::~SlowQueryProbe() {
+    auto  elapsed   = SlowQueryLog::Clock::now() - mStart;
+    auto& log       = SlowQueryLog::getInstance();
+    bool  slow      = log.isSlow(elapsed);
+    bool  recording = QueryRecorder::recording();
+    if (!slow && !recording) {
+        return;
+    }
+
+    uint64_t rows = 0;
+    if (mStmt) {
+        rows = mysql_stmt_affected_rows(mStmt);
+    } else if (mConn) {
+        rows = mysql_affected_rows(mConn);
+    }
+    bool failed = rows == static_cast<uint64_t>(-1);
+    if (failed) {
+        rows = 0;  // 语句失败
+    }
+
+    unsigned long paramCount = mStmt && mBinds ? mysql_stmt_param_count(mStmt) : 0;
+    if (recording) {
+        auto& recorder = QueryRecorder::getInstance();
+        if (mStmt) {
+            recorder.recordStatement(mConn, mSql, mBinds, paramCount, mStart, elapsed, rows, failed);
+        } else {
+            recorder.recordText(mConn, mSql, mStart, elapsed, rows, failed);
+        }
+    }
+    if (!slow) {
+        return;
+    }
+
+    std::vector<uint32_t> bindSizes;
+    for (unsigned long i = 0; i < paramCount; i++) {
+        bindSizes.push_back(bindSize(mBinds[i]));
+    }
+    log.record(mSql, std::move(bindSizes), rows, elapsed);
+}
+
+} // namespace bdsmysql
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <mysql.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace bdsmysql {
+
+// 同一形态（字面量替换为 ?）的慢查询汇总
+struct SlowQueryShape {
+    std::string shape;
+    uint64_t    count   = 0;
+    uint64_t    totalUs = 0;
+    uint64_t    maxUs   = 0;
+    uint64_t    maxRows = 0;
+    std::string explain;           // EXPLAIN 摘要，未执行或不适用时为空
+    bool        fullScan = false;  // EXPLAIN 显示全表扫描
+};
+
+// 语句中的字面量（按出现顺序）
+struct SqlLiteral {
+    bool             quoted = false;  // 字符串字面量：text 为引号内的原文（未反转义）；否则为数字
+    std::string_view text;
+};
+
+// 慢查询日志：Database 中耗时超过阈值的语句记录形态、参数长度、影响行数和耗时，
+// 写入插件目录下按大小轮转的日志文件；新出现的 SELECT/UPDATE/DELETE 形态在后台线程执行一次 EXPLAIN。
+// 记录只在超过阈值时发生，未超过阈值的语句只多两次读时钟
+class SlowQueryLog {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static SlowQueryLog& getInstance();
+
+    void start();  // 读取配置，启动写日志和 EXPLAIN 的后台线程
+    void stop();   // 写完已记录的条目后停止（须在断开数据库之前调用）
+
+    bool isSlow(Clock::duration elapsed) const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()
+            >= mThresholdUs.load(std::memory_order_relaxed);
+    }
+
+    // 记录一条慢查询。sql 为实际执行的文本（预处理语句为带 ? 的原文），bindSizes 为各参数的字节数
+    void record(std::string_view sql, std::vector<uint32_t> bindSizes, uint64_t rows, Clock::duration elapsed);
+
+    // 按累计耗时从高到低排列
+    std::vector<SlowQueryShape> summary() const;
+
+    // 语句形态：字符串和数字字面量替换为 ?，连续空白合并；literalSizes 非空时写入各字符串字面量的长度。
+    // literals 非空时写入所有字面量（指向 sql），形态不截断，可以原样还原语句
+    static std::string shapeOf(
+        std::string_view         sql,
+        std::vector<uint32_t>*   literalSizes,
+        std::vector<SqlLiteral>* literals = nullptr
+    );
+
+private:
+    struct Entry {
+        std::chrono::system_clock::time_point time;
+        std::string                           shape;
+        std::string                           explainSql;  // 需要执行 EXPLAIN 时为原始语句
+        std::vector<uint32_t>                 bindSizes;
+        uint64_t                              rows = 0;
+        uint64_t                              us   = 0;
+    };
+
+    static constexpr size_t kMaxPending = 1024;  // 后台线程来不及写入时丢弃新条目
+    static constexpr size_t kMaxShapes  = 256;
+
+    SlowQueryLog()  = default;
+    ~SlowQueryLog() = default;
+
+    SlowQueryLog(const SlowQueryLog&)            = delete;
+    SlowQueryLog& operator=(const SlowQueryLog&) = delete;
+
+    void run();
+    void write(const std::string& line);
+    void rotate();
+    void explain(const Entry& entry);
+
+    std::atomic<int64_t> mThresholdUs{INT64_MAX};  // 启动前不记录
+
+    mutable std::mutex                              mMutex;  // 保护形态表和待写入队列
+    std::unordered_map<std::string, SlowQueryShape> mShapes;
+    std::deque<Entry>                               mPending;
+    uint64_t                                        mDropped = 0;
+
+    std::thread             mThread;
+    std::condition_variable mCv;
+    bool                    mRunning = false;
+    bool                    mExplain = true;
+    std::string             mPath;
+    uintmax_t               mMaxFileBytes = 0;
+    int                     mMaxFiles     = 0;
+};
+
+// 作用域计时：覆盖一条语句的执行和结果读取，析构时超过阈值则记入慢查询日志，录制开启时同时交给 QueryRecorder。
+// sql 必须在探针析构之前保持有效；影响行数在析构时从连接（或语句）读取
+class SlowQueryProbe {
+public:
+    SlowQueryProbe(MYSQL* conn, std::string_view sql) : mConn(conn), mSql(sql), mStart(SlowQueryLog::Clock::now()) {}
+    SlowQueryProbe(MYSQL* conn, MYSQL_STMT* stmt, std::string_view sql, const MYSQL_BIND* binds)
+    : mConn(conn),
+      mStmt(stmt),
+      mBinds(binds),
+      mSql(sql),
+      mStart(SlowQueryLog::Clock::now()) {}
+    ~SlowQueryProbe();
+
+    SlowQueryProbe(const SlowQueryProbe&)            = delete;
+    SlowQueryProbe& operator=(const SlowQueryProbe&) = delete;
+
+private:
+    MYSQL*                          mConn  = nullptr;
+    MYSQL_STMT*                     mStmt  = nullptr;
+    const MYSQL_BIND*               mBinds = nullptr;
+    std::string_view                mSql;
+    SlowQueryLog::Clock::time_point mStart;
+};
+
+} // namespace bdsmysql
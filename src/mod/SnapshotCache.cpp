@@ -0,0 +1,90 @@
+#include "mod/SnapshotCache.h"
+#include "mod/Config.h"
+
+namespace bdsmysql {
+
+namespace {
+
+SnapshotCache::Clock::duration cacheTtl() {
+    return std::chrono::seconds(Config::getInstance().getDatabaseConfig().peer.cacheTtlSeconds);
+}
+
+} // namespace
+
+SnapshotCache& SnapshotCache::getInstance() {
+    static SnapshotCache instance;
+    return instance;
+}
+
+void SnapshotCache::put(PlayerSnapshot snapshot) {
+    auto now = Clock::now();
+
+    std::lock_guard lock(mMutex);
+    pruneExpired(now);
+
+    auto& entry = mEntries[snapshot.syncData.uuid];
+    // 乱序到达时保留版本更新的快照
+    if (entry.snapshot.version > snapshot.version) {
+        return;
+    }
+    entry.snapshot   = std::move(snapshot);
+    entry.receivedAt = now;
+    entry.validated  = false;
+}
+
+bool SnapshotCache::take(const std::string& uuid, PlayerSnapshot& snapshot, bool& validated) {
+    std::lock_guard lock(mMutex);
+
+    auto it = mEntries.find(uuid);
+    if (it == mEntries.end()) {
+        return false;
+    }
+
+    bool fresh = Clock::now() - it->second.receivedAt <= cacheTtl();
+    if (fresh) {
+        snapshot  = std::move(it->second.snapshot);
+        validated = it->second.validated;
+    }
+    mEntries.erase(it);
+    return fresh;
+}
+
+void SnapshotCache::invalidate(const std::string& uuid) {
+    std::lock_guard lock(mMutex);
+    mEntries.erase(uuid);
+}
+
+void SnapshotCache::invalidateBefore(const std::string& uuid, uint64_t seq) {
+    std::lock_guard lock(mMutex);
+
+    auto it = mEntries.find(uuid);
+    if (it != mEntries.end() && it->second.snapshot.changeSeq < seq) {
+        mEntries.erase(it);
+    }
+}
+
+void SnapshotCache::markValidated(Clock::time_point pollStart) {
+    std::lock_guard lock(mMutex);
+    for (auto& [uuid, entry] : mEntries) {
+        if (entry.receivedAt < pollStart) {
+            entry.validated = true;
+        }
+    }
+}
+
+void SnapshotCache::clear() {
+    std::lock_guard lock(mMutex);
+    mEntries.clear();
+}
+
+size_t SnapshotCache::size() const {
+    std::lock_guard lock(mMutex);
+    return mEntries.size();
+}
+
+void SnapshotCache::pruneExpired(Clock::time_point now) {
+    auto ttl = cacheTtl();
+    std::erase_if(mEntries, [&](const auto& item) { return now - item.second.receivedAt > ttl; });
+}
+
+} // namespace bdsmysql
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "mod/Database.h"
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace bdsmysql {
+
+// 本服务器收到的玩家快照缓存（由其它服务器在传送前推送）
+// 加入时命中且版本与数据库一致则直接使用，否则回退到 MySQL
+class SnapshotCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static SnapshotCache& getInstance();
+
+    void put(PlayerSnapshot snapshot);
+
+    // 取出并移除缓存项（已过期的视为未命中）
+    // validated 表示接收之后已有一次变更日志轮询确认没有更新的写入，可跳过版本校验
+    bool take(const std::string& uuid, PlayerSnapshot& snapshot, bool& validated);
+
+    void invalidate(const std::string& uuid);
+
+    // 变更日志中出现该玩家更新的写入（序号大于快照提交序号）时失效
+    void invalidateBefore(const std::string& uuid, uint64_t seq);
+
+    // 一次从 pollStart 开始的变更日志轮询已完成：之前收到的缓存项均已确认
+    void markValidated(Clock::time_point pollStart);
+    void clear();
+    size_t size() const;
+
+private:
+    struct Entry {
+        PlayerSnapshot    snapshot;
+        Clock::time_point receivedAt;
+        bool              validated = false;
+    };
+
+    SnapshotCache()  = default;
+    ~SnapshotCache() = default;
+
+    SnapshotCache(const SnapshotCache&)            = delete;
+    SnapshotCache& operator=(const SnapshotCache&) = delete;
+
+    void pruneExpired(Clock::time_point now);
+
+    mutable std::mutex                     mMutex;
+    std::unordered_map<std::string, Entry> mEntries;
+};
+
+} // namespace bdsmysql
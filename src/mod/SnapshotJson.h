@@ -0,0 +1,70 @@
+#pragma once
+
+#include "mod/Database.h"
+#include <nlohmann/json.hpp>
+
+namespace bdsmysql {
+
+// 快照的 JSON 表示（服务器间推送、本地保存日志共用）
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(
+    PlayerSyncData,
+    uuid,
+    serverName,
+    health,
+    maxHealth,
+    food,
+    foodSaturation,
+    expLevel,
+    expPoints,
+    gamemode
+)
+
+// 物品列表：每个槽位一个对象 {slot, itemType, count, damage, nbt}
+inline void to_json(nlohmann::json& j, const ItemList& items) {
+    j = nlohmann::json::array();
+    for (const auto& record : items) {
+        j.push_back({
+            {"slot",     record.slot      },
+            {"itemType", record.itemType()},
+            {"count",    record.count     },
+            {"damage",   record.damage    },
+            {"nbt",      items.nbt(record)},
+        });
+    }
+}
+
+inline void appendItems(const nlohmann::json& j, ItemList& items) {
+    items.reserve(j.size(), 0);
+    for (const auto& item : j) {
+        items.add(
+            item.at("slot").get<int>(),
+            item.at("itemType").get_ref<const std::string&>(),
+            item.at("count").get<int>(),
+            item.at("damage").get<int>(),
+            item.at("nbt").get_ref<const std::string&>()
+        );
+    }
+}
+
+inline void to_json(nlohmann::json& j, const PlayerSnapshot& snapshot) {
+    j["version"]   = snapshot.version;
+    j["changeSeq"] = snapshot.changeSeq;
+    j["sync"]      = snapshot.syncData;
+    j["items"]     = snapshot.items;
+}
+
+inline void from_json(const nlohmann::json& j, PlayerSnapshot& snapshot) {
+    snapshot.version   = j.value("version", uint64_t{0});
+    snapshot.changeSeq = j.value("changeSeq", uint64_t{0});
+    snapshot.syncData  = j.at("sync").get<PlayerSyncData>();
+    snapshot.items.clear();
+    if (j.contains("items")) {
+        appendItems(j.at("items"), snapshot.items);
+    } else {
+        // 旧版本写入的本地日志：背包和装备分开保存
+        appendItems(j.at("backpack"), snapshot.items);
+        appendItems(j.at("equipment"), snapshot.items);
+    }
+}
+
+} // namespace bdsmysql
@@ -0,0 +1,313 @@
+#pragma once
+
+#include "mod/RowView.h"
+#include <mysql.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+// 编译期表描述：一份列声明同时生成建表语句、投影 SELECT、upsert 语句和预处理语句参数绑定。
+//
+//   inline constexpr auto kFooTable = schema::table<Foo>("foo", "INDEX `idx_uuid` (`uuid`)",
+//       schema::column("id", "INT AUTO_INCREMENT PRIMARY KEY"),
+//       schema::field("uuid", "VARCHAR(36) NOT NULL UNIQUE", &Foo::uuid, schema::Select | schema::Write | schema::Key),
+//       ...);
+//
+//   schema::kCreateSql<kFooTable>.c_str()   // CREATE TABLE IF NOT EXISTS ...
+//   schema::kSelectSql<kFooTable>.view()    // SELECT `uuid`, ... FROM `foo`
+//   schema::decodeRow<kFooTable>(row, foo); // 按投影顺序解码
+//   schema::RowBinder<kFooTable> binder;    // 绑定 kUpsertSql 的参数
+namespace bdsmysql::schema {
+
+enum ColumnFlags : unsigned {
+    None        = 0,
+    Key         = 1u << 0,  // 唯一键的一部分：upsert 冲突时不更新
+    Select      = 1u << 1,  // 出现在投影 SELECT 中，按声明顺序解码到成员
+    Write       = 1u << 2,  // 由成员写入（upsert 参数）
+    Owner       = 1u << 3,  // 不对应成员，写入时由调用方提供（如物品表的 uuid）
+    NullIfEmpty = 1u << 4,  // 空字符串写为 NULL
+};
+
+struct ColumnInfo {
+    std::string_view name;
+    std::string_view definition;
+    unsigned         flags = None;
+
+    constexpr bool has(unsigned flag) const { return (flags & flag) != 0; }
+};
+
+// 对应结构体成员的列
+template <class S, class M>
+struct Field : ColumnInfo {
+    M S::*member;
+};
+
+// 只出现在建表语句（和 Owner 参数）中的列
+struct Column : ColumnInfo {};
+
+template <class S, class... Columns>
+struct Table {
+    using Struct = S;
+
+    std::string_view       name;
+    std::string_view       constraints;  // 索引、CHECK 等，追加在列定义之后
+    std::tuple<Columns...> columns;
+
+    template <class F>
+    constexpr void forEach(F&& f) const {
+        std::apply([&](const auto&... column) { (f(column), ...); }, columns);
+    }
+
+    constexpr size_t count(unsigned flag) const {
+        size_t n = 0;
+        forEach([&](const ColumnInfo& column) { n += column.has(flag) ? 1 : 0; });
+        return n;
+    }
+};
+
+template <class S, class M>
+constexpr Field<S, M> field(std::string_view name, std::string_view definition, M S::*member, unsigned flags = Select | Write) {
+    return {{name, definition, flags}, member};
+}
+
+constexpr Column column(std::string_view name, std::string_view definition, unsigned flags = None) {
+    return {{name, definition, flags}};
+}
+
+template <class S, class... Columns>
+constexpr Table<S, Columns...> table(std::string_view name, std::string_view constraints, Columns... columns) {
+    return {name, constraints, {columns...}};
+}
+
+// ---------------------------------------------------------------------------
+// SQL 生成：先计算长度，再写入定长数组，结果是编译期常量
+
+struct SqlWriter {
+    char*  out  = nullptr;  // 为空时只计算长度
+    size_t size = 0;
+
+    constexpr SqlWriter& operator<<(std::string_view text) {
+        for (char c : text) {
+            if (out) {
+                out[size] = c;
+            }
+            size++;
+        }
+        return *this;
+    }
+};
+
+template <size_t N>
+struct SqlText {
+    std::array<char, N + 1> data{};
+
+    constexpr const char*      c_str() const { return data.data(); }
+    constexpr std::string_view view() const { return {data.data(), N}; }
+};
+
+template <const auto& T, class Emitter>
+constexpr auto buildSql() {
+    constexpr size_t size = [] {
+        SqlWriter counter;
+        Emitter::emit(counter, T);
+        return counter.size;
+    }();
+    SqlText<size> text;
+    SqlWriter     writer{text.data.data()};
+    Emitter::emit(writer, T);
+    return text;
+}
+
+inline constexpr SqlWriter& quoted(SqlWriter& out, std::string_view name) { return out << "`" << name << "`"; }
+
+// 列名列表，只包含带有 flag 的列
+template <unsigned Flag>
+struct ColumnListSql {
+    template <class T>
+    static constexpr void emit(SqlWriter& out, const T& table) {
+        bool first = true;
+        table.forEach([&](const ColumnInfo& column) {
+            if (column.has(Flag)) {
+                out << (first ? "" : ", ");
+                quoted(out, column.name);
+                first = false;
+            }
+        });
+    }
+};
+
+struct CreateSql {
+    template <class T>
+    static constexpr void emit(SqlWriter& out, const T& table) {
+        out << "CREATE TABLE IF NOT EXISTS ";
+        quoted(out, table.name) << " (";
+        bool first = true;
+        table.forEach([&](const ColumnInfo& column) {
+            out << (first ? "" : ",") << "\n    ";
+            quoted(out, column.name) << " " << column.definition;
+            first = false;
+        });
+        if (!table.constraints.empty()) {
+            out << ",\n    " << table.constraints;
+        }
+        out << "\n) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci";
+    }
+};
+
+struct SelectSql {
+    template <class T>
+    static constexpr void emit(SqlWriter& out, const T& table) {
+        out << "SELECT ";
+        ColumnListSql<Select>::emit(out, table);
+        out << " FROM ";
+        quoted(out, table.name);
+    }
+};
+
+// INSERT ... ON DUPLICATE KEY UPDATE，参数顺序与列声明顺序一致（Owner 和 Write 列）
+struct UpsertSql {
+    template <class T>
+    static constexpr void emit(SqlWriter& out, const T& table) {
+        out << "INSERT INTO ";
+        quoted(out, table.name) << " (";
+        ColumnListSql<Owner | Write>::emit(out, table);
+        out << ") VALUES (";
+        for (size_t i = 0; i < table.count(Owner | Write); i++) {
+            out << (i ? ", ?" : "?");
+        }
+        out << ") ON DUPLICATE KEY UPDATE ";
+        bool first = true;
+        table.forEach([&](const ColumnInfo& column) {
+            if (column.has(Owner | Write) && !column.has(Key)) {
+                out << (first ? "" : ", ");
+                quoted(out, column.name) << " = VALUES(";
+                quoted(out, column.name) << ")";
+                first = false;
+            }
+        });
+    }
+};
+
+template <const auto& T>
+inline constexpr auto kCreateSql = buildSql<T, CreateSql>();
+template <const auto& T>
+inline constexpr auto kSelectColumns = buildSql<T, ColumnListSql<Select>>();
+template <const auto& T>
+inline constexpr auto kSelectSql = buildSql<T, SelectSql>();
+template <const auto& T>
+inline constexpr auto kUpsertSql = buildSql<T, UpsertSql>();
+
+template <const auto& T>
+using StructOf = typename std::remove_cvref_t<decltype(T)>::Struct;
+
+// 列在 kSelectSql 投影中的位置，不在投影中时编译失败
+template <const auto& T>
+consteval unsigned int selectIndex(std::string_view name) {
+    unsigned int index = 0;
+    unsigned int found = ~0u;
+    T.forEach([&](const ColumnInfo& column) {
+        if (column.has(Select)) {
+            if (column.name == name) {
+                found = index;
+            }
+            index++;
+        }
+    });
+    if (found == ~0u) {
+        throw "column is not selected";
+    }
+    return found;
+}
+
+// ---------------------------------------------------------------------------
+// 行解码：按 kSelectSql 的列顺序写入成员
+
+inline void assignColumn(const RowView& row, unsigned int i, int& value) { value = row.number<int>(i); }
+inline void assignColumn(const RowView& row, unsigned int i, float& value) { value = row.number<float>(i); }
+inline void assignColumn(const RowView& row, unsigned int i, uint64_t& value) { value = row.number<uint64_t>(i); }
+inline void assignColumn(const RowView& row, unsigned int i, bool& value) { value = row.number<int>(i) != 0; }
+inline void assignColumn(const RowView& row, unsigned int i, std::string& value) { value = row.text(i); }
+// 视图指向结果缓冲区，只在结果释放前有效
+inline void assignColumn(const RowView& row, unsigned int i, std::string_view& value) { value = row.text(i); }
+
+template <const auto& T>
+void decodeRow(const RowView& row, StructOf<T>& value) {
+    unsigned int index = 0;
+    T.forEach([&](const auto& column) {
+        if constexpr (requires { column.member; }) {
+            if (column.has(Select)) {
+                assignColumn(row, index++, value.*(column.member));
+            }
+        }
+    });
+}
+
+// ---------------------------------------------------------------------------
+// 预处理语句参数绑定：MYSQL_BIND 直接指向成员，不复制、不格式化
+
+template <const auto& T>
+class RowBinder {
+public:
+    static constexpr size_t kParamCount = T.count(Owner | Write);
+
+    // owners 依次对应 Owner 列；返回的数组在下次 bind 或 binder 析构前有效，value 需保持存活
+    MYSQL_BIND* bind(const StructOf<T>& value, std::initializer_list<std::string_view> owners = {}) {
+        mBinds      = {};
+        size_t index = 0;
+        auto   owner = owners.begin();
+        T.forEach([&](const auto& column) {
+            if (column.has(Owner)) {
+                bindText(index++, *owner++, column.has(NullIfEmpty));
+            } else if constexpr (requires { column.member; }) {
+                if (column.has(Write)) {
+                    bindValue(index++, value.*(column.member), column);
+                }
+            }
+        });
+        return mBinds.data();
+    }
+
+private:
+    void bindScalar(size_t index, const void* buffer, enum_field_types type, bool isUnsigned = false) {
+        mBinds[index].buffer      = const_cast<void*>(buffer);  // 输入参数只读
+        mBinds[index].buffer_type = type;
+        mBinds[index].is_unsigned = isUnsigned;
+    }
+
+    void bindText(size_t index, std::string_view text, bool nullIfEmpty) {
+        mLengths[index]             = static_cast<unsigned long>(text.size());
+        mNulls[index]               = nullIfEmpty && text.empty();
+        mBinds[index].buffer        = const_cast<char*>(text.data());
+        mBinds[index].buffer_type   = MYSQL_TYPE_STRING;
+        mBinds[index].buffer_length = mLengths[index];
+        mBinds[index].length        = &mLengths[index];
+        mBinds[index].is_null       = &mNulls[index];
+    }
+
+    void bindValue(size_t index, const int& value, const ColumnInfo&) { bindScalar(index, &value, MYSQL_TYPE_LONG); }
+    void bindValue(size_t index, const float& value, const ColumnInfo&) { bindScalar(index, &value, MYSQL_TYPE_FLOAT); }
+    void bindValue(size_t index, const uint64_t& value, const ColumnInfo&) {
+        bindScalar(index, &value, MYSQL_TYPE_LONGLONG, true);
+    }
+    void bindValue(size_t index, const bool& value, const ColumnInfo&) {
+        static_assert(sizeof(bool) == 1, "MYSQL_TYPE_TINY 需要单字节 bool");
+        bindScalar(index, &value, MYSQL_TYPE_TINY);
+    }
+    void bindValue(size_t index, const std::string& value, const ColumnInfo& column) {
+        bindText(index, value, column.has(NullIfEmpty));
+    }
+    void bindValue(size_t index, const std::string_view& value, const ColumnInfo& column) {
+        bindText(index, value, column.has(NullIfEmpty));
+    }
+
+    std::array<MYSQL_BIND, kParamCount>    mBinds{};
+    std::array<unsigned long, kParamCount> mLengths{};
+    std::array<bool, kParamCount>          mNulls{};
+};
+
+} // namespace bdsmysql::schema
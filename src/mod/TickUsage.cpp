@@ -0,0 +1,145 @@
+#include "mod/TickUsage.h"
+#include "ll/api/io/Logger.h"
+#include "ll/api/mod/NativeMod.h"
+#include "mod/Config.h"
+#include "mod/Log.h"
+#include "mod/Tracer.h"
+#include <algorithm>
+#include <format>
+#include <string>
+
+namespace bdsmysql {
+
+namespace {
+
+thread_local int tScopeDepth = 0;
+
+double toMs(TickUsage::Clock::duration elapsed) { return std::chrono::duration<double, std::milli>(elapsed).count(); }
+
+} // namespace
+
+TickUsage& TickUsage::getInstance() {
+    static TickUsage instance;
+    return instance;
+}
+
+StallSite TickUsage::site(const char* name) {
+    return {name, Metrics::getInstance().histogram(std::string("tick.") + name)};
+}
+
+void TickUsage::start() {
+    const auto& config = Config::getInstance().getDatabaseConfig().tickUsage;
+    mWindowSlots       = std::clamp<size_t>(
+        static_cast<size_t>(std::max(config.windowSeconds, 1)) * (std::chrono::seconds(1) / kSlotLength),
+        1,
+        kSlotCount - 1  // 当前槽位尚未结束，不计入
+    );
+    mSlowThreshold = std::chrono::microseconds(std::max(config.slowEventUs, 0));
+
+    Metrics::getInstance().gauge("tick.avgMsPerTick", [this] { return averageMsPerTick(); });
+    Metrics::getInstance().gauge("tick.maxMsPerTick", [this] { return maxMsPerTick(); });
+}
+
+int64_t TickUsage::slotOf(Clock::time_point time) { return time.time_since_epoch() / kSlotLength; }
+
+void TickUsage::add(Clock::time_point end, Clock::duration elapsed) {
+    int64_t slot  = slotOf(end);
+    size_t  index = static_cast<size_t>(slot) % kSlotCount;
+    auto    us    = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+    // 只有主线程写入：槽位过期时直接覆盖
+    if (mSlotIds[index].load(std::memory_order_relaxed) != slot) {
+        mSlotUs[index].store(us, std::memory_order_relaxed);
+        mSlotIds[index].store(slot, std::memory_order_release);
+    } else {
+        mSlotUs[index].store(mSlotUs[index].load(std::memory_order_relaxed) + us, std::memory_order_relaxed);
+    }
+}
+
+double TickUsage::averageMsPerTick() const {
+    int64_t  current = slotOf(Clock::now());
+    uint64_t total   = 0;
+    for (size_t i = 1; i <= mWindowSlots; i++) {
+        int64_t slot  = current - static_cast<int64_t>(i);
+        size_t  index = static_cast<size_t>(slot) % kSlotCount;
+        if (mSlotIds[index].load(std::memory_order_acquire) == slot) {
+            total += mSlotUs[index].load(std::memory_order_relaxed);
+        }
+    }
+    return static_cast<double>(total) / static_cast<double>(mWindowSlots) / 1000.0;
+}
+
+double TickUsage::maxMsPerTick() const {
+    int64_t  current = slotOf(Clock::now());
+    uint64_t peak    = 0;
+    for (size_t i = 1; i <= mWindowSlots; i++) {
+        int64_t slot  = current - static_cast<int64_t>(i);
+        size_t  index = static_cast<size_t>(slot) % kSlotCount;
+        if (mSlotIds[index].load(std::memory_order_acquire) == slot) {
+            peak = std::max(peak, mSlotUs[index].load(std::memory_order_relaxed));
+        }
+    }
+    return static_cast<double>(peak) / 1000.0;
+}
+
+StallScope::StallScope(const StallSite& site)
+: mSite(site),
+  mStart(TickUsage::Clock::now()),
+  mLast(mStart),
+  mOutermost(tScopeDepth++ == 0) {}
+
+void StallScope::stage(const char* label) {
+    auto now = TickUsage::Clock::now();
+
+    // 同名阶段累加（循环中的阶段），超出上限的计入最后一个
+    auto it = std::find_if(mStages.begin(), mStages.begin() + mStageCount, [&](const Stage& stage) {
+        return stage.label == label;
+    });
+    if (it != mStages.begin() + mStageCount) {
+        it->elapsed += now - mLast;
+    } else if (mStageCount < kMaxStages) {
+        mStages[mStageCount++] = {label, now - mLast};
+    } else {
+        mStages[kMaxStages - 1].elapsed += now - mLast;
+    }
+    mLast = now;
+}
+
+StallScope::~StallScope() {
+    tScopeDepth--;
+
+    auto  end     = TickUsage::Clock::now();
+    auto  elapsed = end - mStart;
+    auto& usage   = TickUsage::getInstance();
+
+    Metrics::getInstance().record(mSite.latency, elapsed);
+    if (Tracer::enabled()) {
+        Tracer::getInstance().complete(Metrics::getInstance().histogramName(mSite.latency), mStart, end);
+    }
+    if (mOutermost) {
+        usage.add(end, elapsed);
+    }
+
+    if (elapsed < usage.slowThreshold()) {
+        return;
+    }
+
+    std::string breakdown;
+    for (size_t i = 0; i < mStageCount; i++) {
+        breakdown += std::format("{}{} {:.2f}ms", i ? ", " : "", mStages[i].label, toMs(mStages[i].elapsed));
+    }
+    if (mStageCount > 0 && end > mLast) {
+        breakdown += std::format(", 其它 {:.2f}ms", toMs(end - mLast));
+    }
+
+    BDS_LOG_WARN(
+        "\033[33m[主线程] {} 占用主线程 {:.2f}ms{}{}{}\033[0m",
+        mSite.name,
+        toMs(elapsed),
+        breakdown.empty() ? "" : " (",
+        breakdown,
+        breakdown.empty() ? "" : ")"
+    );
+}
+
+} // namespace bdsmysql
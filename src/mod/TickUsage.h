@@ -0,0 +1,88 @@
+#pragma once
+
+#include "mod/Metrics.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace bdsmysql {
+
+// 一个占用主线程的入口（事件监听器、命令、每 tick 任务），耗时记入直方图 tick.<name>
+struct StallSite {
+    const char* name;
+    MetricId    latency;
+};
+
+// 主线程耗时归因：统计 BDSmysql 在主线程上占用的时间。
+// 最近 windowSeconds 秒按 50ms（一个 tick）分槽累计，导出为"每 tick 占用毫秒数"的滚动平均和最大值
+class TickUsage {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr auto   kSlotLength = std::chrono::milliseconds(50);
+    static constexpr size_t kSlotCount  = 1200;  // 60 秒
+
+    static TickUsage& getInstance();
+
+    // 注册入口，返回值通常保存在静态变量中
+    static StallSite site(const char* name);
+
+    void start();  // 读取配置并注册仪表
+
+    // 只在主线程调用
+    void add(Clock::time_point end, Clock::duration elapsed);
+
+    double averageMsPerTick() const;
+    double maxMsPerTick() const;
+
+    Clock::duration slowThreshold() const { return mSlowThreshold; }
+
+private:
+    TickUsage()  = default;
+    ~TickUsage() = default;
+
+    TickUsage(const TickUsage&)            = delete;
+    TickUsage& operator=(const TickUsage&) = delete;
+
+    static int64_t slotOf(Clock::time_point time);
+
+    // 主线程写入，其它线程（指标导出）只读
+    std::array<std::atomic<int64_t>, kSlotCount>  mSlotIds{};
+    std::array<std::atomic<uint64_t>, kSlotCount> mSlotUs{};
+
+    size_t          mWindowSlots   = 200;
+    Clock::duration mSlowThreshold = std::chrono::milliseconds(5);
+};
+
+// 作用域计时：记录入口在主线程上的耗时，超过阈值时输出各阶段的耗时分解。
+// 嵌套的作用域只记入自己的直方图，主线程占用只由最外层统计
+class StallScope {
+public:
+    explicit StallScope(const StallSite& site);
+    ~StallScope();
+
+    StallScope(const StallScope&)            = delete;
+    StallScope& operator=(const StallScope&) = delete;
+
+    // 结束当前阶段（从上一个标记到现在），同名阶段累加；label 必须是字符串常量
+    void stage(const char* label);
+
+private:
+    static constexpr size_t kMaxStages = 8;
+
+    struct Stage {
+        const char*                label;
+        TickUsage::Clock::duration elapsed;
+    };
+
+    const StallSite&              mSite;
+    TickUsage::Clock::time_point  mStart;
+    TickUsage::Clock::time_point  mLast;
+    std::array<Stage, kMaxStages> mStages{};
+    size_t                        mStageCount = 0;
+    bool                          mOutermost  = false;
+};
+
+} // namespace bdsmysql
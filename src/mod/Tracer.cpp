@@ -0,0 +1,223 @@
+#include "mod/Tracer.h"
+#include "ll/api/io/Logger.h"
+#include "ll/api/mod/NativeMod.h"
+#include "mod/Config.h"
+#include "mod/Log.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace bdsmysql {
+
+namespace {
+
+thread_local char    tKey[Tracer::kMaxKeyLength];
+thread_local uint8_t tKeyLength = 0;
+
+// 导出时读取的事件副本
+struct TraceRecord {
+    std::string_view name;
+    uint64_t         startNs = 0;
+    uint64_t         durNs   = 0;
+    uint32_t         tid     = 0;
+    std::string      key;
+};
+
+} // namespace
+
+std::atomic<bool> Tracer::sEnabled{false};
+
+Tracer& Tracer::getInstance() {
+    static Tracer instance;
+    return instance;
+}
+
+std::string_view Tracer::currentKey() { return {tKey, tKeyLength}; }
+
+uint32_t Tracer::threadId() {
+    static std::atomic<uint32_t> nextId{1};
+    thread_local uint32_t        id = nextId.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void Tracer::setThreadName(const char* name) {
+    auto&           tracer = getInstance();
+    std::lock_guard lock(tracer.mMutex);
+    tracer.mThreadNames[threadId()] = name;
+}
+
+void Tracer::start() {
+    if (Config::getInstance().getDatabaseConfig().trace.enabled) {
+        setEnabled(true);
+    }
+}
+
+void Tracer::setEnabled(bool enabled) {
+    if (enabled) {
+        std::lock_guard lock(mMutex);
+        if (!mEvents) {
+            mCapacity = static_cast<size_t>(std::max(Config::getInstance().getDatabaseConfig().trace.bufferEvents, 1024));
+            mEvents   = std::make_unique<Event[]>(mCapacity);
+            mBuffer.store(mEvents.get(), std::memory_order_release);
+        }
+    }
+    sEnabled.store(enabled, std::memory_order_release);
+}
+
+void Tracer::complete(std::string_view name, Clock::time_point start, Clock::time_point end) {
+    Event* buffer = mBuffer.load(std::memory_order_acquire);
+    if (!buffer || !enabled()) {
+        return;
+    }
+
+    uint64_t index = mNext.fetch_add(1, std::memory_order_relaxed);
+    Event&   event = buffer[index % mCapacity];
+
+    event.seq.store(index * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    event.name      = name;
+    event.startNs   = static_cast<uint64_t>(std::chrono::nanoseconds(start - mEpoch).count());
+    event.durNs     = static_cast<uint64_t>(std::chrono::nanoseconds(end - start).count());
+    event.tid       = threadId();
+    event.keyLength = tKeyLength;
+    std::memcpy(event.key, tKey, tKeyLength);
+
+    event.seq.store(index * 2 + 2, std::memory_order_release);
+}
+
+std::optional<std::string> Tracer::dump(std::string_view key) {
+    auto   mod    = ll::mod::NativeMod::current();
+    Event* buffer = mBuffer.load(std::memory_order_acquire);
+    if (!buffer) {
+        return std::nullopt;
+    }
+
+    // 1. 复制缓冲区中完整写入的事件（写入仍在进行，被覆盖中的槽位跳过）
+    std::vector<TraceRecord> records;
+    records.reserve(std::min<uint64_t>(mNext.load(std::memory_order_relaxed), mCapacity));
+    for (size_t i = 0; i < mCapacity; i++) {
+        Event&   event  = buffer[i];
+        uint64_t before = event.seq.load(std::memory_order_acquire);
+        if (before == 0 || (before & 1) != 0) {
+            continue;
+        }
+
+        TraceRecord record;
+        record.name    = event.name;
+        record.startNs = event.startNs;
+        record.durNs   = event.durNs;
+        record.tid     = event.tid;
+        record.key.assign(event.key, std::min<size_t>(event.keyLength, kMaxKeyLength));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (event.seq.load(std::memory_order_relaxed) != before) {
+            continue;
+        }
+        if (!key.empty() && record.key != key) {
+            continue;
+        }
+        records.push_back(std::move(record));
+    }
+    std::sort(records.begin(), records.end(), [](const TraceRecord& a, const TraceRecord& b) {
+        return a.startNs < b.startNs;
+    });
+
+    // 2. 每个玩家一个进程（pid），同一玩家的操作显示在同一组时间线上；没有追踪键的事件归入 pid 0
+    nlohmann::json                  events = nlohmann::json::array();
+    std::map<std::string, int>      pids;
+    std::map<uint32_t, std::string> threadNames;
+    {
+        std::lock_guard lock(mMutex);
+        for (const auto& [tid, name] : mThreadNames) {
+            threadNames[tid] = name;
+        }
+    }
+
+    for (const auto& record : records) {
+        int pid = 0;
+        if (!record.key.empty()) {
+            pid = pids.try_emplace(record.key, static_cast<int>(pids.size()) + 1).first->second;
+        }
+
+        nlohmann::json event;
+        event["name"] = record.name;
+        event["cat"]  = "bdsmysql";
+        event["ph"]   = "X";
+        event["ts"]   = static_cast<double>(record.startNs) / 1000.0;  // 微秒
+        event["dur"]  = static_cast<double>(record.durNs) / 1000.0;
+        event["pid"]  = pid;
+        event["tid"]  = record.tid;
+        events.push_back(std::move(event));
+    }
+
+    auto metadata = [&](const char* kind, int pid, std::optional<uint32_t> tid, std::string name) {
+        nlohmann::json event;
+        event["name"] = kind;
+        event["ph"]   = "M";
+        event["pid"]  = pid;
+        if (tid) {
+            event["tid"] = *tid;
+        }
+        event["args"]["name"] = std::move(name);
+        events.push_back(std::move(event));
+    };
+    metadata("process_name", 0, std::nullopt, "server");
+    for (const auto& [uuid, pid] : pids) {
+        metadata("process_name", pid, std::nullopt, "player " + uuid);
+    }
+    for (const auto& [tid, name] : threadNames) {
+        for (int pid = 0; pid <= static_cast<int>(pids.size()); pid++) {
+            metadata("thread_name", pid, tid, name);
+        }
+    }
+
+    // 3. 写入 traces/trace-YYYYmmdd-HHMMSS.json
+    try {
+        auto now  = std::time(nullptr);
+        auto time = *std::localtime(&now);
+
+        std::ostringstream fileName;
+        fileName << "trace-" << std::put_time(&time, "%Y%m%d-%H%M%S") << ".json";
+
+        auto directory = mod->getModDir() / "traces";
+        std::filesystem::create_directories(directory);
+        auto path = directory / fileName.str();
+
+        nlohmann::json trace;
+        trace["traceEvents"]     = std::move(events);
+        trace["displayTimeUnit"] = "ms";
+
+        std::ofstream file(path);
+        file << trace.dump();
+        if (!file) {
+            return std::nullopt;
+        }
+
+        BDS_LOG_INFO("\033[32m[追踪] 已导出 {} 个事件到 {}\033[0m", records.size(), path.string());
+        return path.string();
+    } catch (const std::exception& e) {
+        BDS_LOG_ERROR("\033[31m[追踪] 导出追踪文件失败: {}\033[0m", e.what());
+        return std::nullopt;
+    }
+}
+
+TraceKey::TraceKey(std::string_view key) : mSavedLength(tKeyLength) {
+    std::memcpy(mSaved, tKey, tKeyLength);
+    tKeyLength = static_cast<uint8_t>(std::min(key.size(), Tracer::kMaxKeyLength));
+    std::memcpy(tKey, key.data(), tKeyLength);
+}
+
+TraceKey::~TraceKey() {
+    tKeyLength = mSavedLength;
+    std::memcpy(tKey, mSaved, mSavedLength);
+}
+
+} // namespace bdsmysql
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace bdsmysql {
+
+// 操作追踪：记录每次数据库调用、序列化、应用和发包的时间段，按玩家 UUID 归类，
+// 写入固定大小的环形缓冲区，按需导出为 Chrome trace / Perfetto 可打开的 JSON。
+// 关闭时每个埋点只有一次 relaxed 原子读；缓冲区在第一次开启时分配
+class Tracer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kMaxKeyLength = 36;  // UUID 字符串长度
+
+    static Tracer& getInstance();
+
+    static bool enabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+    // 当前线程的追踪键（玩家 UUID），由 TraceKey 设置
+    static std::string_view currentKey();
+
+    // 为当前线程命名（导出时显示为线程名），name 必须是字符串常量
+    static void setThreadName(const char* name);
+
+    void start();  // 读取配置，trace.enabled 为 true 时开启
+    void setEnabled(bool enabled);
+
+    // 记录一个已完成的时间段；name 必须在进程生命周期内有效（字符串常量或指标名称）
+    void complete(std::string_view name, Clock::time_point start, Clock::time_point end);
+
+    // 把缓冲区中的事件写入插件目录下 traces/ 中的 JSON 文件，key 非空时只导出该玩家的事件。
+    // 返回文件路径，写入失败时返回空
+    std::optional<std::string> dump(std::string_view key);
+
+private:
+    // 槽位用序号做版本：写入中为奇数，写完为偶数。导出时前后序号不一致的槽位被跳过
+    struct Event {
+        std::atomic<uint64_t> seq{0};
+        std::string_view      name;
+        uint64_t              startNs   = 0;
+        uint64_t              durNs     = 0;
+        uint32_t              tid       = 0;
+        uint8_t               keyLength = 0;
+        char                  key[kMaxKeyLength]{};
+    };
+
+    Tracer()  = default;
+    ~Tracer() = default;
+
+    Tracer(const Tracer&)            = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    static uint32_t threadId();
+
+    static std::atomic<bool> sEnabled;
+
+    std::mutex                                mMutex;  // 保护缓冲区分配和线程名
+    std::unique_ptr<Event[]>                  mEvents;
+    std::atomic<Event*>                       mBuffer{nullptr};
+    size_t                                    mCapacity = 0;
+    std::atomic<uint64_t>                     mNext{0};
+    Clock::time_point                         mEpoch = Clock::now();
+    std::unordered_map<uint32_t, const char*> mThreadNames;
+};
+
+// 在作用域内设置当前线程的追踪键，作用域结束时恢复
+class TraceKey {
+public:
+    explicit TraceKey(std::string_view key);
+    ~TraceKey();
+
+    TraceKey(const TraceKey&)            = delete;
+    TraceKey& operator=(const TraceKey&) = delete;
+
+private:
+    char    mSaved[Tracer::kMaxKeyLength];
+    uint8_t mSavedLength;
+};
+
+// 作用域时间段（没有对应指标的埋点使用，如发包）
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name)
+    : mName(name),
+      mStart(Tracer::enabled() ? Tracer::Clock::now() : Tracer::Clock::time_point{}) {}
+    ~TraceSpan() {
+        if (mStart != Tracer::Clock::time_point{}) {
+            Tracer::getInstance().complete(mName, mStart, Tracer::Clock::now());
+        }
+    }
+
+    TraceSpan(const TraceSpan&)            = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char*               mName;
+    Tracer::Clock::time_point mStart;
+};
+
+} // namespace bdsmysql
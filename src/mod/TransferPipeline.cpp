@@ -0,0 +1,243 @@
+#include "mod/TransferPipeline.h"
+#include "ll/api/service/Bedrock.h"
+#include "ll/api/thread/ServerThreadExecutor.h"
+#include "mc/network/packet/TransferPacket.h"
+#include "mc/platform/UUID.h"
+#include "mc/world/level/Level.h"
+#include "mod/AllocStats.h"
+#include "mod/BdsPlayerState.h"
+#include "mod/Config.h"
+#include "mod/Database.h"
+#include "mod/JoinAdmission.h"
+#include "mod/Log.h"
+#include "mod/Metrics.h"
+#include "mod/MyMod.h"
+#include "mod/PeerChannel.h"
+#include "mod/SaveQueue.h"
+#include "mod/Tracer.h"
+
+namespace bdsmysql {
+
+namespace {
+
+double elapsedMs(TransferPipeline::Clock::time_point from, TransferPipeline::Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+Player* findOnlinePlayer(const std::string& uuid) {
+    auto level = ll::service::getLevel();
+    if (!level) {
+        return nullptr;
+    }
+    return level->getPlayer(mce::UUID::fromString(uuid));
+}
+
+} // namespace
+
+TransferPipeline& TransferPipeline::getInstance() {
+    static TransferPipeline instance;
+    return instance;
+}
+
+bool TransferPipeline::begin(Player& player, const ServerConfig& target) {
+    std::string uuid = player.getUuid().asString();
+    std::string name = player.getRealName();
+    TraceKey    traceKey(uuid);
+
+    if (mPending.contains(uuid)) {
+        player.sendMessage("§c正在传送中，请稍候");
+        return false;
+    }
+    if (JoinAdmission::getInstance().isLoading(uuid)) {
+        player.sendMessage("§c数据加载中，请稍后再传送");
+        return false;
+    }
+
+    // 阶段 1：在主线程采集快照（只读取内存，不访问数据库）
+    auto startTime = Clock::now();
+    auto snapshot  = [&] {
+        AllocScope allocScope(AllocStage::Capture);
+        return BdsPlayerState(player).capture();
+    }();
+    auto queuedAt  = Clock::now();
+
+    PendingTransfer pending;
+    pending.id        = mNextId++;
+    pending.uuid      = uuid;
+    pending.name      = name;
+    pending.target    = target;
+    pending.startTime = startTime;
+    pending.captureMs = elapsedMs(startTime, queuedAt);
+    uint64_t id       = pending.id;
+    mPending[uuid]    = std::move(pending);
+
+    player.sendMessage("§e正在保存数据并传送到 §b" + target.name + "§e，请稍候…");
+    BDS_LOG_INFO("\033[33m[传送] 玩家 {} ({}) 开始传送到服务器: {}\033[0m", name, uuid, target.name);
+
+    // 超时保护：提交未在限定时间内确认则放弃传送，玩家留在当前服务器
+    auto timeout = std::chrono::milliseconds(std::max(Config::getInstance().getDatabaseConfig().transferTimeoutMs, 100));
+    ll::thread::ServerThreadExecutor::getDefault().executeAfter(
+        [uuid, id] { TransferPipeline::getInstance().onTimeout(uuid, id); },
+        timeout
+    );
+
+    run(uuid, id, target, std::move(snapshot), queuedAt);
+    return true;
+}
+
+GameTask TransferPipeline::run(
+    std::string       uuid,
+    uint64_t          id,
+    ServerConfig      target,
+    PlayerSnapshot    snapshot,
+    Clock::time_point queuedAt
+) {
+    // 阶段 2：经保存队列在后台线程以事务提交快照，成功后推送给目标服务器，完成后回到主线程
+    // 与该玩家排队中的其它保存合并，提交的总是最新的快照
+    using Done  = DbCallbackAwaitable<CommitResult>::Done;
+    auto result = co_await DbCallbackAwaitable<CommitResult>(
+        "",
+        JobPriority::Transfer,
+        [snapshot = std::move(snapshot), target](Done done) mutable {
+            SaveQueue::getInstance().enqueue(
+                std::move(snapshot),
+                SaveReason::Transfer,
+                [target, done = std::move(done)](const SaveResult& saved) {
+                    CommitResult result;
+                    result.success     = saved.success;
+                    result.commitStart = saved.startTime;
+                    result.commitEnd   = saved.endTime;
+                    if (saved.success) {
+                        // 推送失败不影响传送，目标服务器会回退到 MySQL 读取
+                        result.items  = saved.snapshot.items;
+                        result.pushed = PeerChannel::getInstance().pushSnapshot(target, saved.snapshot);
+                    }
+                    result.pushEnd = Clock::now();
+                    done(std::move(result));
+                }
+            );
+        }
+    );
+
+    TraceKey traceKey(uuid);
+
+    auto it = mPending.find(uuid);
+    if (it == mPending.end() || it->second.id != id) {
+        // 已超时或已取消：数据已落库，但不再发送传送数据包
+        BDS_LOG_WARN("\033[33m[传送] 玩家 {} 的快照提交在传送结束后才完成 (成功: {})\033[0m", uuid, result.success);
+        co_return;
+    }
+
+    PendingTransfer pending = std::move(it->second);
+    mPending.erase(it);
+
+    Player* player = findOnlinePlayer(uuid);
+    if (!player) {
+        BDS_LOG_WARN("\033[33m[传送] 玩家 {} 在传送完成前已离线\033[0m", pending.name);
+        co_return;
+    }
+
+    if (!result.success) {
+        static const auto kFailed = Metrics::getInstance().counter("transfer.failed");
+        Metrics::getInstance().add(kFailed);
+        BDS_LOG_ERROR("\033[31m[传送] 保存玩家 {} 的数据失败，已取消传送\033[0m", pending.name);
+        player->sendMessage("§c传送失败：保存数据时出错");
+        co_return;
+    }
+
+    // 冻结期间没有事件的变化（如丢弃物品、容器交互）无法拦截：背包与已提交的快照不一致时放弃传送，
+    // 玩家留在本服务器，离线时照常保存当前背包
+    {
+        AllocScope allocScope(AllocStage::Capture);
+        TraceSpan  span("transfer.verify");
+        if (!BdsPlayerState(*player).capture().items.sameSlots(result.items)) {
+            static const auto kChanged = Metrics::getInstance().counter("transfer.inventoryChanged");
+            Metrics::getInstance().add(kChanged);
+            BDS_LOG_WARN("\033[33m[传送] 玩家 {} 的背包在提交后发生变化，已取消传送\033[0m", pending.name);
+            player->sendMessage("§c传送失败：传送过程中背包发生了变化，请重试");
+            co_return;
+        }
+    }
+
+    // 阶段 3：提交已确认，发送传送数据包
+    try {
+        TraceSpan      span("transfer.sendPacket");
+        TransferPacket packet(pending.target.address, pending.target.port);
+        player->sendNetworkPacket(packet);
+    } catch (const std::exception& e) {
+        BDS_LOG_ERROR("\033[31m[传送] 发送传送数据包失败: {}\033[0m", e.what());
+        player->sendMessage("§c传送失败：" + std::string(e.what()));
+        co_return;
+    }
+    mHandedOff.insert(uuid);
+
+    auto            sentAt = Clock::now();
+    TransferTimings timings;
+    timings.captureMs  = pending.captureMs;
+    timings.queueMs    = elapsedMs(queuedAt, result.commitStart);
+    timings.commitMs   = elapsedMs(result.commitStart, result.commitEnd);
+    timings.pushMs     = elapsedMs(result.commitEnd, result.pushEnd);
+    timings.dispatchMs = elapsedMs(result.pushEnd, sentAt);
+    timings.totalMs    = elapsedMs(pending.startTime, sentAt);
+
+    // 各阶段耗时记入指标，/bdsmysql stats 查看分位数
+    auto&             metrics   = Metrics::getInstance();
+    static const auto kCapture  = metrics.histogram("transfer.capture");
+    static const auto kQueue    = metrics.histogram("transfer.queue");
+    static const auto kCommit   = metrics.histogram("transfer.commit");
+    static const auto kPush     = metrics.histogram("transfer.push");
+    static const auto kDispatch = metrics.histogram("transfer.dispatch");
+    static const auto kTotal    = metrics.histogram("transfer.total");
+    metrics.record(kCapture, queuedAt - pending.startTime);
+    metrics.record(kQueue, result.commitStart - queuedAt);
+    metrics.record(kCommit, result.commitEnd - result.commitStart);
+    metrics.record(kPush, result.pushEnd - result.commitEnd);
+    metrics.record(kDispatch, sentAt - result.pushEnd);
+    metrics.record(kTotal, sentAt - pending.startTime);
+
+    BDS_LOG_INFO(
+        "\033[32m[传送] 玩家 {} 已传送到 {} (采集: {:.2f}ms, 排队: {:.2f}ms, 提交: {:.2f}ms, 推送: {:.2f}ms{}, 发送: {:.2f}ms, 总计: {:.2f}ms)\033[0m",
+        pending.name,
+        pending.target.name,
+        timings.captureMs,
+        timings.queueMs,
+        timings.commitMs,
+        timings.pushMs,
+        result.pushed ? "" : " (未推送)",
+        timings.dispatchMs,
+        timings.totalMs
+    );
+
+    player->sendMessage(
+        "§a正在传送到服务器：§b" + pending.target.name + "§r §7(" + pending.target.address + ":"
+        + std::to_string(pending.target.port) + ")"
+    );
+}
+
+void TransferPipeline::onTimeout(const std::string& uuid, uint64_t id) {
+    auto it = mPending.find(uuid);
+    if (it == mPending.end() || it->second.id != id) {
+        return;  // 已完成
+    }
+
+    std::string name = it->second.name;
+    mPending.erase(it);
+
+    static const auto kTimeout = Metrics::getInstance().counter("transfer.timeout");
+    Metrics::getInstance().add(kTimeout);
+
+    BDS_LOG_ERROR("\033[31m[传送] 玩家 {} 的数据提交超时，已取消传送\033[0m", name);
+
+    if (Player* player = findOnlinePlayer(uuid)) {
+        player->sendMessage("§c传送失败：保存数据超时，请稍后重试");
+    }
+}
+
+void TransferPipeline::cancel(const std::string& uuid) { mPending.erase(uuid); }
+
+void TransferPipeline::cancelAll() {
+    mPending.clear();
+    mHandedOff.clear();
+}
+
+} // namespace bdsmysql
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "mc/world/actor/player/Player.h"
+#include "mod/DatabaseAsync.h"
+#include "mod/ItemRecord.h"
+#include "mod/ServerConfig.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace bdsmysql {
+
+// 传送各阶段耗时（毫秒）
+struct TransferTimings {
+    double captureMs  = 0;  // 主线程采集快照
+    double queueMs    = 0;  // 等待后台线程
+    double commitMs   = 0;  // 数据库事务提交
+    double pushMs     = 0;  // 推送快照到目标服务器
+    double dispatchMs = 0;  // 提交完成到发送传送数据包
+    double totalMs    = 0;
+};
+
+// 跨服传送流水线（一个协程）：
+// 采集快照（主线程） -> co_await 经保存队列提交并推送（后台线程） -> 提交确认后发送 TransferPacket（主线程）
+class TransferPipeline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static TransferPipeline& getInstance();
+
+    /// @return False if the player already has a transfer in flight.
+    bool begin(Player& player, const ServerConfig& target);
+
+    bool isTransferring(const std::string& uuid) const { return mPending.contains(uuid); }
+
+    // 从采集快照到离线期间玩家处于冻结状态：此时背包的变化不会被保存（离线保存会被跳过）
+    bool isFrozen(const std::string& uuid) const { return mPending.contains(uuid) || mHandedOff.contains(uuid); }
+
+    // 玩家在传送完成前离线：放弃传送（已投递的提交仍会完成）
+    void cancel(const std::string& uuid);
+    void cancelAll();
+
+    // 玩家已发送传送数据包：离线时快照已提交，无需再次保存
+    bool consumeHandedOff(const std::string& uuid) { return mHandedOff.erase(uuid) > 0; }
+
+private:
+    struct PendingTransfer {
+        uint64_t          id = 0;  // 超时任务和提交回调通过 id 判断是否仍是同一次传送
+        std::string       uuid;
+        std::string       name;
+        ServerConfig      target;
+        Clock::time_point startTime;
+        double            captureMs = 0;
+    };
+
+    // 后台提交和推送的结果
+    struct CommitResult {
+        bool              success = false;
+        bool              pushed  = false;
+        ItemList          items;  // 实际提交的背包，发送前与玩家当前背包比较
+        Clock::time_point commitStart;
+        Clock::time_point commitEnd;
+        Clock::time_point pushEnd;
+    };
+
+    TransferPipeline()  = default;
+    ~TransferPipeline() = default;
+
+    TransferPipeline(const TransferPipeline&)            = delete;
+    TransferPipeline& operator=(const TransferPipeline&) = delete;
+
+    GameTask run(std::string uuid, uint64_t id, ServerConfig target, PlayerSnapshot snapshot, Clock::time_point queuedAt);
+    void onTimeout(const std::string& uuid, uint64_t id);
+
+    // 以下成员只在主线程访问
+    std::unordered_map<std::string, PendingTransfer> mPending;
+    std::unordered_set<std::string>                  mHandedOff;
+    uint64_t                                         mNextId = 1;
+};
+
+} // namespace bdsmysql
@@ -31,6 +31,7 @@ target("BDSmysql") -- Change this to your mod name.
     add_defines("NOMINMAX", "UNICODE")
     add_packages("levilamina")
     add_packages("mysql")
+    add_syslinks("ws2_32") -- PeerChannel sockets
     set_exceptions("none") -- To avoid conflicts with /EHa.
     set_kind("shared")
     set_languages("c++20")